@@ -63,11 +63,76 @@
 /// 
 /// 
 /// 
-/// query.groupby(keymap [, keyequal])
-/// ====================================
+/// query.groupby(keymap [, hash, keyequal])
+/// ==========================================
 /// Result: Query of groups. Each group has a 'key' field, and is a query of elements from the input.
 /// Powers: forward
 /// 
+/// The grouping is built when the first group is requested. Keys are indexed with an open addressing
+/// hash table (`std::hash` and `operator==` by default) and the elements of each group are stored 
+/// contiguously, so each group is a random access range. Pairs and tuples of hashable types are 
+/// hashed, and keys that `std::hash` does not support are ordered with `operator<` instead.
+/// The linq_groupby class template now takes Hash and KeyEqual where it took a Compare.
+/// 
+/// 
+/// 
+/// query.distinct([hash, keyequal] [, capacity])
+/// ==============================================
+/// -   Result: Query
+/// -   Powers: input
+/// 
+/// Yields the first occurrence of each distinct element, in order. Elements seen so far are kept
+/// in an open addressing hash table (`std::hash` and `operator==` by default); `capacity` reserves 
+/// room for that many distinct elements up front.
+/// 
+/// 
+/// 
+/// query.union_with(second [, hash, keyequal] [, capacity])
+/// query.intersect(second [, hash, keyequal] [, capacity])
+/// query.except(second [, hash, keyequal] [, capacity])
+/// =========================================================
+/// -   Result: Query
+/// -   Powers: input
+/// 
+/// Set operations, each yielding distinct elements in order. `union_with` yields the elements of the
+/// query followed by the elements of `second` that were not in the query. `intersect` and `except`
+/// yield the elements of the query that are (resp. are not) in `second`; `second` is read into the
+/// hash table when the cursor is created, and `capacity` is a hint for its size.
+/// 
+/// 
+/// 
+/// query.join(inner, outer_key, inner_key, result [, hash, keyequal])
+/// ====================================================================
+/// -   Result: Query
+/// -   Powers: input, forward
+/// 
+/// For each element `x` of the query, in order, and each element `y` of the `inner` query with 
+/// an equal key, in order, yields `result(x, y)`.
+/// 
+/// The cursor builds a hash lookup of the inner elements by key, then streams the outer query. 
+/// When both inputs are random access and the outer one is smaller, the outer keys are indexed 
+/// instead, and only the matching inner elements are kept.
+/// 
+/// 
+/// 
+/// query.group_join(inner, outer_key, inner_key, result [, hash, keyequal])
+/// ==========================================================================
+/// -   Result: Query
+/// -   Powers: input, forward
+/// 
+/// For each element `x` of the query, in order, yields `result(x, g)` where `g` is the (possibly 
+/// empty) group of elements of `inner` whose key equals `outer_key(x)`.
+/// 
+/// 
+/// 
+/// query.merge_join(inner, outer_key, inner_key, result [, less])
+/// ================================================================
+/// -   Result: Query
+/// -   Powers: input, forward
+/// 
+/// Same result as `join`, for inputs that are both already sorted by key. Both inputs are 
+/// streamed and no lookup is built. The inner query must be at least forward.
+/// 
 /// 
 /// 
 /// query.any([pred])
@@ -110,6 +175,68 @@
 /// 
 /// 
 /// 
+/// query.element_at(ix), query[ix]
+/// ===============================
+/// -   Result: element reference
+/// 
+/// Returns the element at position `ix`, or throws `std::logic_error` when out of bounds.
+/// 
+/// Note: takes O(1) time on random access input (including `select`, `take` and `skip` over 
+/// random access input), O(n) otherwise.
+/// 
+/// 
+/// 
+/// query.order_by(keymap [, less]), query.order_by_descending(keymap [, less])
+/// ============================================================================
+/// -   Result: Query
+/// -   Powers: random access
+/// 
+/// Returns the input sorted by `keymap(x)`. The sort is stable, and `keymap` is invoked exactly
+/// once per element. Additional keys can be added with `then_by(keymap [, less])` and 
+/// `then_by_descending(keymap [, less])`, which are only available directly after an order_by.
+/// 
+/// Note: the input is sorted each time a cursor is created, so like other queries an ordered
+/// query sees the current contents of its input. Every terminal operator sorts again, including
+/// `count`, `element_at` and `operator[]`; copies of a cursor share its sorted elements. Use 
+/// `to_vector` to keep the result of a single sort. `order_by(...).take(n)` keeps only the first
+/// `n` elements, in a heap, for O(N log n) time and O(n) memory.
+/// 
+/// 
+/// 
+/// query.parallel([chunks [, executor]])
+/// ======================================
+/// -   Result: parallel query
+/// 
+/// Splits a random access query into `chunks` ranges (default: hardware concurrency) that are 
+/// evaluated concurrently. The parallel query supports `where` and `select`, applied to each chunk,
+/// and the terminal operators `aggregate(seed, fn, combine)`, `sum`, `count`, `any`, `all`, `min`, 
+/// `max` and `to_vector`, which combine the per-chunk results in order.
+/// 
+/// Chunks run on a pool of threads that is shared by all parallel queries and created on first 
+/// use, unless an `executor` is given: a callable that takes a `std::function<void()>` and runs 
+/// it, for example on an rxcpp worker, or throws without running it. The calling thread evaluates 
+/// the chunks whose tasks have not started, so an executor may queue the tasks to that thread; 
+/// a task that runs after its chunk was taken does nothing.
+/// 
+/// 
+/// 
+/// query.blocked<[BlockSize]>()
+/// ============================
+/// -   Result: blocked query
+/// 
+/// Evaluates a random access query in blocks of `BlockSize` elements (default: 1024) instead
+/// of one element at a time. The blocked query supports `where` and `select`, which run as tight
+/// loops over each block, and the terminal operators `aggregate(seed, fn)`, `sum`, `count`, 
+/// `min`, `max` and `to_vector`. Inputs backed by arrays or vectors are read in place, so numeric
+/// chains such as `from(v).blocked().where(p).select(f).sum()` can be vectorized by the compiler.
+/// The blocks are copied into fixed buffers, so the element type of the source and the result of
+/// each `select` must be trivial, such as arithmetic types and plain structs.
+/// 
+/// Note: floating point sums are accumulated in several partial sums, so rounding may differ
+/// from `sum()` on the unblocked query.
+/// 
+/// 
+/// 
 /// query.count([pred])
 /// ===================
 /// -   Result: std::size_t
@@ -117,7 +244,8 @@
 /// _TODO: should use inner container's iterator distance type instead._
 /// 
 /// (Zero-argument) Returns the number of elements in the range. 
-/// Equivalent to `std::distance(query.begin(), query.end())`
+/// Equivalent to `std::distance(query.begin(), query.end())`, but takes O(1) time when
+/// the input is random access.
 /// 
 /// (One-argument) Returns the number of elements for whicht `pred(element)` is true.
 /// Equivalent to `query.where(pred).count()`
@@ -142,7 +270,9 @@
 #include <map>
 #include <set>
 #include <memory>
+#include <new>
 #include <utility>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 #include <cstddef>
@@ -176,6 +306,11 @@
 #include "linq_take.hpp"
 #include "linq_skip.hpp"
 #include "linq_groupby.hpp"
+#include "linq_distinct.hpp"
+#include "linq_orderby.hpp"
+#include "linq_join.hpp"
+#include "linq_parallel.hpp"
+#include "linq_blocked.hpp"
 #include "linq_where.hpp"
 #include "linq_last.hpp"
 #include "linq_selectmany.hpp"
@@ -204,6 +339,46 @@ namespace detail
     not1_<Pred> not1(Pred p) { return not1_<Pred>(p); }
 }
 
+namespace detail {
+    template <class Cursor>
+    std::size_t count_(Cursor cur, onepass_cursor_tag)
+    {
+        std::size_t n = 0;
+        while (!cur.empty()) {
+            cur.inc();
+            ++n;
+        }
+        return n;
+    }
+
+    template <class Cursor>
+    std::size_t count_(Cursor cur, random_access_cursor_tag)
+    {
+        return cur.empty() ? 0 : cur.size() - cur.position();
+    }
+
+    // moves the cursor forward by ix elements. returns false if the sequence ends first.
+    template <class Cursor>
+    bool seek_(Cursor& cur, std::size_t ix, onepass_cursor_tag)
+    {
+        while(ix && !cur.empty()) {
+            cur.inc();
+            --ix;
+        }
+        return !cur.empty();
+    }
+
+    template <class Cursor>
+    bool seek_(Cursor& cur, std::size_t ix, random_access_cursor_tag)
+    {
+        if (ix >= count_(cur, random_access_cursor_tag())) {
+            return false;
+        }
+        cur.skip(ix);
+        return true;
+    }
+}
+
 namespace detail {
     template <class U>
     struct cast_to {
@@ -226,6 +401,7 @@ public:
         iterator;
 
     linq_driver(Collection c) : c(c) {}
+    linq_driver(const linq_driver&) = default;
 
 
     // -------------------- linq core methods --------------------
@@ -236,9 +412,56 @@ public:
         return linq_groupby<Collection, KeyFn>(c, std::move(fn) );
     }
 
-    // TODO: groupby(keyfn, eq)
+    template <class KeyFn, class Hash, class KeyEqual>
+    linq_driver< linq_groupby<Collection, KeyFn, Hash, KeyEqual> > groupby(KeyFn fn, Hash hash, KeyEqual eq)
+    {
+        return linq_groupby<Collection, KeyFn, Hash, KeyEqual>(c, std::move(fn), std::move(hash), std::move(eq));
+    }
 
-    // TODO: join...
+    template <class InnerCollection, class OuterKeyFn, class InnerKeyFn, class ResultFn>
+    linq_driver< linq_join<Collection, InnerCollection, OuterKeyFn, InnerKeyFn, ResultFn, util::default_hash, default_equality> > 
+        join(const linq_driver<InnerCollection>& inner, OuterKeyFn outerKeyFn, InnerKeyFn innerKeyFn, ResultFn resultFn) const
+    {
+        return join(inner, std::move(outerKeyFn), std::move(innerKeyFn), std::move(resultFn), util::default_hash(), default_equality());
+    }
+
+    template <class InnerCollection, class OuterKeyFn, class InnerKeyFn, class ResultFn, class Hash, class KeyEqual>
+    linq_driver< linq_join<Collection, InnerCollection, OuterKeyFn, InnerKeyFn, ResultFn, Hash, KeyEqual> > 
+        join(const linq_driver<InnerCollection>& inner, OuterKeyFn outerKeyFn, InnerKeyFn innerKeyFn, ResultFn resultFn, Hash hash, KeyEqual eq) const
+    {
+        return linq_join<Collection, InnerCollection, OuterKeyFn, InnerKeyFn, ResultFn, Hash, KeyEqual>(
+            c, inner.collection(), std::move(outerKeyFn), std::move(innerKeyFn), std::move(resultFn), std::move(hash), std::move(eq));
+    }
+
+    template <class InnerCollection, class OuterKeyFn, class InnerKeyFn, class ResultFn>
+    linq_driver< linq_group_join<Collection, InnerCollection, OuterKeyFn, InnerKeyFn, ResultFn, util::default_hash, default_equality> > 
+        group_join(const linq_driver<InnerCollection>& inner, OuterKeyFn outerKeyFn, InnerKeyFn innerKeyFn, ResultFn resultFn) const
+    {
+        return group_join(inner, std::move(outerKeyFn), std::move(innerKeyFn), std::move(resultFn), util::default_hash(), default_equality());
+    }
+
+    template <class InnerCollection, class OuterKeyFn, class InnerKeyFn, class ResultFn, class Hash, class KeyEqual>
+    linq_driver< linq_group_join<Collection, InnerCollection, OuterKeyFn, InnerKeyFn, ResultFn, Hash, KeyEqual> > 
+        group_join(const linq_driver<InnerCollection>& inner, OuterKeyFn outerKeyFn, InnerKeyFn innerKeyFn, ResultFn resultFn, Hash hash, KeyEqual eq) const
+    {
+        return linq_group_join<Collection, InnerCollection, OuterKeyFn, InnerKeyFn, ResultFn, Hash, KeyEqual>(
+            c, inner.collection(), std::move(outerKeyFn), std::move(innerKeyFn), std::move(resultFn), std::move(hash), std::move(eq));
+    }
+
+    template <class InnerCollection, class OuterKeyFn, class InnerKeyFn, class ResultFn>
+    linq_driver< linq_merge_join<Collection, InnerCollection, OuterKeyFn, InnerKeyFn, ResultFn, default_less> > 
+        merge_join(const linq_driver<InnerCollection>& inner, OuterKeyFn outerKeyFn, InnerKeyFn innerKeyFn, ResultFn resultFn) const
+    {
+        return merge_join(inner, std::move(outerKeyFn), std::move(innerKeyFn), std::move(resultFn), default_less());
+    }
+
+    template <class InnerCollection, class OuterKeyFn, class InnerKeyFn, class ResultFn, class Less>
+    linq_driver< linq_merge_join<Collection, InnerCollection, OuterKeyFn, InnerKeyFn, ResultFn, Less> > 
+        merge_join(const linq_driver<InnerCollection>& inner, OuterKeyFn outerKeyFn, InnerKeyFn innerKeyFn, ResultFn resultFn, Less less) const
+    {
+        return linq_merge_join<Collection, InnerCollection, OuterKeyFn, InnerKeyFn, ResultFn, Less>(
+            c, inner.collection(), std::move(outerKeyFn), std::move(innerKeyFn), std::move(resultFn), std::move(less));
+    }
 
     template <class Selector>
     linq_driver< linq_select<Collection, Selector> > select(Selector sel) const {
@@ -318,7 +541,7 @@ public:
     }
 
     typename std::iterator_traits<iterator>::difference_type count() const {
-        return std::distance(begin(), end());
+        return detail::count_(c.get_cursor(), typename Collection::cursor::cursor_category());
     }
 
     template <class Predicate>
@@ -329,35 +552,53 @@ public:
 
     // TODO: default_if_empty
     
-    // TODO: distinct()
-    // TODO: distinct(cmp)
+    linq_driver< linq_distinct<Collection, util::default_hash, default_equality> > 
+        distinct(std::size_t capacity = 0) const
+    {
+        return distinct(util::default_hash(), default_equality(), capacity);
+    }
+
+    template <class Hash, class KeyEqual>
+    linq_driver< linq_distinct<Collection, Hash, KeyEqual> > 
+        distinct(Hash hash, KeyEqual eq, std::size_t capacity = 0) const
+    {
+        return linq_distinct<Collection, Hash, KeyEqual>(c, std::move(hash), std::move(eq), capacity);
+    }
 
     reference_type element_at(std::size_t ix) const {
         auto cur = c.get_cursor();
-        while(ix && !cur.empty()) {
-            cur.inc();
-            --ix;
+        if (!detail::seek_(cur, ix, typename Collection::cursor::cursor_category())) {
+            throw std::logic_error("index out of bounds");
         }
-        if (cur.empty()) { throw std::logic_error("index out of bounds"); }
-        else             { return cur.get(); }
+        return cur.get();
     }
 
     element_type element_at_or_default(std::size_t ix) const {
         auto cur = c.get_cursor();
-        while(ix && !cur.empty()) {
-            cur.inc();
-            -- ix;
+        if (!detail::seek_(cur, ix, typename Collection::cursor::cursor_category())) {
+            return element_type();
         }
-        if (cur.empty()) { return element_type(); }
-        else             { return cur.get(); }
+        return cur.get();
     }
 
     bool empty() const {
         return !this->any();
     }
 
-    // TODO: except(second)
-    // TODO: except(second, eq)
+    template <class SecondCollection>
+    linq_driver< linq_except<Collection, SecondCollection, util::default_hash, default_equality> > 
+        except(const linq_driver<SecondCollection>& second, std::size_t capacity = 0) const
+    {
+        return except(second, util::default_hash(), default_equality(), capacity);
+    }
+
+    template <class SecondCollection, class Hash, class KeyEqual>
+    linq_driver< linq_except<Collection, SecondCollection, Hash, KeyEqual> > 
+        except(const linq_driver<SecondCollection>& second, Hash hash, KeyEqual eq, std::size_t capacity = 0) const
+    {
+        return linq_except<Collection, SecondCollection, Hash, KeyEqual>(
+            c, second.collection(), std::move(hash), std::move(eq), capacity);
+    }
 
     reference_type first() const {
         auto cur = c.get_cursor();
@@ -391,8 +632,20 @@ public:
         else             { return cur.get(); }
     }
     
-    // TODO: intersect(second)
-    // TODO: intersect(second, eq)
+    template <class SecondCollection>
+    linq_driver< linq_intersect<Collection, SecondCollection, util::default_hash, default_equality> > 
+        intersect(const linq_driver<SecondCollection>& second, std::size_t capacity = 0) const
+    {
+        return intersect(second, util::default_hash(), default_equality(), capacity);
+    }
+
+    template <class SecondCollection, class Hash, class KeyEqual>
+    linq_driver< linq_intersect<Collection, SecondCollection, Hash, KeyEqual> > 
+        intersect(const linq_driver<SecondCollection>& second, Hash hash, KeyEqual eq, std::size_t capacity = 0) const
+    {
+        return linq_intersect<Collection, SecondCollection, Hash, KeyEqual>(
+            c, second.collection(), std::move(hash), std::move(eq), capacity);
+    }
 
     // note: forward cursors and beyond can provide a clone, so we can refer to the element directly
     typename std::conditional< 
@@ -455,10 +708,29 @@ public:
         return *it;
     }
 
-    // TODO: order_by(sel)
-    // TODO: order_by(sel, less)
-    // TODO: order_by_descending(sel)
-    // TODO: order_by_descending(sel, less)
+    template <class KeySelector>
+    linq_driver< linq_orderby<Collection, KeySelector, default_less> > order_by(KeySelector sel) const {
+        return linq_orderby<Collection, KeySelector, default_less>(c, std::move(sel), default_less());
+    }
+
+    template <class KeySelector, class Less>
+    linq_driver< linq_orderby<Collection, KeySelector, Less> > order_by(KeySelector sel, Less less) const {
+        return linq_orderby<Collection, KeySelector, Less>(c, std::move(sel), std::move(less));
+    }
+
+    template <class KeySelector>
+    linq_driver< linq_orderby<Collection, KeySelector, detail::descending<default_less>> > 
+        order_by_descending(KeySelector sel) const 
+    {
+        return linq_orderby<Collection, KeySelector, detail::descending<default_less>>(c, std::move(sel), detail::descending<default_less>());
+    }
+
+    template <class KeySelector, class Less>
+    linq_driver< linq_orderby<Collection, KeySelector, detail::descending<Less>> > 
+        order_by_descending(KeySelector sel, Less less) const 
+    {
+        return linq_orderby<Collection, KeySelector, detail::descending<Less>>(c, std::move(sel), detail::descending<Less>(std::move(less)));
+    }
 
     // TODO: sequence_equal(second)
     // TODO: sequence_equal(second, eq)
@@ -491,21 +763,79 @@ public:
         return from(begin(), end()).select(sel).sum(seed);			
     }
 
-    linq_driver<linq_take<Collection>> take(std::size_t n) const {
-        return linq_take<Collection>(c, n);
+    linq_driver<typename take_traits<Collection>::type> take(std::size_t n) const {
+        return take_traits<Collection>::make(c, n);
     }
 
     // TODO: take_while
 
-    // TODO: then_by / then_by_descending ?
+    // note: then_by is only available directly after order_by or then_by
+
+    template <class KeySelector>
+    linq_driver< typename then_by_traits<Collection, KeySelector, default_less>::type > 
+        then_by(KeySelector sel) const 
+    {
+        return c.then_by(std::move(sel), default_less());
+    }
+
+    template <class KeySelector, class Less>
+    linq_driver< typename then_by_traits<Collection, KeySelector, Less>::type > 
+        then_by(KeySelector sel, Less less) const 
+    {
+        return c.then_by(std::move(sel), std::move(less));
+    }
+
+    template <class KeySelector>
+    linq_driver< typename then_by_traits<Collection, KeySelector, detail::descending<default_less>>::type > 
+        then_by_descending(KeySelector sel) const 
+    {
+        return c.then_by(std::move(sel), detail::descending<default_less>());
+    }
+
+    template <class KeySelector, class Less>
+    linq_driver< typename then_by_traits<Collection, KeySelector, detail::descending<Less>>::type > 
+        then_by_descending(KeySelector sel, Less less) const 
+    {
+        return c.then_by(std::move(sel), detail::descending<Less>(std::move(less)));
+    }
 
     // TODO: to_...
 
-    // TODO: union(second)
-    // TODO: union(eq)
+    // note: union is a keyword
+    template <class SecondCollection>
+    linq_driver< linq_union<Collection, SecondCollection, util::default_hash, default_equality> > 
+        union_with(const linq_driver<SecondCollection>& second, std::size_t capacity = 0) const
+    {
+        return union_with(second, util::default_hash(), default_equality(), capacity);
+    }
+
+    template <class SecondCollection, class Hash, class KeyEqual>
+    linq_driver< linq_union<Collection, SecondCollection, Hash, KeyEqual> > 
+        union_with(const linq_driver<SecondCollection>& second, Hash hash, KeyEqual eq, std::size_t capacity = 0) const
+    {
+        return linq_union<Collection, SecondCollection, Hash, KeyEqual>(
+            c, second.collection(), std::move(hash), std::move(eq), capacity);
+    }
 
     // TODO: zip
     
+    // -------------------- parallel evaluation --------------------
+
+    linq_parallel<Collection> parallel() const {
+        return parallel(std::thread::hardware_concurrency());
+    }
+
+    linq_parallel<Collection> parallel(std::size_t chunks, parallel_executor executor = parallel_executor()) const {
+        return linq_parallel<Collection>(c, chunks, std::move(executor));
+    }
+
+    // -------------------- blocked evaluation --------------------
+
+    template <std::size_t BlockSize = 1024>
+    linq_blocked<Collection, BlockSize> blocked() const {
+        return linq_blocked<Collection, BlockSize>(c);
+    }
+
     // -------------------- conversion methods --------------------
 
     std::vector<typename Collection::cursor::element_type> to_vector() const 
@@ -533,13 +863,14 @@ public:
 
     typename std::iterator_traits<iterator>::reference
         operator[](std::size_t ix) const {
-        return *(begin()+=ix);
+        return element_at(ix);
     }
 
     // -------------------- collection methods (leaky abstraction) --------------------
 
     typedef typename Collection::cursor cursor;
-    cursor get_cursor() { return c.get_cursor(); }
+    cursor get_cursor() const { return c.get_cursor(); }
+    const Collection& collection() const { return c; }
 
     linq_driver< dynamic_collection<typename Collection::cursor::reference_type> >
         late_bind() const
@@ -0,0 +1,400 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#if !defined(CPPLINQ_LINQ_BLOCKED_HPP)
+#define CPPLINQ_LINQ_BLOCKED_HPP
+#pragma once
+
+#include <cstddef>
+
+namespace cpplinq
+{
+    namespace util
+    {
+        // true for iterators known to address contiguous storage
+        template <class Iter>
+        struct is_contiguous_iterator
+        {
+        private:
+            typedef typename std::iterator_traits<Iter>::value_type value_type;
+            typedef typename std::conditional<std::is_same<value_type, bool>::value, int, value_type>::type vector_value_type;
+        public:
+            static const bool value =
+                std::is_pointer<Iter>::value ||
+                (!std::is_same<value_type, bool>::value &&
+                 (std::is_same<Iter, typename std::vector<vector_value_type>::iterator>::value ||
+                  std::is_same<Iter, typename std::vector<vector_value_type>::const_iterator>::value));
+        };
+    }
+
+    namespace detail
+    {
+        // ---- sources: feed a cursor to a sink in blocks of up to N elements ----
+
+        template <class Cursor, std::size_t N>
+        struct block_source
+        {
+            typedef typename Cursor::element_type value_type;
+
+            static_assert(std::is_trivial<value_type>::value, "blocked() requires a trivial element type, such as an arithmetic type");
+
+            Cursor cur;
+            explicit block_source(Cursor cur) : cur(std::move(cur)) {}
+
+            // random access, but not known to be contiguous: gather each block into a buffer
+            template <class Sink>
+            void run(Sink& sink) {
+                value_type buffer[N];
+                std::size_t rem = cur.empty() ? 0 : cur.size() - cur.position();
+                while (rem) {
+                    const std::size_t n = rem < N ? rem : N;
+                    for (std::size_t i = 0; i != n; ++i) {
+                        buffer[i] = cur.get(i);
+                    }
+                    sink.push(buffer, n);
+                    cur.skip(n);
+                    rem -= n;
+                }
+            }
+        };
+
+        template <class Iter, std::size_t N, bool Contiguous = util::is_contiguous_iterator<Iter>::value>
+        struct block_iter_source : block_source<iter_cursor<Iter>, N>
+        {
+            explicit block_iter_source(iter_cursor<Iter> cur) : block_source<iter_cursor<Iter>, N>(std::move(cur)) {}
+        };
+
+        // contiguous storage: blocks point directly into the source
+        template <class Iter, std::size_t N>
+        struct block_iter_source<Iter, N, true>
+        {
+            typedef typename iter_cursor<Iter>::element_type value_type;
+
+            iter_cursor<Iter> cur;
+            explicit block_iter_source(iter_cursor<Iter> cur) : cur(std::move(cur)) {}
+
+            template <class Sink>
+            void run(Sink& sink) {
+                std::size_t rem = cur.empty() ? 0 : cur.size() - cur.position();
+                if (!rem) {
+                    return;
+                }
+                const value_type* data = &cur.get();
+                while (rem) {
+                    const std::size_t n = rem < N ? rem : N;
+                    sink.push(data, n);
+                    data += n;
+                    rem -= n;
+                }
+            }
+        };
+
+        template <class Collection, std::size_t N>
+        struct block_source_for
+        {
+            typedef block_source<typename Collection::cursor, N> type;
+        };
+
+        template <class Iter, std::size_t N>
+        struct block_source_for<iter_cursor<Iter>, N>
+        {
+            typedef block_iter_source<Iter, N> type;
+        };
+
+        // ---- stages: where compacts each block through a selection, select maps it ----
+
+        template <class T, class Predicate, class Next, std::size_t N>
+        struct block_where_sink
+        {
+            static_assert(std::is_trivial<T>::value, "blocked().where() requires a trivial element type, such as an arithmetic type");
+
+            const Predicate& pred;
+            Next& next;
+            T buffer[N];
+
+            block_where_sink(const Predicate& pred, Next& next) : pred(pred), next(next) {}
+
+            void push(const T* in, std::size_t n) {
+                // branch free: every element is written, only selected ones are kept
+                std::size_t k = 0;
+                for (std::size_t i = 0; i != n; ++i) {
+                    buffer[k] = in[i];
+                    k += pred(in[i]) ? 1 : 0;
+                }
+                if (k) {
+                    next.push(buffer, k);
+                }
+            }
+        };
+
+        template <class T, class U, class Selector, class Next, std::size_t N>
+        struct block_select_sink
+        {
+            static_assert(std::is_trivial<U>::value, "blocked().select() requires a selector that returns a trivial type, such as an arithmetic type");
+
+            const Selector& sel;
+            Next& next;
+            U buffer[N];
+
+            block_select_sink(const Selector& sel, Next& next) : sel(sel), next(next) {}
+
+            void push(const T* in, std::size_t n) {
+                for (std::size_t i = 0; i != n; ++i) {
+                    buffer[i] = sel(in[i]);
+                }
+                next.push(buffer, n);
+            }
+        };
+
+        struct block_identity
+        {
+            template <class In>
+            struct output { typedef In type; };
+
+            template <std::size_t N, class Source, class Sink>
+            void run(Source& source, Sink& sink) const {
+                source.run(sink);
+            }
+        };
+
+        template <class Prev, class Predicate>
+        struct block_where
+        {
+            Prev prev;
+            Predicate pred;
+            block_where(Prev prev, Predicate pred) : prev(std::move(prev)), pred(std::move(pred)) {}
+
+            template <class In>
+            struct output { typedef typename Prev::template output<In>::type type; };
+
+            template <std::size_t N, class Source, class Sink>
+            void run(Source& source, Sink& sink) const {
+                typedef typename output<typename Source::value_type>::type T;
+                std::unique_ptr<block_where_sink<T, Predicate, Sink, N>> stage(new block_where_sink<T, Predicate, Sink, N>(pred, sink));
+                prev.template run<N>(source, *stage);
+            }
+        };
+
+        template <class Prev, class Selector>
+        struct block_select
+        {
+            Prev prev;
+            Selector sel;
+            block_select(Prev prev, Selector sel) : prev(std::move(prev)), sel(std::move(sel)) {}
+
+            template <class In>
+            struct output {
+                typedef typename std::decay<typename util::result_of<Selector(const typename Prev::template output<In>::type&)>::type>::type type;
+            };
+
+            template <std::size_t N, class Source, class Sink>
+            void run(Source& source, Sink& sink) const {
+                typedef typename Prev::template output<typename Source::value_type>::type T;
+                typedef typename output<typename Source::value_type>::type U;
+                std::unique_ptr<block_select_sink<T, U, Selector, Sink, N>> stage(new block_select_sink<T, U, Selector, Sink, N>(sel, sink));
+                prev.template run<N>(source, *stage);
+            }
+        };
+
+        // ---- terminal sinks ----
+
+        template <class T>
+        struct block_sum_sink
+        {
+            // independent lanes let the compiler vectorize the accumulation
+            enum { lanes = 8 };
+            T acc[lanes];
+
+            block_sum_sink() {
+                for (auto& a : acc) {
+                    a = T();
+                }
+            }
+
+            void push(const T* in, std::size_t n) {
+                std::size_t i = 0;
+                for (; i + lanes <= n; i += lanes) {
+                    for (std::size_t l = 0; l != lanes; ++l) {
+                        acc[l] += in[i + l];
+                    }
+                }
+                for (; i != n; ++i) {
+                    acc[0] += in[i];
+                }
+            }
+
+            T result() const {
+                T total = T();
+                for (auto& a : acc) {
+                    total += a;
+                }
+                return total;
+            }
+        };
+
+        struct block_count_sink
+        {
+            std::size_t count;
+            block_count_sink() : count(0) {}
+
+            template <class T>
+            void push(const T*, std::size_t n) { count += n; }
+        };
+
+        template <class T, class Acc, class Fn>
+        struct block_aggregate_sink
+        {
+            Acc acc;
+            const Fn& fn;
+            block_aggregate_sink(Acc seed, const Fn& fn) : acc(std::move(seed)), fn(fn) {}
+
+            void push(const T* in, std::size_t n) {
+                for (std::size_t i = 0; i != n; ++i) {
+                    acc = fn(acc, in[i]);
+                }
+            }
+        };
+
+        template <class T, class Compare>
+        struct block_best_sink
+        {
+            const Compare& better;
+            util::maybe<T> best;
+            explicit block_best_sink(const Compare& better) : better(better) {}
+
+            void push(const T* in, std::size_t n) {
+                std::size_t b = 0;
+                for (std::size_t i = 1; i != n; ++i) {
+                    if (better(in[i], in[b])) {
+                        b = i;
+                    }
+                }
+                if (!best || better(in[b], *best)) {
+                    best.set(in[b]);
+                }
+            }
+        };
+
+        template <class T>
+        struct block_vector_sink
+        {
+            std::vector<T> values;
+
+            void push(const T* in, std::size_t n) {
+                values.insert(values.end(), in, in + n);
+            }
+        };
+    }
+
+    // evaluates where/select chains over blocks of up to BlockSize elements instead of
+    //   one element at a time through cursors. Each stage runs a tight loop over a
+    //   contiguous block: where compacts the selected elements into a buffer without
+    //   branching, select maps a block into a buffer, and the terminal operators
+    //   consume whole blocks. Contiguous sources (pointers, vector iterators) are read
+    //   in place.
+    //
+    //   selectors and predicates should be cheap and free of side effects; they run
+    //   in block order, which is the input order. The elements are copied into fixed
+    //   buffers of BlockSize, so every element type in the chain must be trivial.
+    template <class Collection, std::size_t BlockSize, class Stages = detail::block_identity>
+    class linq_blocked
+    {
+        static_assert(util::less_or_equal_cursor_category<
+                          random_access_cursor_tag,
+                          typename Collection::cursor::cursor_category>::value,
+                      "blocked() requires a random access query");
+        static_assert(BlockSize > 0, "blocked() requires a non-zero block size");
+
+        typedef typename detail::block_source_for<Collection, BlockSize>::type
+            source_type;
+
+    public:
+        typedef typename Stages::template output<typename source_type::value_type>::type
+            element_type;
+
+        linq_blocked(const Collection& c, Stages stages = Stages()) : c(c), stages(std::move(stages)) {}
+
+        template <class Predicate>
+        linq_blocked<Collection, BlockSize, detail::block_where<Stages, Predicate>> where(Predicate pred) const {
+            return linq_blocked<Collection, BlockSize, detail::block_where<Stages, Predicate>>(
+                c, detail::block_where<Stages, Predicate>(stages, std::move(pred)));
+        }
+
+        template <class Selector>
+        linq_blocked<Collection, BlockSize, detail::block_select<Stages, Selector>> select(Selector sel) const {
+            return linq_blocked<Collection, BlockSize, detail::block_select<Stages, Selector>>(
+                c, detail::block_select<Stages, Selector>(stages, std::move(sel)));
+        }
+
+        // note: floating point sums are accumulated in several lanes, so rounding
+        //   may differ from sum() on the unblocked query.
+        element_type sum() const {
+            detail::block_sum_sink<element_type> sink;
+            run(sink);
+            return sink.result();
+        }
+
+        element_type sum(element_type seed) const {
+            return sum() + seed;
+        }
+
+        std::size_t count() const {
+            detail::block_count_sink sink;
+            run(sink);
+            return sink.count;
+        }
+
+        template <class T, class Fn>
+        T aggregate(T seed, Fn fn) const {
+            detail::block_aggregate_sink<element_type, T, Fn> sink(std::move(seed), fn);
+            run(sink);
+            return sink.acc;
+        }
+
+        element_type min() const {
+            return min(std::less<element_type>());
+        }
+
+        template <class Compare>
+        element_type min(Compare less) const {
+            detail::block_best_sink<element_type, Compare> sink(less);
+            run(sink);
+            if (!sink.best) {
+                throw std::logic_error("min performed on empty range");
+            }
+            return *sink.best;
+        }
+
+        element_type max() const {
+            return max(std::less<element_type>());
+        }
+
+        template <class Compare>
+        element_type max(Compare less) const {
+            auto greater = [&](const element_type& a, const element_type& b) { return less(b, a); };
+            detail::block_best_sink<element_type, decltype(greater)> sink(greater);
+            run(sink);
+            if (!sink.best) {
+                throw std::logic_error("max performed on empty range");
+            }
+            return *sink.best;
+        }
+
+        std::vector<element_type> to_vector() const {
+            detail::block_vector_sink<element_type> sink;
+            run(sink);
+            return std::move(sink.values);
+        }
+
+    private:
+        template <class Sink>
+        void run(Sink& sink) const {
+            source_type source(c.get_cursor());
+            stages.template run<BlockSize>(source, sink);
+        }
+
+        Collection c;
+        Stages stages;
+    };
+}
+
+#endif // !defined(CPPLINQ_LINQ_BLOCKED_HPP)
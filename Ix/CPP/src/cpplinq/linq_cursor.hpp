@@ -43,6 +43,7 @@
 /// Random access cursor
 /// ====================
 /// -   skip(cur, n)
+/// -   get(cur, n)   -> T  : element n positions past the current one, without moving
 /// -   position(cur) -> n
 /// -   size(cur)     -> n
 /// -   truncate(n)         : keep only n more elements
@@ -169,10 +170,11 @@ namespace cpplinq {
         }
         
         void skip(std::ptrdiff_t n) { current += n; }
-        std::size_t size() { return fin-start; }
-        void position() { return current-start; }
+        typename std::iterator_traits<Iterator>::reference get(std::ptrdiff_t n) const { return *(current + n); }
+        std::size_t size() const { return fin-start; }
+        std::size_t position() const { return current-start; }
         void truncate(std::size_t n) {
-            if (n > fin-current) {
+            if (n < static_cast<std::size_t>(fin-current)) {
                 fin = current + n;
             }
         }
@@ -203,21 +205,151 @@ namespace cpplinq {
     template <class T>
     struct cursor_interface
     {
+        typedef typename std::remove_cv<typename std::remove_reference<T>::type>::type
+            value_type;
+        // an element as next_block passes it: the value, or its address when T is a reference
+        typedef typename std::conditional<std::is_reference<T>::value,
+                                          typename std::remove_reference<T>::type*,
+                                          value_type>::type
+            slot_type;
+
         virtual bool empty() const = 0;
         virtual void inc() = 0;
-        virtual cursor_interface* copy() const = 0;
+
+        // copies into buffer when the copy fits in size bytes, else onto the heap
+        virtual cursor_interface* copy(void* buffer, std::size_t size) const = 0;
+        // only called on cursors that live in a buffer of the same size
+        virtual cursor_interface* move(void* buffer) = 0;
 
         virtual T get() const = 0;
 
+        // assigns up to n elements to out, moving past them. Returns the number
+        //   assigned, which is less than n only at the end of the sequence.
+        virtual std::size_t next_block(slot_type* out, std::size_t n) = 0;
+
+        // false for onepass cursors, which get reads one element at a time: a block
+        //   would consume elements that first() or take(n) never asked for, and the
+        //   addresses it keeps for references would not stay valid
+        virtual bool batches() const = 0;
+
         virtual ~cursor_interface() {}
     };
 
+    namespace detail
+    {
+        // dynamic_cursor fetches elements through next_block, in blocks that grow 
+        //   from 1 to capacity elements, so that long scans make one virtual call per
+        //   block while first() and take(n) read ahead at most n - 1 elements. Values
+        //   are copied into the block and references are kept as pointers, unless the
+        //   cursor is onepass; those are read one at a time. Only get 
+        //   fetches a block, so empty() does not read ahead of the current element.
+        //   The block is block_size bytes and is copied with the cursor, so elements
+        //   that do not fit four to a block are fetched one at a time instead.
+        static const std::size_t block_size = 16 * sizeof(void*);
+
+        template <class T, bool Batched = (
+                               std::is_reference<T>::value || (
+                               !std::is_const<T>::value &&
+                               std::is_default_constructible<T>::value &&
+                               std::is_copy_assignable<T>::value)) &&
+                               sizeof(typename cursor_interface<T>::slot_type) * 4 <= block_size>
+        class dynamic_cursor_block
+        {
+        public:
+            typedef typename cursor_interface<T>::value_type value_type;
+
+            bool empty(cursor_interface<T>* cur) const { return !cur || cur->empty(); }
+            void inc(cursor_interface<T>* cur) { cur->inc(); }
+            T get(cursor_interface<T>* cur) const { return cur->get(); }
+            std::size_t next_block(cursor_interface<T>* cur, value_type* out, std::size_t n) {
+                return cur ? cur->next_block(out, n) : 0;
+            }
+        };
+
+        template <class T>
+        class dynamic_cursor_block<T, true>
+        {
+            typedef typename cursor_interface<T>::slot_type slot_type;
+
+            static const std::size_t capacity =
+                block_size / sizeof(slot_type) < 16 ? block_size / sizeof(slot_type) : 16;
+
+            mutable slot_type slots[capacity];
+            mutable std::size_t at, count, fill;
+
+            static T element(slot_type& slot, std::true_type) { return *slot; }
+            static T element(slot_type& slot, std::false_type) { return slot; }
+
+            std::size_t rest(cursor_interface<T>* cur, typename cursor_interface<T>::value_type* out, std::size_t n, std::true_type) {
+                std::size_t i = 0;
+                for (; i < n && !cur->empty(); ++i, cur->inc()) {
+                    out[i] = cur->get();
+                }
+                return i;
+            }
+            std::size_t rest(cursor_interface<T>* cur, typename cursor_interface<T>::value_type* out, std::size_t n, std::false_type) {
+                return cur->next_block(out, n);
+            }
+
+        public:
+            typedef typename cursor_interface<T>::value_type value_type;
+
+            dynamic_cursor_block() : at(0), count(0), fill(1) {}
+
+            bool empty(cursor_interface<T>* cur) const {
+                return at == count && (!cur || cur->empty());
+            }
+            void inc(cursor_interface<T>* cur) {
+                if (at != count) {
+                    ++at;
+                    return;
+                }
+                if (!cur)
+                    throw std::logic_error("inc past end");
+                cur->inc();
+            }
+            T get(cursor_interface<T>* cur) const {
+                if (at == count) {
+                    at = count = 0;
+                    if (cur && !cur->batches())
+                        return cur->get();
+                    if (cur) {
+                        count = cur->next_block(slots, fill);
+                        fill = fill < capacity ? fill * 2 : capacity;
+                    }
+                    if (count == 0)
+                        throw std::logic_error("get past end");
+                }
+                return element(slots[at], std::is_reference<T>());
+            }
+            std::size_t next_block(cursor_interface<T>* cur, value_type* out, std::size_t n) {
+                std::size_t i = 0;
+                for (; i < n && at != count; ++i) {
+                    out[i] = element(slots[at++], std::is_reference<T>());
+                }
+                return i < n && cur ? i + rest(cur, out + i, n - i, std::is_reference<T>()) : i;
+            }
+        };
+    }
+
+    // a type erased forward cursor. Cursors of up to inline_size bytes are stored
+    //   in place, so creating and copying them does not allocate.
     template <class T>
     class dynamic_cursor : collection_tag
     {
+        static const std::size_t inline_size = 8 * sizeof(void*);
+
+        struct storage_type
+        {
+            alignas(std::max_align_t) unsigned char bytes[inline_size];
+        };
+
         template <class Cur>
         struct instance : cursor_interface<T>
         {
+            typedef typename cursor_interface<T>::value_type value_type;
+            typedef typename cursor_interface<T>::slot_type slot_type;
+
             Cur innerCursor;
 
             instance(Cur cursor) : innerCursor(std::move(cursor))
@@ -235,54 +367,148 @@ namespace cpplinq {
             {
                 return innerCursor.get();
             }
-            virtual cursor_interface<T>* copy() const 
+            virtual cursor_interface<T>* copy(void* buffer, std::size_t size) const 
             {
+                if (fits(size)) {
+                    return new (buffer) instance(*this);
+                }
                 return new instance(*this);
             }
+            virtual cursor_interface<T>* move(void* buffer)
+            {
+                return new (buffer) instance(std::move(*this));
+            }
+            virtual bool batches() const
+            {
+                return std::is_convertible<typename Cur::cursor_category, forward_cursor_tag>::value;
+            }
+            virtual std::size_t next_block(slot_type* out, std::size_t n)
+            {
+                return next_block(out, n, std::integral_constant<int, 
+                    std::is_reference<T>::value ? 2 : std::is_copy_assignable<value_type>::value ? 1 : 0>());
+            }
+            std::size_t next_block(slot_type* out, std::size_t n, std::integral_constant<int, 2>)
+            {
+                std::size_t i = 0;
+                for (; i < n && !innerCursor.empty(); ++i, innerCursor.inc()) {
+                    T element = innerCursor.get();
+                    out[i] = std::addressof(element);
+                }
+                return i;
+            }
+            std::size_t next_block(slot_type* out, std::size_t n, std::integral_constant<int, 1>)
+            {
+                std::size_t i = 0;
+                for (; i < n && !innerCursor.empty(); ++i, innerCursor.inc()) {
+                    out[i] = innerCursor.get();
+                }
+                return i;
+            }
+            // never called: the block does not batch these elements and
+            //   dynamic_cursor::next_block is only declared for copy assignable ones
+            std::size_t next_block(slot_type*, std::size_t, std::integral_constant<int, 0>)
+            {
+                throw std::logic_error("next_block requires copy assignable elements");
+            }
+
+            static bool fits(std::size_t size) {
+                return sizeof(instance) <= size &&
+                    std::alignment_of<instance>::value <= std::alignment_of<storage_type>::value &&
+                    std::is_nothrow_move_constructible<Cur>::value;
+            }
         };
 
-        std::unique_ptr<cursor_interface<T>> myCur;
+        cursor_interface<T>* myCur;
+        storage_type storage;
+        detail::dynamic_cursor_block<T> block;
+
+        bool is_inline() const { return myCur == static_cast<const void*>(&storage); }
+
+        void reset() {
+            if (is_inline()) {
+                myCur->~cursor_interface<T>();
+            } else {
+                delete myCur;
+            }
+            myCur = nullptr;
+        }
+
+        void take(dynamic_cursor& other) {
+            if (other.is_inline()) {
+                myCur = other.myCur->move(&storage);
+                other.reset();
+            } else {
+                myCur = other.myCur;
+                other.myCur = nullptr;
+            }
+            block = std::move(other.block);
+        }
 
     public:
         typedef forward_cursor_tag cursor_category; // TODO: not strictly true!
         typedef typename std::remove_reference<T>::type element_type;
         typedef T reference_type;
+        typedef typename cursor_interface<T>::value_type value_type;
 
-        dynamic_cursor() {}
+        dynamic_cursor() : myCur(nullptr) {}
 
         dynamic_cursor(const dynamic_cursor& other)
-        : myCur(other.myCur ? other.myCur->copy() : nullptr)
+        : myCur(other.myCur ? other.myCur->copy(&storage, inline_size) : nullptr)
+        , block(other.block)
         {
         }
 
         dynamic_cursor(dynamic_cursor&& other)
-        : myCur(other.myCur.release())
+        : myCur(nullptr)
         {
+            take(other);
         }
 
         template <class Cursor>
         dynamic_cursor(Cursor cursor) 
-        : myCur(new instance<Cursor>(std::move(cursor)))
+        : myCur(nullptr)
         { 
+            if (instance<Cursor>::fits(inline_size)) {
+                myCur = new (&storage) instance<Cursor>(std::move(cursor));
+            } else {
+                myCur = new instance<Cursor>(std::move(cursor));
+            }
         }
 
         template <class Iterator>
         dynamic_cursor(Iterator start, Iterator end)
+        : myCur(nullptr)
         {
             *this = iter_cursor<Iterator>(start, end);
         }
 
-        bool empty() const { return !myCur || myCur->empty(); }
-        void inc() { myCur->inc(); }
-        T get() const { return myCur->get(); }
+        ~dynamic_cursor() { reset(); }
+
+        bool empty() const { return block.empty(myCur); }
+        void inc() { block.inc(myCur); }
+        T get() const { return block.get(myCur); }
+
+        // assigns up to n elements to out with a single virtual call, moving past
+        //   them. Returns the number assigned; less than n means the end was reached.
+        //   Only declared when the elements are copy assignable.
+        template <class V = value_type>
+        typename std::enable_if<std::is_copy_assignable<V>::value, std::size_t>::type
+        next_block(value_type* out, std::size_t n) { return block.next_block(myCur, out, n); }
 
         dynamic_cursor& operator=(dynamic_cursor other)
         {
-            std::swap(myCur, other.myCur);
+            reset();
+            take(other);
             return *this;
         }
     };
 
+    template <class T>
+    const std::size_t detail::dynamic_cursor_block<T, true>::capacity;
+
+    template <class T>
+    const std::size_t dynamic_cursor<T>::inline_size;
+
     template <class T>
     struct container_interface
     {
@@ -0,0 +1,309 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#if !defined(CPPLINQ_LINQ_DISTINCT_HPP)
+#define CPPLINQ_LINQ_DISTINCT_HPP
+#pragma once
+
+#include <cstddef>
+
+namespace cpplinq
+{
+    // set operators. Elements are tracked in a util::flat_index, an open addressing
+    //   table that stores each distinct element once in a contiguous array. The table
+    //   belongs to the cursor and is shared by its copies, so the cursors are onepass.
+    //   They support forget() and atbegin() so that skip() can be applied to them.
+
+    namespace detail
+    {
+        template <class Cursor, class Hash, class KeyEqual>
+        struct set_index
+        {
+            typedef typename std::remove_cv<typename Cursor::element_type>::type
+                value_type;
+            typedef util::flat_index<value_type, Hash, KeyEqual>
+                type;
+
+            static std::shared_ptr<type> make(const Hash& hash, const KeyEqual& eq, std::size_t capacity) {
+                auto index = std::make_shared<type>(hash, eq);
+                if (capacity) {
+                    index->reserve(capacity);
+                }
+                return index;
+            }
+
+            template <class Other>
+            static std::shared_ptr<type> make(Other cur, const Hash& hash, const KeyEqual& eq, std::size_t capacity) {
+                auto index = make(hash, eq, capacity);
+                for (; !cur.empty(); cur.inc()) {
+                    index->insert(cur.get());
+                }
+                return index;
+            }
+        };
+    }
+
+    // the first occurrence of each element, in input order
+    template <class Collection, class Hash, class KeyEqual>
+    class linq_distinct
+    {
+        typedef typename Collection::cursor
+            inner_cursor;
+        typedef detail::set_index<inner_cursor, Hash, KeyEqual>
+            set_index;
+
+    public:
+        class cursor
+        {
+        public:
+            typedef onepass_cursor_tag
+                cursor_category;
+            typedef typename inner_cursor::element_type
+                element_type;
+            typedef typename inner_cursor::reference_type
+                reference_type;
+
+            cursor(inner_cursor cur, std::shared_ptr<typename set_index::type> seen)
+            : cur(std::move(cur)), seen(std::move(seen)), begin(true)
+            {
+                skip_seen();
+            }
+
+            void forget() { begin = true; }
+            bool atbegin() const { return begin; }
+            bool empty() const { return cur.empty(); }
+            void inc() {
+                cur.inc();
+                begin = false;
+                skip_seen();
+            }
+            reference_type get() const { return cur.get(); }
+
+        private:
+            void skip_seen() {
+                while (!cur.empty() && !seen->insert(cur.get()).second) {
+                    cur.inc();
+                }
+            }
+
+            inner_cursor cur;
+            std::shared_ptr<typename set_index::type> seen;
+            bool begin;
+        };
+
+        linq_distinct(const Collection& c, Hash hash, KeyEqual eq, std::size_t capacity)
+        : c(c), hash(std::move(hash)), eq(std::move(eq)), capacity(capacity)
+        {
+        }
+
+        cursor get_cursor() const {
+            return cursor(c.get_cursor(), set_index::make(hash, eq, capacity));
+        }
+
+    private:
+        Collection c;
+        Hash hash;
+        KeyEqual eq;
+        std::size_t capacity;
+    };
+
+    // the distinct elements of the first input followed by those of the second
+    //   that were not in the first
+    template <class Collection, class Second, class Hash, class KeyEqual>
+    class linq_union
+    {
+        typedef typename Collection::cursor
+            first_cursor;
+        typedef typename Second::cursor
+            second_cursor;
+        typedef detail::set_index<first_cursor, Hash, KeyEqual>
+            set_index;
+
+        static_assert(std::is_same<
+                          typename std::remove_cv<typename first_cursor::element_type>::type,
+                          typename std::remove_cv<typename second_cursor::element_type>::type>::value,
+                      "union_with requires inputs with the same element type");
+
+    public:
+        class cursor
+        {
+        public:
+            typedef onepass_cursor_tag
+                cursor_category;
+            typedef typename first_cursor::element_type
+                element_type;
+            typedef typename std::conditional<
+                    std::is_same<typename first_cursor::reference_type, typename second_cursor::reference_type>::value,
+                    typename first_cursor::reference_type,
+                    element_type>::type
+                reference_type;
+
+            cursor(first_cursor first, second_cursor second, std::shared_ptr<typename set_index::type> seen)
+            : first(std::move(first)), second(std::move(second)), seen(std::move(seen)), begin(true)
+            {
+                skip_seen();
+            }
+
+            void forget() { begin = true; }
+            bool atbegin() const { return begin; }
+            bool empty() const { return first.empty() && second.empty(); }
+            void inc() {
+                if (!first.empty()) {
+                    first.inc();
+                } else {
+                    second.inc();
+                }
+                begin = false;
+                skip_seen();
+            }
+            reference_type get() const { return !first.empty() ? first.get() : second.get(); }
+
+        private:
+            void skip_seen() {
+                for (; !first.empty(); first.inc()) {
+                    if (seen->insert(first.get()).second) {
+                        return;
+                    }
+                }
+                for (; !second.empty(); second.inc()) {
+                    if (seen->insert(second.get()).second) {
+                        return;
+                    }
+                }
+            }
+
+            first_cursor first;
+            second_cursor second;
+            std::shared_ptr<typename set_index::type> seen;
+            bool begin;
+        };
+
+        linq_union(const Collection& c, const Second& s, Hash hash, KeyEqual eq, std::size_t capacity)
+        : c(c), s(s), hash(std::move(hash)), eq(std::move(eq)), capacity(capacity)
+        {
+        }
+
+        cursor get_cursor() const {
+            return cursor(c.get_cursor(), s.get_cursor(), set_index::make(hash, eq, capacity));
+        }
+
+    private:
+        Collection c;
+        Second s;
+        Hash hash;
+        KeyEqual eq;
+        std::size_t capacity;
+    };
+
+    // the distinct elements of the first input that are also in the second. The
+    //   second input is indexed when the cursor is created.
+    template <class Collection, class Second, class Hash, class KeyEqual>
+    class linq_intersect
+    {
+        typedef typename Collection::cursor
+            inner_cursor;
+        typedef detail::set_index<inner_cursor, Hash, KeyEqual>
+            set_index;
+
+        struct state
+        {
+            std::shared_ptr<typename set_index::type> index;
+            std::vector<bool> yielded;
+        };
+
+    public:
+        class cursor
+        {
+        public:
+            typedef onepass_cursor_tag
+                cursor_category;
+            typedef typename inner_cursor::element_type
+                element_type;
+            typedef typename inner_cursor::reference_type
+                reference_type;
+
+            cursor(inner_cursor cur, std::shared_ptr<state> matches)
+            : cur(std::move(cur)), matches(std::move(matches)), begin(true)
+            {
+                skip_unmatched();
+            }
+
+            void forget() { begin = true; }
+            bool atbegin() const { return begin; }
+            bool empty() const { return cur.empty(); }
+            void inc() {
+                cur.inc();
+                begin = false;
+                skip_unmatched();
+            }
+            reference_type get() const { return cur.get(); }
+
+        private:
+            void skip_unmatched() {
+                for (; !cur.empty(); cur.inc()) {
+                    const std::size_t id = matches->index->find(cur.get());
+                    if (id != set_index::type::npos && !matches->yielded[id]) {
+                        matches->yielded[id] = true;
+                        return;
+                    }
+                }
+            }
+
+            inner_cursor cur;
+            std::shared_ptr<state> matches;
+            bool begin;
+        };
+
+        linq_intersect(const Collection& c, const Second& s, Hash hash, KeyEqual eq, std::size_t capacity)
+        : c(c), s(s), hash(std::move(hash)), eq(std::move(eq)), capacity(capacity)
+        {
+        }
+
+        cursor get_cursor() const {
+            auto matches = std::make_shared<state>();
+            matches->index = set_index::make(s.get_cursor(), hash, eq, capacity);
+            matches->yielded.resize(matches->index->size());
+            return cursor(c.get_cursor(), std::move(matches));
+        }
+
+    private:
+        Collection c;
+        Second s;
+        Hash hash;
+        KeyEqual eq;
+        std::size_t capacity;
+    };
+
+    // the distinct elements of the first input that are not in the second. The
+    //   second input is indexed when the cursor is created.
+    template <class Collection, class Second, class Hash, class KeyEqual>
+    class linq_except
+    {
+        typedef typename Collection::cursor
+            inner_cursor;
+        typedef detail::set_index<inner_cursor, Hash, KeyEqual>
+            set_index;
+
+    public:
+        // yields the elements that can be inserted into the index of the second input
+        typedef typename linq_distinct<Collection, Hash, KeyEqual>::cursor
+            cursor;
+
+        linq_except(const Collection& c, const Second& s, Hash hash, KeyEqual eq, std::size_t capacity)
+        : c(c), s(s), hash(std::move(hash)), eq(std::move(eq)), capacity(capacity)
+        {
+        }
+
+        cursor get_cursor() const {
+            return cursor(c.get_cursor(), set_index::make(s.get_cursor(), hash, eq, capacity));
+        }
+
+    private:
+        Collection c;
+        Second s;
+        Hash hash;
+        KeyEqual eq;
+        std::size_t capacity;
+    };
+}
+
+#endif // !defined(CPPLINQ_LINQ_DISTINCT_HPP)
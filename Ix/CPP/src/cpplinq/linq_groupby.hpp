@@ -14,6 +14,9 @@ struct group
     Iter start;
     Iter fin;
 
+    // keeps the grouping that owns the elements alive after the cursor is gone
+    std::shared_ptr<const void> storage;
+
     typedef Iter iterator;
     typedef Iter const_iterator;
 
@@ -42,9 +45,28 @@ struct default_less
     }
 };
 
-// progressively constructs grouping as user iterates over groups and elements
-//   within each group. Performs this task by building a std::list of element 
-//   iterators with equal elements within each group.
+// the index that assigns group ids. keys are hashed unless the default Hash
+//   is used with a key_type that std::hash does not support (other than pairs 
+//   and tuples), those keys are ordered with operator< instead.
+template <class Key, class Hash, class KeyEqual, 
+          bool Hashed = !std::is_same<Hash, util::default_hash>::value || util::is_hashable<Key>::value>
+struct groupby_index
+{
+    typedef util::flat_index<Key, Hash, KeyEqual> type;
+    static type make(const Hash& hash, const KeyEqual& eq) { return type(hash, eq); }
+};
+template <class Key, class Hash, class KeyEqual>
+struct groupby_index<Key, Hash, KeyEqual, false>
+{
+    typedef util::ordered_index<Key, default_less> type;
+    static type make(const Hash&, const KeyEqual&) { return type(); }
+};
+
+// constructs the grouping when the first group is requested, in two passes:
+//   the first pass buffers the elements and assigns each one a dense group id 
+//   through a flat hash index, the second pass places the elements into one 
+//   contiguous vector ordered by group (a counting sort on the group id). 
+//   Each group is then a pair of iterators into that vector.
 // 
 // invariants:
 //   - relative order of groups corresponds to relative order of each group's first 
@@ -53,83 +75,99 @@ struct default_less
 //     as they appeared in the input sequence.
 // 
 // requires:
-//   Iter must be a forward iterator.
-template <class Collection, class KeyFn, class Compare = default_less>
+//   key_type must be hashable with Hash and comparable with KeyEqual, or, with
+//   the default Hash, key_type may instead be ordered by operator<.
+// 
+// note: 
+//   the third template parameter was an ordering (Compare = default_less), it is 
+//   now the Hash. code that names linq_groupby<C, K, Compare> must change.
+template <class Collection, class KeyFn, class Hash = util::default_hash, class KeyEqual = default_equality>
 class linq_groupby
 {
     typedef typename Collection::cursor 
         inner_cursor;
 
-    typedef typename util::result_of<KeyFn(typename inner_cursor::element_type)>::type
+    typedef typename std::remove_cv<typename std::remove_reference<
+            typename util::result_of<KeyFn(typename inner_cursor::element_type)>::type>::type>::type
         key_type;
 
-    typedef std::list<typename inner_cursor::element_type>
-        element_list_type;
+    typedef std::vector<typename inner_cursor::element_type>
+        element_vector_type;
 
-    typedef group<typename element_list_type::iterator, key_type> 
+    typedef group<typename element_vector_type::iterator, key_type> 
         group_type;
 
-    typedef std::list<group_type>
-        group_list_type;
-
 private:
     struct impl_t
     {
-        // TODO: would be faster to use a chunked list, where
-        //   pointers are invalidated but iterators are not. Need 
-        //   benchmarks first
-
-        element_list_type                           elements;
-        std::list<group_type>                       groups;
-        std::map<key_type, group_type*, Compare>    groupIndex;
+        element_vector_type                             elements;
+        std::vector<group_type>                         groups;
 
+        util::maybe<inner_cursor>                       source;
+        KeyFn                                           keySelector;
+        Hash                                            hash;
+        KeyEqual                                        eq;
 
-
-        KeyFn keySelector;
-        Compare comp;
-        
         impl_t(inner_cursor cur,
                KeyFn keySelector,
-               Compare comp = Compare()) 
-        : keySelector(keySelector)
-        , groupIndex(comp)
+               Hash hash,
+               KeyEqual eq) 
+        : source(std::move(cur))
+        , keySelector(keySelector)
+        , hash(hash)
+        , eq(eq)
         {
-            // TODO: make lazy
-            insert_all(std::move(cur));
         }
 
-        void insert_all(inner_cursor cur)
+        void materialize()
         {
+            if (!source) {
+                return;
+            }
+            inner_cursor cur = std::move(*source);
+            source.reset();
+
+            typedef groupby_index<key_type, Hash, KeyEqual> index_type;
+            typename index_type::type index = index_type::make(hash, eq);
+            element_vector_type buffer;
+            std::vector<std::size_t> ids;
+            std::vector<std::size_t> counts;
+
+            // pass 1: buffer elements and assign group ids
             while(!cur.empty()) {
-                insert(cur.get());
+                buffer.push_back(cur.get());
+                auto id = index.insert(keySelector(buffer.back())).first;
+                if (id == counts.size()) {
+                    counts.push_back(0);
+                }
+                ++counts[id];
+                ids.push_back(id);
                 cur.inc();
             }
-        }
-        void insert(typename inner_cursor::reference_type element)
-        {
-            key_type key = keySelector(element);
-            auto groupPos = groupIndex.find(key);
-            if(groupPos == groupIndex.end()) {
-                // new group
-                bool firstGroup = groups.empty();
-
-                elements.push_back(element);
-                if(!firstGroup) {
-                    // pop new element out of previous group
-                    --groups.back().fin; 
-                }
-
-                // build new group
-                groups.push_back(group_type(key));
-                group_type& newGroup = groups.back();
 
-                groupIndex.insert( std::make_pair(key, &newGroup) );
+            // pass 2: stable placement by group id
+            std::vector<std::size_t> offsets(counts.size());
+            std::size_t offset = 0;
+            for (std::size_t id = 0; id != counts.size(); ++id) {
+                offsets[id] = offset;
+                offset += counts[id];
+            }
+            std::vector<std::size_t> order(buffer.size());
+            for (std::size_t i = 0; i != buffer.size(); ++i) {
+                order[offsets[ids[i]]++] = i;
+            }
+            elements.reserve(buffer.size());
+            for (std::size_t i = 0; i != order.size(); ++i) {
+                elements.push_back(std::move(buffer[order[i]]));
+            }
 
-                newGroup.fin = elements.end();
-                --(newGroup.start = newGroup.fin);
-            } else {
-                // add to existing group at end
-                elements.insert(groupPos->second->end(), element);
+            groups.reserve(index.size());
+            auto start = elements.begin();
+            for (std::size_t id = 0; id != index.size(); ++id) {
+                groups.push_back(group_type(index.key(id)));
+                groups.back().start = start;
+                start += counts[id];
+                groups.back().fin = start;
             }
         }
     };
@@ -147,46 +185,51 @@ public:
 
         cursor(inner_cursor   cur, 
                KeyFn          keyFn,
-               Compare        comp = Compare()) 
+               Hash           hash = Hash(),
+               KeyEqual       eq = KeyEqual()) 
+        : impl(std::make_shared<impl_t>(std::move(cur), keyFn, hash, eq))
+        , pos(0)
         {
-            impl.reset(new impl_t(cur, keyFn, comp));
-            inner   = impl->groups.begin();
-            fin     = impl->groups.end();
         }
 
         void forget() { } // nop on forward-only cursors
         bool empty() const {
-            return inner == fin;
+            impl->materialize();
+            return pos == impl->groups.size();
         }
         void inc() {
-            if (inner == fin) {
+            if (empty()) {
                 throw std::logic_error("attempt to iterate past end of range");
             }
-            ++inner;
+            ++pos;
         }
         reference_type get() const {
-            return *inner;
+            impl->materialize();
+            reference_type result = impl->groups[pos];
+            result.storage = impl;
+            return result;
         }
         
     private:
         std::shared_ptr<impl_t> impl;
-        typename std::list<group_type>::iterator inner;
-        typename std::list<group_type>::iterator fin;
+        std::size_t pos;
     };
 
     linq_groupby(Collection     c, 
                  KeyFn          keyFn,
-                 Compare        comp = Compare()) 
-    : c(c), keyFn(keyFn), comp(comp)
+                 Hash           hash = Hash(),
+                 KeyEqual       eq = KeyEqual()) 
+    : c(c), keyFn(keyFn), hash(hash), eq(eq)
     {
     }
 
-    cursor get_cursor() const { return cursor(c.get_cursor(), keyFn, comp); }
+    cursor get_cursor() const { return cursor(c.get_cursor(), keyFn, hash, eq); }
 
 private:
     Collection c;
     KeyFn keyFn;
-    Compare comp;
+    Hash hash;
+    KeyEqual eq;
 };
 
 }
@@ -111,10 +111,16 @@ namespace cpplinq {
         return iter_range<Iter>(start, finish);
     }
 
-    // decays into a onepass/forward iterator
+    // decays into a onepass/forward iterator. the end iterator carries no cursor, so
+    //   random access cursors are not exposed as random access iterators; instead
+    //   operator+= and the linq_driver element accessors dispatch on cursor_category.
+    //   onepass cursors are input iterators, so algorithms traverse them only once.
     template <class Cursor>
     class cursor_iterator 
-        : public std::iterator<std::forward_iterator_tag, 
+        : public std::iterator<typename std::conditional<
+                    std::is_convertible<typename Cursor::cursor_category, forward_cursor_tag>::value,
+                    std::forward_iterator_tag,
+                    std::input_iterator_tag>::type, 
                 typename Cursor::element_type,
                 std::ptrdiff_t,
                 typename std::conditional<std::is_reference<typename Cursor::reference_type>::value,
@@ -152,7 +158,7 @@ namespace cpplinq {
         }
 
         cursor_iterator& operator+=(std::ptrdiff_t n) {
-            cur->skip(n);
+            advance(n, typename Cursor::cursor_category());
 
             if (cur->empty()) { cur.reset(); }
             return *this;
@@ -162,7 +168,18 @@ namespace cpplinq {
         
     private:
         bool empty() const {
-            !cur || cur->empty();
+            return !cur || cur->empty();
+        }
+
+        void advance(std::ptrdiff_t n, onepass_cursor_tag) {
+            while (n-- > 0 && !cur->empty()) {
+                cur->inc();
+            }
+        }
+
+        void advance(std::ptrdiff_t n, random_access_cursor_tag) {
+            std::ptrdiff_t rem = cur->size() - cur->position();
+            cur->skip(n < rem ? n : rem);
         }
 
         util::maybe<Cursor> cur;
@@ -0,0 +1,420 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#if !defined(CPPLINQ_LINQ_JOIN_HPP)
+#define CPPLINQ_LINQ_JOIN_HPP
+#pragma once
+
+#include <cstddef>
+
+namespace cpplinq
+{
+    namespace detail
+    {
+        // the inner elements of a join, bucketed by key. Each key gets a dense id
+        //   from a flat_index, and the elements of each bucket are stored contiguously
+        //   in input order (counting sort on the id).
+        template <class InnerCursor, class InnerKeyFn, class Hash, class KeyEqual>
+        struct join_lookup
+        {
+            typedef typename InnerCursor::element_type
+                element_type;
+            typedef typename std::decay<typename util::result_of<InnerKeyFn(const element_type&)>::type>::type
+                key_type;
+            typedef std::vector<element_type>
+                element_vector_type;
+            typedef typename element_vector_type::const_iterator
+                iterator;
+
+            static const std::size_t npos = static_cast<std::size_t>(-1);
+
+            util::flat_index<key_type, Hash, KeyEqual>  index;
+            std::vector<std::size_t>                    offsets;
+            element_vector_type                         elements;
+            // the id of the key of each outer element, in order, when the index is
+            //   built over the outer keys, so that they are not computed again
+            std::vector<std::size_t>                    outer_ids;
+
+            join_lookup(Hash hash, KeyEqual eq) : index(std::move(hash), std::move(eq)) {}
+
+            // indexes every inner element
+            void insert_all(InnerCursor cur, const InnerKeyFn& keyFn)
+            {
+                element_vector_type buffer;
+                std::vector<std::size_t> ids;
+                for (; !cur.empty(); cur.inc()) {
+                    buffer.push_back(cur.get());
+                    ids.push_back(index.insert(keyFn(buffer.back())).first);
+                }
+                place(buffer, ids);
+            }
+
+            // indexes only the inner elements whose key is one of the given outer keys.
+            //   used when the outer side is the smaller one, so that the index is built
+            //   over the outer keys and the inner side is only streamed.
+            template <class OuterCursor, class OuterKeyFn>
+            void insert_matching(OuterCursor outer, const OuterKeyFn& outerKeyFn, InnerCursor cur, const InnerKeyFn& keyFn)
+            {
+                for (; !outer.empty(); outer.inc()) {
+                    outer_ids.push_back(index.insert(outerKeyFn(outer.get())).first);
+                }
+                element_vector_type buffer;
+                std::vector<std::size_t> ids;
+                for (; !cur.empty(); cur.inc()) {
+                    auto&& value = cur.get();
+                    auto id = index.find(keyFn(value));
+                    if (id != index.npos) {
+                        buffer.push_back(value);
+                        ids.push_back(id);
+                    }
+                }
+                place(buffer, ids);
+            }
+
+            template <class Key>
+            std::pair<iterator, iterator> find(const Key& key) const
+            {
+                auto id = index.find(key);
+                if (id == index.npos) {
+                    return std::make_pair(elements.end(), elements.end());
+                }
+                return bucket(id);
+            }
+
+            std::pair<iterator, iterator> bucket(std::size_t id) const
+            {
+                return std::make_pair(elements.begin() + offsets[id], elements.begin() + offsets[id + 1]);
+            }
+
+            // the id of the key of the outer element at ordinal, or npos when the
+            //   index was built over the inner keys
+            std::size_t outer_id(std::size_t ordinal) const
+            {
+                return outer_ids.empty() ? npos : outer_ids[ordinal];
+            }
+
+        private:
+            void place(element_vector_type& buffer, const std::vector<std::size_t>& ids)
+            {
+                offsets.assign(index.size() + 1, 0);
+                for (auto id : ids) {
+                    ++offsets[id + 1];
+                }
+                for (std::size_t id = 0; id != index.size(); ++id) {
+                    offsets[id + 1] += offsets[id];
+                }
+                std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+                std::vector<std::size_t> order(buffer.size());
+                for (std::size_t i = 0; i != buffer.size(); ++i) {
+                    order[next[ids[i]]++] = i;
+                }
+                elements.reserve(buffer.size());
+                for (auto i : order) {
+                    elements.push_back(std::move(buffer[i]));
+                }
+            }
+        };
+
+        template <class Lookup, class OuterCursor, class InnerCursor, class OuterKeyFn, class InnerKeyFn>
+        void join_build_(Lookup& lookup, const OuterCursor&, InnerCursor inner, const OuterKeyFn&, const InnerKeyFn& innerKeyFn, onepass_cursor_tag)
+        {
+            lookup.insert_all(std::move(inner), innerKeyFn);
+        }
+
+        // both sides know their size: index the smaller one
+        template <class Lookup, class OuterCursor, class InnerCursor, class OuterKeyFn, class InnerKeyFn>
+        void join_build_(Lookup& lookup, const OuterCursor& outer, InnerCursor inner, const OuterKeyFn& outerKeyFn, const InnerKeyFn& innerKeyFn, random_access_cursor_tag)
+        {
+            if (outer.size() - outer.position() < inner.size() - inner.position()) {
+                lookup.insert_matching(outer, outerKeyFn, std::move(inner), innerKeyFn);
+            } else {
+                lookup.insert_all(std::move(inner), innerKeyFn);
+            }
+        }
+
+        template <class Lookup, class OuterCursor, class InnerCursor, class OuterKeyFn, class InnerKeyFn>
+        std::shared_ptr<const Lookup> join_lookup_(const OuterCursor& outer, InnerCursor inner, const OuterKeyFn& outerKeyFn, const InnerKeyFn& innerKeyFn, Lookup lookup)
+        {
+            typedef typename util::min_cursor_category<
+                    typename OuterCursor::cursor_category,
+                    typename InnerCursor::cursor_category,
+                    random_access_cursor_tag>::type
+                category;
+            join_build_(lookup, outer, std::move(inner), outerKeyFn, innerKeyFn, category());
+            return std::make_shared<const Lookup>(std::move(lookup));
+        }
+    }
+
+    // for each outer element, in order, yields result(outer, inner) for every inner
+    //   element with an equal key, in order. The lookup is built when the cursor is
+    //   created, then the outer side is streamed.
+    template <class Collection, class InnerCollection, class OuterKeyFn, class InnerKeyFn, class ResultFn, class Hash, class KeyEqual>
+    class linq_join
+    {
+        typedef typename Collection::cursor
+            outer_cursor;
+        typedef typename InnerCollection::cursor
+            inner_cursor;
+        typedef detail::join_lookup<inner_cursor, InnerKeyFn, Hash, KeyEqual>
+            lookup_type;
+
+    public:
+        class cursor
+        {
+        public:
+            typedef typename util::min_cursor_category<
+                    typename outer_cursor::cursor_category,
+                    forward_cursor_tag>::type
+                cursor_category;
+            typedef typename util::result_of<ResultFn(typename outer_cursor::reference_type, const typename lookup_type::element_type&)>::type
+                reference_type;
+            typedef typename std::remove_cv<typename std::remove_reference<reference_type>::type>::type
+                element_type;
+
+            cursor(outer_cursor outer, std::shared_ptr<const lookup_type> lookup, const OuterKeyFn& outerKeyFn, const ResultFn& resultFn)
+            : outer(std::move(outer)), lookup(std::move(lookup)), ordinal(0), current(), fin(), outerKeyFn(outerKeyFn), resultFn(resultFn)
+            {
+                seek();
+            }
+
+            void forget() { outer.forget(); }
+            bool empty() const { return outer.empty(); }
+            void inc() {
+                if (++current == fin) {
+                    outer.inc();
+                    ++ordinal;
+                    seek();
+                }
+            }
+            reference_type get() const { return resultFn(outer.get(), *current); }
+
+        private:
+            // moves to the next outer element that has matches
+            void seek() {
+                for (; !outer.empty(); outer.inc(), ++ordinal) {
+                    auto id = lookup->outer_id(ordinal);
+                    auto range = id == lookup_type::npos ? lookup->find(outerKeyFn(outer.get())) : lookup->bucket(id);
+                    if (range.first != range.second) {
+                        current = range.first;
+                        fin = range.second;
+                        return;
+                    }
+                }
+            }
+
+            outer_cursor                        outer;
+            std::shared_ptr<const lookup_type>  lookup;
+            std::size_t                         ordinal;
+            typename lookup_type::iterator      current, fin;
+            OuterKeyFn                          outerKeyFn;
+            ResultFn                            resultFn;
+        };
+
+        linq_join(const Collection& c, const InnerCollection& inner, OuterKeyFn outerKeyFn, InnerKeyFn innerKeyFn, ResultFn resultFn, Hash hash, KeyEqual eq)
+        : c(c), inner(inner), outerKeyFn(std::move(outerKeyFn)), innerKeyFn(std::move(innerKeyFn)), resultFn(std::move(resultFn)), hash(std::move(hash)), eq(std::move(eq))
+        {
+        }
+
+        cursor get_cursor() const {
+            auto outer = c.get_cursor();
+            auto lookup = detail::join_lookup_(outer, inner.get_cursor(), outerKeyFn, innerKeyFn, lookup_type(hash, eq));
+            return cursor(std::move(outer), std::move(lookup), outerKeyFn, resultFn);
+        }
+
+    private:
+        Collection      c;
+        InnerCollection inner;
+        OuterKeyFn      outerKeyFn;
+        InnerKeyFn      innerKeyFn;
+        ResultFn        resultFn;
+        Hash            hash;
+        KeyEqual        eq;
+    };
+
+    // for each outer element, in order, yields result(outer, group) where group is the
+    //   (possibly empty) range of inner elements with an equal key.
+    template <class Collection, class InnerCollection, class OuterKeyFn, class InnerKeyFn, class ResultFn, class Hash, class KeyEqual>
+    class linq_group_join
+    {
+        typedef typename Collection::cursor
+            outer_cursor;
+        typedef typename InnerCollection::cursor
+            inner_cursor;
+        typedef detail::join_lookup<inner_cursor, InnerKeyFn, Hash, KeyEqual>
+            lookup_type;
+
+    public:
+        typedef group<typename lookup_type::iterator, typename lookup_type::key_type>
+            group_type;
+
+        class cursor
+        {
+        public:
+            typedef typename util::min_cursor_category<
+                    typename outer_cursor::cursor_category,
+                    forward_cursor_tag>::type
+                cursor_category;
+            typedef typename util::result_of<ResultFn(typename outer_cursor::reference_type, const group_type&)>::type
+                reference_type;
+            typedef typename std::remove_cv<typename std::remove_reference<reference_type>::type>::type
+                element_type;
+
+            cursor(outer_cursor outer, std::shared_ptr<const lookup_type> lookup, const OuterKeyFn& outerKeyFn, const ResultFn& resultFn)
+            : outer(std::move(outer)), lookup(std::move(lookup)), ordinal(0), outerKeyFn(outerKeyFn), resultFn(resultFn)
+            {
+            }
+
+            void forget() { outer.forget(); }
+            bool empty() const { return outer.empty(); }
+            void inc() { outer.inc(); ++ordinal; }
+            reference_type get() const {
+                auto&& value = outer.get();
+                auto id = lookup->outer_id(ordinal);
+                group_type g(id == lookup_type::npos ? typename lookup_type::key_type(outerKeyFn(value)) : lookup->index.key(id));
+                auto range = id == lookup_type::npos ? lookup->find(g.key) : lookup->bucket(id);
+                g.start = range.first;
+                g.fin = range.second;
+                g.storage = lookup;
+                return resultFn(value, g);
+            }
+
+        private:
+            outer_cursor                        outer;
+            std::shared_ptr<const lookup_type>  lookup;
+            std::size_t                         ordinal;
+            OuterKeyFn                          outerKeyFn;
+            ResultFn                            resultFn;
+        };
+
+        linq_group_join(const Collection& c, const InnerCollection& inner, OuterKeyFn outerKeyFn, InnerKeyFn innerKeyFn, ResultFn resultFn, Hash hash, KeyEqual eq)
+        : c(c), inner(inner), outerKeyFn(std::move(outerKeyFn)), innerKeyFn(std::move(innerKeyFn)), resultFn(std::move(resultFn)), hash(std::move(hash)), eq(std::move(eq))
+        {
+        }
+
+        cursor get_cursor() const {
+            auto outer = c.get_cursor();
+            auto lookup = detail::join_lookup_(outer, inner.get_cursor(), outerKeyFn, innerKeyFn, lookup_type(hash, eq));
+            return cursor(std::move(outer), std::move(lookup), outerKeyFn, resultFn);
+        }
+
+    private:
+        Collection      c;
+        InnerCollection inner;
+        OuterKeyFn      outerKeyFn;
+        InnerKeyFn      innerKeyFn;
+        ResultFn        resultFn;
+        Hash            hash;
+        KeyEqual        eq;
+    };
+
+    // join over two inputs that are both sorted by key (ascending according to Less).
+    //   No lookup is built: both sides are streamed, and the inner cursor is copied at
+    //   the start of each run of equal keys so that it can be replayed for every outer
+    //   element with that key.
+    template <class Collection, class InnerCollection, class OuterKeyFn, class InnerKeyFn, class ResultFn, class Less>
+    class linq_merge_join
+    {
+        typedef typename Collection::cursor
+            outer_cursor;
+        typedef typename InnerCollection::cursor
+            inner_cursor;
+        typedef typename std::decay<typename util::result_of<OuterKeyFn(typename outer_cursor::reference_type)>::type>::type
+            key_type;
+
+    public:
+        class cursor
+        {
+        public:
+            typedef typename util::min_cursor_category<
+                    typename outer_cursor::cursor_category,
+                    forward_cursor_tag>::type
+                cursor_category;
+            typedef typename util::result_of<ResultFn(typename outer_cursor::reference_type, typename inner_cursor::reference_type)>::type
+                reference_type;
+            typedef typename std::remove_cv<typename std::remove_reference<reference_type>::type>::type
+                element_type;
+
+            cursor(outer_cursor outer, inner_cursor inner, const OuterKeyFn& outerKeyFn, const InnerKeyFn& innerKeyFn, const ResultFn& resultFn, const Less& less)
+            : outer(std::move(outer)), run(std::move(inner)), current(*run)
+            , outerKeyFn(outerKeyFn), innerKeyFn(innerKeyFn), resultFn(resultFn), less(less)
+            {
+                seek();
+            }
+
+            void forget() { outer.forget(); }
+            bool empty() const { return !key; }
+            void inc() {
+                current->inc();
+                if (!current->empty() && !less(*key, innerKeyFn(current->get()))) {
+                    return;
+                }
+                // end of the inner run for this outer element
+                outer.inc();
+                if (!outer.empty()) {
+                    key_type next = outerKeyFn(outer.get());
+                    if (!less(*key, next)) {
+                        // same key as before: replay the run
+                        key.set(std::move(next));
+                        assign(current, *run);
+                        return;
+                    }
+                }
+                assign(run, *current);
+                seek();
+            }
+            reference_type get() const { return resultFn(outer.get(), current->get()); }
+
+        private:
+            // cursors are copy constructible but not necessarily assignable (they may hold lambdas)
+            static void assign(util::maybe<inner_cursor>& target, const inner_cursor& source) {
+                target.reset();
+                target.set(source);
+            }
+
+            // advances both sides to the next pair of equal keys
+            void seek() {
+                key.reset();
+                while (!outer.empty() && !run->empty()) {
+                    key_type outerKey = outerKeyFn(outer.get());
+                    auto&& innerKey = innerKeyFn(run->get());
+                    if (less(outerKey, innerKey)) {
+                        outer.inc();
+                    } else if (less(innerKey, outerKey)) {
+                        run->inc();
+                    } else {
+                        key.set(std::move(outerKey));
+                        assign(current, *run);
+                        return;
+                    }
+                }
+            }
+
+            outer_cursor                outer;
+            util::maybe<inner_cursor>   run;
+            util::maybe<inner_cursor>   current;
+            util::maybe<key_type>   key;
+            OuterKeyFn              outerKeyFn;
+            InnerKeyFn              innerKeyFn;
+            ResultFn                resultFn;
+            Less                    less;
+        };
+
+        linq_merge_join(const Collection& c, const InnerCollection& inner, OuterKeyFn outerKeyFn, InnerKeyFn innerKeyFn, ResultFn resultFn, Less less)
+        : c(c), inner(inner), outerKeyFn(std::move(outerKeyFn)), innerKeyFn(std::move(innerKeyFn)), resultFn(std::move(resultFn)), less(std::move(less))
+        {
+        }
+
+        cursor get_cursor() const {
+            return cursor(c.get_cursor(), inner.get_cursor(), outerKeyFn, innerKeyFn, resultFn, less);
+        }
+
+    private:
+        Collection      c;
+        InnerCollection inner;
+        OuterKeyFn      outerKeyFn;
+        InnerKeyFn      innerKeyFn;
+        ResultFn        resultFn;
+        Less            less;
+    };
+}
+
+#endif // !defined(CPPLINQ_LINQ_JOIN_HPP)
@@ -41,7 +41,7 @@ namespace cpplinq {
         linq_last_(Cursor c, random_access_cursor_tag)
     {
         if (c.empty()) { throw std::logic_error("last() out of bounds"); }
-        c.skip(c.size()-1);
+        c.skip(c.size() - c.position() - 1);
         return c.get();
     }
 
@@ -76,7 +76,7 @@ namespace cpplinq {
         linq_last_or_default_(Cursor c, random_access_cursor_tag)
     {
         if (c.empty()) { return typename Cursor::element_type(); }
-        c.skip(c.size()-1);
+        c.skip(c.size() - c.position() - 1);
         return c.get();
     }
 
@@ -0,0 +1,373 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#if !defined(CPPLINQ_LINQ_MMAP_HPP)
+#define CPPLINQ_LINQ_MMAP_HPP
+#pragma once
+
+// memory mapped file sources. Not included by linq.hpp, since it pulls in the
+//   platform headers:
+//
+//   #include "cpplinq/linq_mmap.hpp"
+//
+//   auto errors = cpplinq::from_mapped_lines("server.log")
+//       .where([](cpplinq::string_view line){ return line.size() > 5 && line[0] == 'E'; })
+//       .count();
+
+#include "linq.hpp"
+
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <system_error>
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L
+#include <string_view>
+#define CPPLINQ_HAS_STRING_VIEW 1
+#endif
+
+namespace cpplinq
+{
+#if defined(CPPLINQ_HAS_STRING_VIEW)
+    typedef std::string_view string_view;
+#else
+    // the subset of std::string_view used by the mapped sources
+    class string_view
+    {
+        const char* first;
+        std::size_t length;
+
+    public:
+        typedef const char* iterator;
+        typedef const char* const_iterator;
+        typedef char value_type;
+
+        string_view() : first(nullptr), length(0) {}
+        string_view(const char* s, std::size_t n) : first(s), length(n) {}
+        string_view(const char* s) : first(s), length(std::strlen(s)) {}
+        string_view(const std::string& s) : first(s.data()), length(s.size()) {}
+
+        const char* data() const { return first; }
+        std::size_t size() const { return length; }
+        bool empty() const { return length == 0; }
+        const char* begin() const { return first; }
+        const char* end() const { return first + length; }
+        char operator[](std::size_t i) const { return first[i]; }
+
+        string_view substr(std::size_t pos, std::size_t n = static_cast<std::size_t>(-1)) const {
+            if (pos > length) {
+                throw std::out_of_range("string_view::substr");
+            }
+            return string_view(first + pos, n < length - pos ? n : length - pos);
+        }
+
+        int compare(string_view other) const {
+            const std::size_t n = length < other.length ? length : other.length;
+            const int c = n ? std::memcmp(first, other.first, n) : 0;
+            return c != 0 ? c : (length < other.length ? -1 : (length > other.length ? 1 : 0));
+        }
+
+        explicit operator std::string() const { return std::string(first, length); }
+    };
+
+    inline bool operator==(string_view a, string_view b) { return a.size() == b.size() && a.compare(b) == 0; }
+    inline bool operator!=(string_view a, string_view b) { return !(a == b); }
+    inline bool operator<(string_view a, string_view b) { return a.compare(b) < 0; }
+    inline bool operator>(string_view a, string_view b) { return b < a; }
+    inline bool operator<=(string_view a, string_view b) { return !(b < a); }
+    inline bool operator>=(string_view a, string_view b) { return !(a < b); }
+
+    inline std::ostream& operator<<(std::ostream& os, string_view s) {
+        return os.write(s.data(), s.size());
+    }
+#endif
+
+    // a read only mapping of a whole file
+    class mapped_file
+    {
+        const char* first;
+        std::size_t length;
+#if defined(_WIN32)
+        HANDLE file;
+        HANDLE mapping;
+#endif
+
+        mapped_file(const mapped_file&);
+        mapped_file& operator=(const mapped_file&);
+
+#if defined(_WIN32)
+        static void fail(const std::string& what) {
+            throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(), what);
+        }
+#else
+        static void fail(const std::string& what) {
+            throw std::system_error(errno, std::system_category(), what);
+        }
+#endif
+
+    public:
+        explicit mapped_file(const std::string& path)
+        : first(nullptr)
+        , length(0)
+#if defined(_WIN32)
+        , file(INVALID_HANDLE_VALUE)
+        , mapping(nullptr)
+#endif
+        {
+#if defined(_WIN32)
+            file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                fail("mapped_file: cannot open " + path);
+            }
+            LARGE_INTEGER size;
+            if (!::GetFileSizeEx(file, &size)) {
+                ::CloseHandle(file);
+                fail("mapped_file: cannot get the size of " + path);
+            }
+            length = static_cast<std::size_t>(size.QuadPart);
+            if (length) {
+                mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!mapping) {
+                    ::CloseHandle(file);
+                    fail("mapped_file: cannot map " + path);
+                }
+                first = static_cast<const char*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                if (!first) {
+                    ::CloseHandle(mapping);
+                    ::CloseHandle(file);
+                    fail("mapped_file: cannot map " + path);
+                }
+            }
+#else
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                fail("mapped_file: cannot open " + path);
+            }
+            struct stat st;
+            if (::fstat(fd, &st) != 0) {
+                const int e = errno;
+                ::close(fd);
+                errno = e;
+                fail("mapped_file: cannot get the size of " + path);
+            }
+            length = static_cast<std::size_t>(st.st_size);
+            if (length) {
+                void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p == MAP_FAILED) {
+                    const int e = errno;
+                    ::close(fd);
+                    errno = e;
+                    fail("mapped_file: cannot map " + path);
+                }
+                ::madvise(p, length, MADV_SEQUENTIAL);
+                first = static_cast<const char*>(p);
+            }
+            // the mapping stays valid after the descriptor is closed
+            ::close(fd);
+#endif
+        }
+
+        ~mapped_file() {
+#if defined(_WIN32)
+            if (first) { ::UnmapViewOfFile(first); }
+            if (mapping) { ::CloseHandle(mapping); }
+            if (file != INVALID_HANDLE_VALUE) { ::CloseHandle(file); }
+#else
+            if (first) { ::munmap(const_cast<char*>(first), length); }
+#endif
+        }
+
+        const char* data() const { return first; }
+        std::size_t size() const { return length; }
+    };
+
+    // the lines of a mapped file, without their '\n' or "\r\n" terminator. The
+    //   views point into the mapping, which is kept alive by the collection and
+    //   by each cursor, so a cursor may outlive the query it came from.
+    class linq_mapped_lines
+    {
+    public:
+        class cursor
+        {
+        public:
+            typedef forward_cursor_tag
+                cursor_category;
+            typedef string_view
+                element_type;
+            typedef string_view
+                reference_type;
+
+            explicit cursor(std::shared_ptr<const mapped_file> f)
+            : file(std::move(f))
+            , start(file->data())
+            , current(start)
+            , fin(start + file->size())
+            {
+                find_end();
+            }
+
+            void forget() { start = current; }
+            bool atbegin() const { return current == start; }
+            bool empty() const { return current == fin; }
+            void inc() {
+                if (current == fin)
+                    throw std::logic_error("inc past end");
+                current = line_end == fin ? fin : line_end + 1;
+                find_end();
+            }
+            reference_type get() const {
+                const char* last = line_end;
+                if (last != current && last[-1] == '\r') {
+                    --last;
+                }
+                return string_view(current, last - current);
+            }
+
+        private:
+            void find_end() {
+                line_end = current == fin ? fin : static_cast<const char*>(std::memchr(current, '\n', fin - current));
+                if (!line_end) {
+                    line_end = fin;
+                }
+            }
+
+            std::shared_ptr<const mapped_file> file;
+            const char* start;
+            const char* current;
+            const char* line_end;
+            const char* fin;
+        };
+
+        explicit linq_mapped_lines(std::shared_ptr<const mapped_file> file) : file(std::move(file)) {}
+
+        cursor get_cursor() const {
+            return cursor(file);
+        }
+
+    private:
+        std::shared_ptr<const mapped_file> file;
+    };
+
+    // the fixed size records of a mapped file, as views of record_size bytes. A
+    //   trailing partial record is ignored. Like the lines, each cursor keeps the
+    //   mapping alive.
+    class linq_mapped_records
+    {
+    public:
+        class cursor
+        {
+        public:
+            typedef random_access_cursor_tag
+                cursor_category;
+            typedef string_view
+                element_type;
+            typedef string_view
+                reference_type;
+
+            cursor(std::shared_ptr<const mapped_file> f, std::size_t record_size)
+            : file(std::move(f)), base(file->data()), record_size(record_size), start(0), current(0), fin(file->size() / record_size)
+            {
+            }
+
+            void forget() { start = current; }
+            bool empty() const { return current == fin; }
+            void inc() {
+                if (current == fin)
+                    throw std::logic_error("inc past end");
+                ++current;
+            }
+            reference_type get() const { return get(0); }
+
+            bool atbegin() const { return current == start; }
+            void dec() {
+                if (current == start)
+                    throw std::logic_error("dec past begin");
+                --current;
+            }
+
+            void skip(std::ptrdiff_t n) { current += n; }
+            reference_type get(std::ptrdiff_t n) const { return string_view(base + (current + n) * record_size, record_size); }
+            std::size_t size() const { return fin - start; }
+            std::size_t position() const { return current - start; }
+            void truncate(std::size_t n) {
+                if (n < fin - current) {
+                    fin = current + n;
+                }
+            }
+
+        private:
+            std::shared_ptr<const mapped_file> file;
+            const char* base;
+            std::size_t record_size;
+            std::size_t start, current, fin;
+        };
+
+        linq_mapped_records(std::shared_ptr<const mapped_file> file, std::size_t record_size)
+        : file(std::move(file)), record_size(record_size)
+        {
+            if (record_size == 0) {
+                throw std::logic_error("mapped records must not be empty");
+            }
+        }
+
+        cursor get_cursor() const {
+            return cursor(file, record_size);
+        }
+
+    private:
+        std::shared_ptr<const mapped_file> file;
+        std::size_t record_size;
+    };
+
+    inline linq_driver<linq_mapped_lines> from_mapped_lines(std::shared_ptr<const mapped_file> file)
+    {
+        return linq_mapped_lines(std::move(file));
+    }
+
+    inline linq_driver<linq_mapped_lines> from_mapped_lines(const std::string& path)
+    {
+        return from_mapped_lines(std::make_shared<mapped_file>(path));
+    }
+
+    inline linq_driver<linq_mapped_records> from_mapped_records(std::shared_ptr<const mapped_file> file, std::size_t record_size)
+    {
+        return linq_mapped_records(std::move(file), record_size);
+    }
+
+    inline linq_driver<linq_mapped_records> from_mapped_records(const std::string& path, std::size_t record_size)
+    {
+        return from_mapped_records(std::make_shared<mapped_file>(path), record_size);
+    }
+}
+
+#if !defined(CPPLINQ_HAS_STRING_VIEW)
+namespace std
+{
+    template <>
+    struct hash<cpplinq::string_view>
+    {
+        std::size_t operator()(cpplinq::string_view s) const {
+            // FNV-1a
+            std::size_t h = static_cast<std::size_t>(14695981039346656037ULL);
+            for (char c : s) {
+                h = (h ^ static_cast<unsigned char>(c)) * static_cast<std::size_t>(1099511628211ULL);
+            }
+            return h;
+        }
+    };
+}
+#endif
+
+#endif // !defined(CPPLINQ_LINQ_MMAP_HPP)
@@ -0,0 +1,317 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#if !defined(CPPLINQ_LINQ_ORDERBY_HPP)
+#define CPPLINQ_LINQ_ORDERBY_HPP
+#pragma once
+
+#include <cstddef>
+
+namespace cpplinq
+{
+    namespace detail
+    {
+        template <class Less>
+        struct descending
+        {
+            Less less;
+            descending(Less less = Less()) : less(std::move(less)) {}
+
+            template <class T>
+            bool operator()(const T& a, const T& b) const {
+                return less(b, a);
+            }
+        };
+
+        // the key of then_by(sel) is the pair (previous key, sel(x))
+        template <class First, class Second>
+        struct then_by_key
+        {
+            First first;
+            Second second;
+            then_by_key(First first, Second second) : first(std::move(first)), second(std::move(second)) {}
+
+            template <class T>
+            auto operator()(const T& x) const
+            -> std::pair<
+                typename std::decay<decltype(std::declval<const First&>()(x))>::type,
+                typename std::decay<decltype(std::declval<const Second&>()(x))>::type>
+            {
+                typedef std::pair<
+                    typename std::decay<decltype(std::declval<const First&>()(x))>::type,
+                    typename std::decay<decltype(std::declval<const Second&>()(x))>::type>
+                    key_type;
+                return key_type(first(x), second(x));
+            }
+        };
+
+        template <class FirstLess, class SecondLess>
+        struct then_by_less
+        {
+            FirstLess first;
+            SecondLess second;
+            then_by_less(FirstLess first, SecondLess second) : first(std::move(first)), second(std::move(second)) {}
+
+            template <class Pair>
+            bool operator()(const Pair& a, const Pair& b) const {
+                if (first(a.first, b.first)) return true;
+                if (first(b.first, a.first)) return false;
+                return second(a.second, b.second);
+            }
+        };
+    }
+
+    // sorts the input each time a cursor is created, so like the other operators it
+    //   reads the current contents of the source. Keys are extracted once per element
+    //   into a contiguous array of (key, index) pairs which is then sorted, and the
+    //   elements are moved into place afterwards. Ties are broken on the input index,
+    //   so the sort is stable. Copies of a cursor share the sorted elements. When only
+    //   the first n elements are wanted (order_by followed by take), a bounded heap of
+    //   n elements selects them in one pass, for O(N log n) time and O(n) memory.
+    template <class Collection, class KeySelector, class Less>
+    class linq_orderby
+    {
+        typedef typename Collection::cursor
+            inner_cursor;
+
+        typedef typename inner_cursor::element_type
+            value_type;
+
+        typedef typename std::decay<typename util::result_of<KeySelector(const value_type&)>::type>::type
+            key_type;
+
+        typedef std::vector<value_type>
+            element_vector_type;
+
+        struct keyed_index
+        {
+            key_type key;
+            std::size_t index;
+        };
+
+        struct keyed_less
+        {
+            const Less* less;
+            bool operator()(const keyed_index& a, const keyed_index& b) const {
+                if ((*less)(a.key, b.key)) return true;
+                if ((*less)(b.key, a.key)) return false;
+                return a.index < b.index;
+            }
+        };
+
+        // the heap entries of sort_first refer to a slot in a buffer of n elements
+        struct keyed_slot
+        {
+            keyed_index keyed;
+            std::size_t slot;
+        };
+
+        struct slot_less
+        {
+            keyed_less less;
+            bool operator()(const keyed_slot& a, const keyed_slot& b) const {
+                return less(a.keyed, b.keyed);
+            }
+        };
+
+        static std::shared_ptr<const element_vector_type> sort(inner_cursor cur, const KeySelector& sel, const Less& less)
+        {
+            element_vector_type buffer;
+            std::vector<keyed_index> keys;
+            for (; !cur.empty(); cur.inc()) {
+                buffer.push_back(cur.get());
+                keyed_index k = { sel(buffer.back()), buffer.size() - 1 };
+                keys.push_back(std::move(k));
+            }
+
+            keyed_less cmp = { &less };
+            std::sort(keys.begin(), keys.end(), cmp);
+
+            auto result = std::make_shared<element_vector_type>();
+            result->reserve(keys.size());
+            for (auto& k : keys) {
+                result->push_back(std::move(buffer[k.index]));
+            }
+            return result;
+        }
+
+        // the first n elements in order. The heap holds the n smallest elements seen 
+        //   so far with the largest on top, so each later element either replaces the 
+        //   top or is dropped.
+        static std::shared_ptr<const element_vector_type> sort_first(inner_cursor cur, const KeySelector& sel, const Less& less, std::size_t n)
+        {
+            auto result = std::make_shared<element_vector_type>();
+            if (n == 0) {
+                return result;
+            }
+
+            element_vector_type slots;
+            std::vector<keyed_slot> heap;
+            slot_less cmp = { { &less } };
+            for (std::size_t index = 0; !cur.empty(); cur.inc(), ++index) {
+                if (heap.size() < n) {
+                    slots.push_back(cur.get());
+                    keyed_slot k = { { sel(slots.back()), index }, slots.size() - 1 };
+                    heap.push_back(std::move(k));
+                    std::push_heap(heap.begin(), heap.end(), cmp);
+                    continue;
+                }
+                auto&& x = cur.get();
+                keyed_slot k = { { sel(x), index }, 0 };
+                if (!cmp(k, heap.front())) {
+                    continue;
+                }
+                std::pop_heap(heap.begin(), heap.end(), cmp);
+                k.slot = heap.back().slot;
+                slots[k.slot] = x;
+                heap.back() = std::move(k);
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+            std::sort_heap(heap.begin(), heap.end(), cmp);
+
+            result->reserve(heap.size());
+            for (auto& k : heap) {
+                result->push_back(std::move(slots[k.slot]));
+            }
+            return result;
+        }
+
+    public:
+        static const std::size_t unlimited = static_cast<std::size_t>(-1);
+
+        class cursor
+        {
+        public:
+            typedef value_type
+                element_type;
+            typedef element_type
+                reference_type;
+            typedef random_access_cursor_tag
+                cursor_category;
+
+            cursor(std::shared_ptr<const element_vector_type> s, std::size_t limit)
+            : sorted(std::move(s))
+            , start(0)
+            , current(0)
+            , fin(limit < sorted->size() ? limit : sorted->size())
+            {
+            }
+
+            void forget() { start = current; }
+            bool empty() const { return current == fin; }
+            void inc() {
+                if (current == fin)
+                    throw std::logic_error("inc past end");
+                ++current;
+            }
+            reference_type get() const { return (*sorted)[current]; }
+
+            bool atbegin() const { return current == start; }
+            void dec() {
+                if (current == start)
+                    throw std::logic_error("dec past begin");
+                --current;
+            }
+
+            void skip(std::ptrdiff_t n) { current += n; }
+            reference_type get(std::ptrdiff_t n) const { return (*sorted)[current + n]; }
+            std::size_t size() const { return fin - start; }
+            std::size_t position() const { return current - start; }
+            void truncate(std::size_t n) {
+                if (n < fin - current) {
+                    fin = current + n;
+                }
+            }
+
+        private:
+            std::shared_ptr<const element_vector_type> sorted;
+            std::size_t start, current, fin;
+        };
+
+        template <class ThenSelector, class ThenLess>
+        struct then_by_result
+        {
+            typedef linq_orderby<
+                    Collection,
+                    detail::then_by_key<KeySelector, ThenSelector>,
+                    detail::then_by_less<Less, ThenLess>>
+                type;
+        };
+
+        linq_orderby(const Collection& c, KeySelector sel, Less less)
+        : c(c), sel(std::move(sel)), less(std::move(less))
+        {
+        }
+
+        template <class ThenSelector, class ThenLess>
+        typename then_by_result<ThenSelector, ThenLess>::type
+            then_by(ThenSelector then_sel, ThenLess then_less) const
+        {
+            return typename then_by_result<ThenSelector, ThenLess>::type(
+                c,
+                detail::then_by_key<KeySelector, ThenSelector>(sel, std::move(then_sel)),
+                detail::then_by_less<Less, ThenLess>(less, std::move(then_less)));
+        }
+
+        cursor get_cursor() const
+        {
+            return cursor(sort(c.get_cursor(), sel, less), unlimited);
+        }
+
+        // a cursor over the first n elements
+        cursor get_cursor(std::size_t n) const
+        {
+            return cursor(sort_first(c.get_cursor(), sel, less, n), n);
+        }
+
+    private:
+        Collection c;
+        KeySelector sel;
+        Less less;
+    };
+
+    template <class Collection, class KeySelector, class Less>
+    const std::size_t linq_orderby<Collection, KeySelector, Less>::unlimited;
+
+    // the collection type produced by then_by(sel, less). Only order_by 
+    //   collections define then_by_result.
+    template <class Collection, class ThenSelector, class ThenLess>
+    struct then_by_traits
+    {
+        typedef typename Collection::template then_by_result<ThenSelector, ThenLess>::type type;
+    };
+
+    // order_by(...).take(n): only the first n elements are selected and sorted
+    template <class OrderBy>
+    class linq_orderby_take
+    {
+    public:
+        typedef typename OrderBy::cursor cursor;
+
+        linq_orderby_take(const OrderBy& o, std::size_t n) : o(o), n(n) {}
+
+        cursor get_cursor() const { return o.get_cursor(n); }
+
+        OrderBy o;
+        std::size_t n;
+    };
+
+    template <class Collection, class KeySelector, class Less>
+    struct take_traits<linq_orderby<Collection, KeySelector, Less>>
+    {
+        typedef linq_orderby_take<linq_orderby<Collection, KeySelector, Less>> type;
+        static type make(const linq_orderby<Collection, KeySelector, Less>& c, std::size_t n) {
+            return type(c, n);
+        }
+    };
+
+    template <class OrderBy>
+    struct take_traits<linq_orderby_take<OrderBy>>
+    {
+        typedef linq_orderby_take<OrderBy> type;
+        static type make(const linq_orderby_take<OrderBy>& c, std::size_t n) {
+            return type(c.o, n < c.n ? n : c.n);
+        }
+    };
+}
+
+#endif // !defined(CPPLINQ_LINQ_ORDERBY_HPP)
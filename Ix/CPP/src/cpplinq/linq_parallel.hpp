@@ -0,0 +1,475 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#if !defined(CPPLINQ_LINQ_PARALLEL_HPP)
+#define CPPLINQ_LINQ_PARALLEL_HPP
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace cpplinq
+{
+    template <class Collection>
+    class linq_driver;
+
+    // runs a task somewhere and returns immediately, or throws without running it.
+    //   The task may also be queued to the calling thread and run after the query:
+    //   the caller evaluates the chunks that have not started, and the task does
+    //   nothing once its chunk was taken. For instance, to run the chunks of a parallel query on an rxcpp event loop:
+    //
+    //   auto loop = rxcpp::observe_on_event_loop();
+    //   auto exec = [=](std::function<void()> task) {
+    //       auto w = loop.create_coordinator().get_worker();
+    //       w.schedule([=](const rxcpp::schedulers::schedulable&) { task(); });
+    //   };
+    //   from(v).parallel(4, exec).where(p).sum();
+    typedef std::function<void(std::function<void()>)> parallel_executor;
+
+    namespace detail
+    {
+        // the range [first, first + n) of a random access cursor. The chunks copy
+        //   one cursor, so a source that does work in get_cursor (order_by) does it once
+        template <class Collection>
+        struct parallel_chunk
+        {
+            typedef typename Collection::cursor cursor;
+
+            parallel_chunk(const cursor& whole, std::size_t first, std::size_t n) : whole(whole), first(first), n(n) {}
+
+            cursor get_cursor() const {
+                auto cur = whole;
+                cur.skip(first);
+                cur.forget();
+                cur.truncate(n);
+                return cur;
+            }
+
+            cursor whole;
+            std::size_t first, n;
+        };
+
+        // the operators applied to each chunk, composed as functions from one
+        //   linq_driver to the next
+        struct parallel_identity
+        {
+            template <class Driver>
+            Driver operator()(const Driver& d) const { return d; }
+        };
+
+        template <class Query, class Predicate>
+        struct parallel_where
+        {
+            Query query;
+            Predicate pred;
+            parallel_where(Query query, Predicate pred) : query(std::move(query)), pred(std::move(pred)) {}
+
+            template <class Driver>
+            auto operator()(const Driver& d) const
+            -> decltype(std::declval<const Query&>()(d).where(std::declval<const Predicate&>()))
+            {
+                return query(d).where(pred);
+            }
+        };
+
+        template <class Query, class Selector>
+        struct parallel_select
+        {
+            Query query;
+            Selector sel;
+            parallel_select(Query query, Selector sel) : query(std::move(query)), sel(std::move(sel)) {}
+
+            template <class Driver>
+            auto operator()(const Driver& d) const
+            -> decltype(std::declval<const Query&>()(d).select(std::declval<const Selector&>()))
+            {
+                return query(d).select(sel);
+            }
+        };
+
+        // the threads that run the chunks of parallel queries that have no executor.
+        //   The pool is created on first use, with one thread per core, and joined at exit.
+        class parallel_pool
+        {
+            std::mutex lock;
+            std::condition_variable ready;
+            std::deque<std::function<void()>> tasks;
+            std::vector<std::thread> threads;
+            bool stopping;
+
+            void stop() {
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    stopping = true;
+                }
+                ready.notify_all();
+                for (auto& t : threads) {
+                    t.join();
+                }
+            }
+
+            void work() {
+                for (;;) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> guard(lock);
+                        ready.wait(guard, [this]{ return stopping || !tasks.empty(); });
+                        if (tasks.empty()) {
+                            return;
+                        }
+                        task = std::move(tasks.front());
+                        tasks.pop_front();
+                    }
+                    task();
+                }
+            }
+
+        public:
+            explicit parallel_pool(std::size_t n) : stopping(false) {
+                try {
+                    for (std::size_t i = 0; i < n; ++i) {
+                        threads.push_back(std::thread([this]{ work(); }));
+                    }
+                } catch (...) {
+                    stop();
+                    throw;
+                }
+            }
+            ~parallel_pool() {
+                stop();
+            }
+
+            void post(std::function<void()> task) {
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    tasks.push_back(std::move(task));
+                }
+                ready.notify_one();
+            }
+
+            // runs a queued task on the calling thread. A thread that waits for its
+            //   chunks helps, so a parallel query nested in a chunk cannot deadlock.
+            bool try_run_one() {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    if (tasks.empty()) {
+                        return false;
+                    }
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+                return true;
+            }
+
+            static parallel_pool& instance() {
+                static parallel_pool pool(std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1);
+                return pool;
+            }
+        };
+
+        // waits for a fixed number of tasks, keeping the first exception
+        class parallel_latch
+        {
+            std::mutex lock;
+            std::condition_variable done;
+            std::size_t remaining;
+            std::exception_ptr error;
+
+        public:
+            explicit parallel_latch(std::size_t n) : remaining(n) {}
+
+            template <class Task>
+            void run(const Task& task) {
+                std::exception_ptr e;
+                try {
+                    task();
+                } catch (...) {
+                    e = std::current_exception();
+                }
+                std::unique_lock<std::mutex> guard(lock);
+                if (e && !error) {
+                    error = e;
+                }
+                if (--remaining == 0) {
+                    done.notify_all();
+                }
+            }
+
+            // the tasks that were never started
+            void abandon(std::size_t n) {
+                std::unique_lock<std::mutex> guard(lock);
+                remaining -= n;
+                if (remaining == 0) {
+                    done.notify_all();
+                }
+            }
+
+            bool finished() {
+                std::unique_lock<std::mutex> guard(lock);
+                return remaining == 0;
+            }
+
+            void wait() {
+                wait_quietly();
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+
+            void wait_quietly() {
+                std::unique_lock<std::mutex> guard(lock);
+                done.wait(guard, [this]{ return remaining == 0; });
+            }
+        };
+
+        // each chunk is evaluated by whichever of its task and the calling thread
+        //   claims it first. Shared with the tasks, which may run after the query
+        class parallel_claims
+        {
+            std::unique_ptr<std::atomic<bool>[]> claimed;
+
+        public:
+            explicit parallel_claims(std::size_t n) : claimed(new std::atomic<bool>[n]) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    claimed[i] = false;
+                }
+            }
+
+            bool claim(std::size_t i) {
+                return !claimed[i].exchange(true);
+            }
+        };
+
+        // the tasks refer to the frame that starts them, so when starting one of them
+        //   throws, the chunks that did not start are abandoned and the others are
+        //   waited for before the frame unwinds
+        struct parallel_start_guard
+        {
+            parallel_latch& latch;
+            parallel_claims& claims;
+            std::size_t n;
+            bool started;
+
+            parallel_start_guard(parallel_latch& latch, parallel_claims& claims, std::size_t n) : latch(latch), claims(claims), n(n), started(false) {}
+            ~parallel_start_guard() {
+                if (!started) {
+                    std::size_t unstarted = 0;
+                    for (std::size_t i = 0; i < n; ++i) {
+                        unstarted += claims.claim(i) ? 1 : 0;
+                    }
+                    latch.abandon(unstarted);
+                    latch.wait_quietly();
+                }
+            }
+        };
+    }
+
+    // a random access query split into chunks that are evaluated concurrently.
+    //   where() and select() are applied to each chunk independently, and the
+    //   terminal operators combine the per-chunk results in chunk order. The
+    //   calling thread evaluates the first chunk, and the others run on the 
+    //   executor, or on a pool shared by all parallel queries. The calling
+    //   thread then evaluates the chunks that have not started, so an executor
+    //   that queues the tasks to the calling thread does not deadlock.
+    template <class Collection, class Query = detail::parallel_identity>
+    class linq_parallel
+    {
+        static_assert(util::less_or_equal_cursor_category<
+                          random_access_cursor_tag,
+                          typename Collection::cursor::cursor_category>::value,
+                      "parallel() requires a random access query");
+
+        typedef detail::parallel_chunk<Collection>
+            chunk_type;
+        typedef decltype(std::declval<const Query&>()(std::declval<const linq_driver<chunk_type>&>()))
+            chunk_driver;
+        typedef typename chunk_driver::cursor::element_type
+            element_type;
+
+        template <class R, class ChunkFn>
+        std::vector<util::maybe<R>> run(ChunkFn fn) const
+        {
+            auto cur = c.get_cursor();
+            const std::size_t total = cur.empty() ? 0 : cur.size() - cur.position();
+            const std::size_t n = total < chunks ? (total ? total : 1) : chunks;
+
+            std::vector<util::maybe<R>> results(n);
+            auto eval = [&](std::size_t i) {
+                const std::size_t first = total * i / n;
+                const std::size_t last = total * (i + 1) / n;
+                linq_driver<chunk_type> chunk(chunk_type(cur, first, last - first));
+                results[i].set(fn(query(chunk)));
+            };
+
+            auto claims = std::make_shared<detail::parallel_claims>(n);
+            detail::parallel_latch latch(n);
+            {
+                detail::parallel_start_guard guard(latch, *claims, n);
+                for (std::size_t i = 1; i < n; ++i) {
+                    // the frame is only used once the chunk is claimed
+                    std::function<void()> task = [&, i, claims]() {
+                        if (claims->claim(i)) {
+                            latch.run([&]{ eval(i); });
+                        }
+                    };
+                    if (executor) {
+                        executor(std::move(task));
+                    } else {
+                        detail::parallel_pool::instance().post(std::move(task));
+                    }
+                }
+                guard.started = true;
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                if (claims->claim(i)) {
+                    latch.run([&]{ eval(i); });
+                }
+            }
+            if (!executor) {
+                auto& pool = detail::parallel_pool::instance();
+                while (!latch.finished() && pool.try_run_one()) {
+                }
+            }
+            latch.wait();
+            return results;
+        }
+
+    public:
+        linq_parallel(const Collection& c, std::size_t chunks, parallel_executor executor = parallel_executor(), Query query = Query())
+        : c(c), chunks(chunks ? chunks : 1), executor(std::move(executor)), query(std::move(query))
+        {
+        }
+
+        template <class Predicate>
+        linq_parallel<Collection, detail::parallel_where<Query, Predicate>> where(Predicate p) const {
+            return linq_parallel<Collection, detail::parallel_where<Query, Predicate>>(
+                c, chunks, executor, detail::parallel_where<Query, Predicate>(query, std::move(p)));
+        }
+
+        template <class Selector>
+        linq_parallel<Collection, detail::parallel_select<Query, Selector>> select(Selector sel) const {
+            return linq_parallel<Collection, detail::parallel_select<Query, Selector>>(
+                c, chunks, executor, detail::parallel_select<Query, Selector>(query, std::move(sel)));
+        }
+
+        // the seed is applied once per chunk, so it should be the identity of combine
+        template <class T, class Fn, class Combine>
+        T aggregate(T seed, Fn fn, Combine combine) const {
+            auto parts = run<T>([&](const chunk_driver& d) { return d.aggregate(seed, fn); });
+            T result = std::move(*parts[0]);
+            for (std::size_t i = 1; i < parts.size(); ++i) {
+                result = combine(std::move(result), std::move(*parts[i]));
+            }
+            return result;
+        }
+
+        element_type sum() const {
+            return sum(element_type());
+        }
+
+        element_type sum(element_type seed) const {
+            return aggregate(element_type(), std::plus<element_type>(), std::plus<element_type>()) + seed;
+        }
+
+        std::size_t count() const {
+            return aggregate(std::size_t(0), [](std::size_t n, const element_type&) { return n + 1; }, std::plus<std::size_t>());
+        }
+
+        template <class Predicate>
+        std::size_t count(Predicate p) const {
+            return where(std::move(p)).count();
+        }
+
+        bool any() const {
+            return any([](const element_type&) { return true; });
+        }
+
+        template <class Predicate>
+        bool any(Predicate p) const {
+            // a match in one chunk stops the scan of the others
+            std::atomic<bool> found(false);
+            run<bool>([&](const chunk_driver& d) {
+                bool result = d.any([&](const element_type& x) { return found.load(std::memory_order_relaxed) || p(x); });
+                if (result) { found = true; }
+                return result;
+            });
+            return found;
+        }
+
+        template <class Predicate>
+        bool all(Predicate p) const {
+            return !any([&](const element_type& x) { return !p(x); });
+        }
+
+        element_type min() const {
+            return min(std::less<element_type>());
+        }
+
+        template <class Compare>
+        element_type min(Compare less) const {
+            return best([&](const element_type& a, const element_type& b) { return less(a, b); });
+        }
+
+        element_type max() const {
+            return max(std::less<element_type>());
+        }
+
+        template <class Compare>
+        element_type max(Compare less) const {
+            return best([&](const element_type& a, const element_type& b) { return less(b, a); });
+        }
+
+        std::vector<element_type> to_vector() const {
+            auto parts = run<std::vector<element_type>>([](const chunk_driver& d) { return d.to_vector(); });
+            std::size_t total = 0;
+            for (auto& part : parts) {
+                total += part->size();
+            }
+            std::vector<element_type> result;
+            result.reserve(total);
+            for (auto& part : parts) {
+                std::move(part->begin(), part->end(), std::back_inserter(result));
+            }
+            return result;
+        }
+
+    private:
+        // the first element for which no other element is better
+        template <class Better>
+        element_type best(Better better) const {
+            auto parts = run<util::maybe<element_type>>([&](const chunk_driver& d) {
+                util::maybe<element_type> result;
+                for (auto cur = d.get_cursor(); !cur.empty(); cur.inc()) {
+                    if (!result || better(cur.get(), *result)) {
+                        result.set(cur.get());
+                    }
+                }
+                return result;
+            });
+            util::maybe<element_type> result;
+            for (auto& part : parts) {
+                if (*part && (!result || better(**part, *result))) {
+                    result.set(**part);
+                }
+            }
+            if (!result) {
+                throw std::logic_error("min/max performed on empty range");
+            }
+            return *result;
+        }
+
+        Collection          c;
+        std::size_t         chunks;
+        parallel_executor   executor;
+        Query               query;
+    };
+}
+
+#endif // !defined(CPPLINQ_LINQ_PARALLEL_HPP)
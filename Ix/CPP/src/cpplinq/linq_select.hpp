@@ -32,9 +32,11 @@ namespace cpplinq
             bool atbegin() const { return cur.atbegin(); }
             void dec() { cur.dec(); }
 
-            void skip(std::size_t n) { cur.skip(n); }
+            void skip(std::ptrdiff_t n) { cur.skip(n); }
+            reference_type get(std::ptrdiff_t n) const { return sel(cur.get(n)); }
             std::size_t position() const { return cur.position(); }
             std::size_t size() const { return cur.size(); }
+            void truncate(std::size_t n) { cur.truncate(n); }
         private:
             inner_cursor    cur;
             Selector        sel;
@@ -8,6 +8,23 @@
 
 namespace cpplinq 
 {
+    namespace detail {
+        template <class Cursor>
+        void skip_cursor_(Cursor& cur, std::size_t n, onepass_cursor_tag)
+        {
+            while(n-- && !cur.empty()) {
+                cur.inc();
+            }
+        }
+
+        template <class Cursor>
+        void skip_cursor_(Cursor& cur, std::size_t n, random_access_cursor_tag)
+        {
+            std::size_t rem = cur.size() - cur.position();
+            cur.skip(n < rem ? n : rem);
+        }
+    }
+
     template <class Collection>
     struct linq_skip
     {
@@ -17,12 +34,8 @@ namespace cpplinq
         linq_skip(const Collection& c, std::size_t n) : c(c), n(n) {}
 
         cursor get_cursor() const {
-            std::size_t rem = n;
-
             auto cur = c.get_cursor();
-            while(rem-- && !cur.empty()) {
-                cur.inc();
-            }
+            detail::skip_cursor_(cur, n, typename cursor::cursor_category());
             cur.forget();
             return cur;
         }
@@ -25,9 +25,11 @@ namespace cpplinq
         bool atbegin() const { return cur.atbegin(); }
         void dec() { cur.dec(); --rem; }
 
-        void skip(std::size_t n) { cur.skip(n); rem -= n; }
+        void skip(std::ptrdiff_t n) { cur.skip(n); rem -= n; }
+        reference_type get(std::ptrdiff_t n) const { return cur.get(n); }
         std::size_t position() const { return cur.position(); }
         std::size_t size() const { return cur.size(); }
+        void truncate(std::size_t n) { if (n < rem) { rem = n; } }
             
     private:
         InnerCursor cur;
@@ -83,6 +85,17 @@ namespace cpplinq
         std::size_t n;
     };
 
+    // selects the collection type produced by take(n). Collections that can 
+    //   do better than truncating their cursor (e.g. order_by) specialize this.
+    template <class Collection>
+    struct take_traits
+    {
+        typedef linq_take<Collection> type;
+        static type make(const Collection& c, std::size_t n) {
+            return type(c, n);
+        }
+    };
+
     template <class Collection>
     auto get_cursor(
             const linq_take<Collection>& take
@@ -41,7 +41,7 @@ namespace cpplinq
                 return cur.get();
             }
 
-            bool atbegin() const { return atbegin(cur); }
+            bool atbegin() const { return cur.atbegin(); }
             void dec() {
                 for (;;) {
                     cur.dec();
@@ -225,6 +225,211 @@ namespace cpplinq { namespace util {
     private:
         
     };
+
+    // true when std::hash<T> can be used, or T is a pair or tuple of such types
+    template <class T>
+    struct is_hashable
+    {
+        template <class U>
+        static auto check(int) -> decltype(std::hash<U>()(std::declval<const U&>()), std::true_type());
+        template <class U>
+        static std::false_type check(...);
+
+        static const bool value = std::is_default_constructible<std::hash<T>>::value 
+                               && decltype(check<T>(0))::value;
+    };
+    template <class T1, class T2>
+    struct is_hashable<std::pair<T1, T2>>
+    {
+        static const bool value = is_hashable<T1>::value && is_hashable<T2>::value;
+    };
+    template <>
+    struct is_hashable<std::tuple<>>
+    {
+        static const bool value = true;
+    };
+    template <class T0, class... TN>
+    struct is_hashable<std::tuple<T0, TN...>>
+    {
+        static const bool value = is_hashable<T0>::value && is_hashable<std::tuple<TN...>>::value;
+    };
+
+    // std::hash, extended to pairs and tuples of hashable types
+    struct default_hash
+    {
+        template <class T>
+        std::size_t operator()(const T& value) const {
+            return std::hash<T>()(value);
+        }
+
+        template <class T1, class T2>
+        std::size_t operator()(const std::pair<T1, T2>& value) const {
+            return combine((*this)(value.first), (*this)(value.second));
+        }
+
+        template <class... TN>
+        std::size_t operator()(const std::tuple<TN...>& value) const {
+            return hash_tuple<0>(value, 0);
+        }
+
+    private:
+        static std::size_t combine(std::size_t seed, std::size_t h) {
+            return seed ^ (h + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+        }
+
+        template <std::size_t I, class... TN>
+        typename std::enable_if<I == sizeof...(TN), std::size_t>::type
+        hash_tuple(const std::tuple<TN...>&, std::size_t seed) const {
+            return seed;
+        }
+        template <std::size_t I, class... TN>
+        typename std::enable_if<I != sizeof...(TN), std::size_t>::type
+        hash_tuple(const std::tuple<TN...>& value, std::size_t seed) const {
+            return hash_tuple<I + 1>(value, combine(seed, (*this)(std::get<I>(value))));
+        }
+    };
+
+    // maps keys to dense ids [0, size()) in insertion order. 
+    //   open addressing with linear probing over a power-of-two slot table 
+    //   that only stores ids, so keys live contiguously and lookups do not 
+    //   chase node pointers.
+    template <class Key, class Hash = default_hash, class KeyEqual = std::equal_to<Key>>
+    class flat_index
+    {
+        static const std::size_t empty_slot = static_cast<std::size_t>(-1);
+
+        std::vector<std::size_t>    slots;
+        std::vector<Key>            keys;
+        std::vector<std::size_t>    hashes;
+        Hash                        hash;
+        KeyEqual                    eq;
+
+        static std::size_t mix(std::size_t h) {
+            // std::hash is the identity for integers on common implementations. 
+            //   spread the bits before masking.
+            unsigned long long x = h;
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            return static_cast<std::size_t>(x);
+        }
+
+        std::size_t probe(const Key& key, std::size_t h) const {
+            const std::size_t mask = slots.size() - 1;
+            for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+                const std::size_t id = slots[i];
+                if (id == empty_slot || (hashes[id] == h && eq(keys[id], key))) {
+                    return i;
+                }
+            }
+        }
+
+        void rehash(std::size_t capacity) {
+            std::size_t n = 16;
+            while (n < capacity * 2) {
+                n *= 2;
+            }
+            if (n <= slots.size()) {
+                return;
+            }
+            std::vector<std::size_t>(n, empty_slot).swap(slots);
+            const std::size_t mask = n - 1;
+            for (std::size_t id = 0; id != keys.size(); ++id) {
+                std::size_t i = hashes[id] & mask;
+                while (slots[i] != empty_slot) {
+                    i = (i + 1) & mask;
+                }
+                slots[i] = id;
+            }
+        }
+
+    public:
+        static const std::size_t npos = static_cast<std::size_t>(-1);
+
+        explicit flat_index(Hash hash = Hash(), KeyEqual eq = KeyEqual())
+        : hash(std::move(hash))
+        , eq(std::move(eq))
+        {
+        }
+
+        void reserve(std::size_t n) {
+            keys.reserve(n);
+            hashes.reserve(n);
+            rehash(n);
+        }
+
+        std::size_t size() const { return keys.size(); }
+        const Key& key(std::size_t id) const { return keys[id]; }
+
+        std::size_t find(const Key& key) const {
+            if (keys.empty()) {
+                return npos;
+            }
+            return slots[probe(key, mix(hash(key)))];
+        }
+
+        // returns the id of key, and whether it was newly inserted
+        std::pair<std::size_t, bool> insert(const Key& key) {
+            if ((keys.size() + 1) * 2 > slots.size()) {
+                rehash(keys.size() + 1);
+            }
+            const std::size_t h = mix(hash(key));
+            const std::size_t i = probe(key, h);
+            if (slots[i] != empty_slot) {
+                return std::make_pair(slots[i], false);
+            }
+            slots[i] = keys.size();
+            keys.push_back(key);
+            hashes.push_back(h);
+            return std::make_pair(slots[i], true);
+        }
+    };
+
+    template <class Key, class Hash, class KeyEqual>
+    const std::size_t flat_index<Key, Hash, KeyEqual>::empty_slot;
+    template <class Key, class Hash, class KeyEqual>
+    const std::size_t flat_index<Key, Hash, KeyEqual>::npos;
+
+    // maps keys to dense ids [0, size()) in insertion order, like flat_index,
+    //   for keys that are only ordered by Less.
+    template <class Key, class Less>
+    class ordered_index
+    {
+        std::map<Key, std::size_t, Less>                    ids;
+        std::vector<typename std::map<Key, std::size_t, Less>::const_iterator> keys;
+
+    public:
+        static const std::size_t npos = static_cast<std::size_t>(-1);
+
+        explicit ordered_index(Less less = Less())
+        : ids(std::move(less))
+        {
+        }
+
+        void reserve(std::size_t n) {
+            keys.reserve(n);
+        }
+
+        std::size_t size() const { return keys.size(); }
+        const Key& key(std::size_t id) const { return keys[id]->first; }
+
+        std::size_t find(const Key& key) const {
+            auto it = ids.find(key);
+            return it == ids.end() ? npos : it->second;
+        }
+
+        // returns the id of key, and whether it was newly inserted
+        std::pair<std::size_t, bool> insert(const Key& key) {
+            auto result = ids.insert(std::make_pair(key, keys.size()));
+            if (result.second) {
+                keys.push_back(result.first);
+            }
+            return std::make_pair(result.first->second, result.second);
+        }
+    };
+
+    template <class Key, class Less>
+    const std::size_t ordered_index<Key, Less>::npos;
 }}
 
 
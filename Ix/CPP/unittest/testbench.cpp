@@ -2,6 +2,8 @@
 
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <sstream>
 #include <vector>
 #include <functional>
 #include <algorithm>
@@ -9,6 +11,7 @@
 #include <iterator>
 #include <string>
 #include <complex>
+#include <thread>
 
 #include <ctime>
 #include <cstddef>
@@ -18,6 +21,7 @@
 #include <boost/iterator.hpp>
 
 #include "cpplinq/linq.hpp"
+#include "cpplinq/linq_mmap.hpp"
 
 #include "testbench.hpp"
 
@@ -261,6 +265,433 @@ TEST(test_groupby)
     }
 }
 
+TEST(test_groupby_lazy)
+{
+    vector<int> xs = vector_range(0, 1000);
+
+    int calls = 0;
+    auto grouped = 
+        from(xs)
+        .groupby([&](int i){ ++calls; return i % 7; });
+
+    auto cur = grouped.get_cursor();
+    VERIFY_EQ(0, calls);
+
+    VERIFY(!cur.empty());
+    VERIFY_EQ(1000, calls);
+
+    int expected_key = 0;
+    for (; !cur.empty(); cur.inc(), ++expected_key) {
+        auto g = cur.get();
+        VERIFY_EQ(expected_key, g.key);
+
+        auto elems = from(g);
+        VERIFY_EQ(expected_key < 6 ? 143 : 142, elems.count());
+        VERIFY_EQ(expected_key, elems.first());
+        VERIFY_EQ(expected_key + 7, elems.element_at(1));
+        VERIFY(elems.all([=](int x){ return x % 7 == expected_key; }));
+    }
+    VERIFY_EQ(7, expected_key);
+    VERIFY_EQ(1000, calls);
+}
+
+struct parity_hash
+{
+    std::size_t operator()(int x) const { return std::hash<int>()(x % 2); }
+};
+struct parity_equal
+{
+    bool operator()(int a, int b) const { return a % 2 == b % 2; }
+};
+
+TEST(test_groupby_hash_eq)
+{
+    vector<int> xs = vector_range(0, 10);
+
+    auto grouped = 
+        from(xs)
+        .groupby([](int i){ return i; }, parity_hash(), parity_equal());
+
+    VERIFY_EQ(2, grouped.count());
+    auto evens = grouped.first();
+    VERIFY_EQ(0, evens.key);
+    VERIFY_EQ(20, from(evens).sum());
+    auto odds = grouped.element_at(1);
+    VERIFY_EQ(1, odds.key);
+    VERIFY_EQ(25, from(odds).sum());
+}
+
+struct ordered_only
+{
+    int value;
+    bool operator<(const ordered_only& other) const { return value < other.value; }
+};
+
+TEST(test_groupby_ordered_keys)
+{
+    vector<int> xs = vector_range(0, 10);
+
+    auto by_pair = 
+        from(xs)
+        .groupby([](int i){ return std::make_pair(i % 2, i % 3 == 0); });
+    VERIFY_EQ(4, by_pair.count());
+    VERIFY(std::make_pair(0, true) == by_pair.first().key);
+    VERIFY(std::make_pair(1, false) == by_pair.element_at(1).key);
+
+    auto by_tuple = 
+        from(xs)
+        .groupby([](int i){ return std::make_tuple(i % 2, i < 5, std::string(i % 2 ? "odd" : "even")); });
+    VERIFY_EQ(4, by_tuple.count());
+    auto small_evens = by_tuple.first();
+    VERIFY_EQ(6, from(small_evens).sum());
+
+    // no std::hash, grouped with operator<
+    auto by_order = 
+        from(xs)
+        .groupby([](int i){ return ordered_only{i % 3}; });
+    VERIFY_EQ(3, by_order.count());
+    VERIFY_EQ(0, by_order.first().key.value);
+    auto twos = by_order.element_at(2);
+    VERIFY_EQ(2, twos.key.value);
+    VERIFY_EQ(15, from(twos).sum());
+}
+
+struct person
+{
+    std::string name;
+    int age;
+};
+
+TEST(test_order_by)
+{
+    vector<person> people;
+    people.push_back(person{"carol", 35});
+    people.push_back(person{"alice", 30});
+    people.push_back(person{"dave", 30});
+    people.push_back(person{"bob", 25});
+    people.push_back(person{"erin", 35});
+
+    auto by_age = from(people)
+                  .order_by([](const person& p){ return p.age; })
+                  .select([](const person& p){ return p.name; })
+                  .to_vector();
+    // stable: equal ages keep their input order
+    string expect[] = { "bob", "alice", "dave", "carol", "erin" };
+    VERIFY(std::equal(by_age.begin(), by_age.end(), expect));
+
+    auto by_age_desc_name = from(people)
+                            .order_by_descending([](const person& p){ return p.age; })
+                            .then_by([](const person& p){ return p.name; })
+                            .select([](const person& p){ return p.name; })
+                            .to_vector();
+    string expect_desc[] = { "carol", "erin", "alice", "dave", "bob" };
+    VERIFY(std::equal(by_age_desc_name.begin(), by_age_desc_name.end(), expect_desc));
+
+    auto by_name_desc = from(people)
+                        .order_by([](const person& p){ return p.age; })
+                        .then_by_descending([](const person& p){ return p.name; });
+    VERIFY_EQ("bob", by_name_desc.first().name);
+    VERIFY_EQ("dave", by_name_desc.element_at(1).name);
+    VERIFY_EQ("carol", by_name_desc.last().name);
+    VERIFY_EQ(5, by_name_desc.count());
+
+    // the query is deferred, each terminal operator sorts the current input
+    vector<int> ys;
+    ys.push_back(3); ys.push_back(1); ys.push_back(2);
+    auto sorted_ys = from(ys).order_by([](int y){ return y; });
+    auto first_ys = sorted_ys.to_vector();
+    int expect_first[] = { 1, 2, 3 };
+    VERIFY(std::equal(first_ys.begin(), first_ys.end(), expect_first));
+    ys[0] = 0; ys[1] = 9; ys[2] = 5;
+    auto second_ys = sorted_ys.to_vector();
+    int expect_second[] = { 0, 5, 9 };
+    VERIFY(std::equal(second_ys.begin(), second_ys.end(), expect_second));
+}
+
+TEST(test_order_by_take)
+{
+    vector<int> xs;
+    for (int i = 0; i < 1000; ++i) {
+        xs.push_back((i * 7919) % 1000);
+    }
+
+    int calls = 0;
+    auto top = from(xs)
+               .order_by_descending([&](int x){ ++calls; return x; })
+               .take(20)
+               .take(5);
+    VERIFY_EQ(5, top.count());
+    VERIFY_EQ(1000, calls);
+
+    auto v = top.to_vector();
+    int expect[] = { 999, 998, 997, 996, 995 };
+    VERIFY(std::equal(v.begin(), v.end(), expect));
+    // each terminal operator selects again
+    VERIFY_EQ(2000, calls);
+
+    // ties keep their input order
+    auto pairs = from(xs)
+                 .order_by([](int x){ return x % 10; })
+                 .take(3)
+                 .to_vector();
+    int expect_ties[] = { 0, 190, 380 };
+    VERIFY(std::equal(pairs.begin(), pairs.end(), expect_ties));
+
+    auto all = from(xs).order_by([](int x){ return x; }, std::greater<int>()).take(5000).to_vector();
+    VERIFY_EQ(1000u, all.size());
+    VERIFY(std::is_sorted(all.begin(), all.end(), std::greater<int>()));
+}
+
+struct order
+{
+    int id;
+    int customer;
+    int amount;
+};
+
+TEST(test_join)
+{
+    vector<person> customers;
+    customers.push_back(person{"alice", 1});
+    customers.push_back(person{"bob", 2});
+    customers.push_back(person{"carol", 3});
+
+    vector<order> orders;
+    orders.push_back(order{10, 2, 5});
+    orders.push_back(order{11, 1, 7});
+    orders.push_back(order{12, 2, 9});
+    orders.push_back(order{13, 4, 1});
+
+    auto joined = from(customers)
+                  .join(from(orders),
+                        [](const person& c){ return c.age; },
+                        [](const order& o){ return o.customer; },
+                        [](const person& c, const order& o){ return c.name + ":" + std::to_string(o.id); })
+                  .to_vector();
+    // outer order, then inner order
+    string expect[] = { "alice:11", "bob:10", "bob:12" };
+    VERIFY_EQ(3u, joined.size());
+    VERIFY(std::equal(joined.begin(), joined.end(), expect));
+
+    // the index is built over the smaller outer side, whose keys are computed once
+    int keys = 0;
+    auto counted = from(customers)
+                   .join(from(orders),
+                         [&](const person& c){ ++keys; return c.age; },
+                         [](const order& o){ return o.customer; },
+                         [](const person&, const order& o){ return o.amount; })
+                   .sum();
+    VERIFY_EQ(21, counted);
+    VERIFY_EQ(3, keys);
+
+    // larger outer side: index built over the inner keys
+    auto reversed = from(orders)
+                    .join(from(customers),
+                          [](const order& o){ return o.customer; },
+                          [](const person& c){ return c.age; },
+                          [](const order& o, const person&){ return o.amount; })
+                    .sum();
+    VERIFY_EQ(21, reversed);
+
+    auto totals = from(customers)
+                  .group_join(from(orders),
+                              [](const person& c){ return c.age; },
+                              [](const order& o){ return o.customer; },
+                              [](const person&, const cpplinq::group<vector<order>::const_iterator, int>& os){
+                                  return from(os).sum([](const order& o){ return o.amount; }); })
+                  .to_vector();
+    int expect_totals[] = { 7, 14, 0 };
+    VERIFY_EQ(3u, totals.size());
+    VERIFY(std::equal(totals.begin(), totals.end(), expect_totals));
+}
+
+TEST(test_merge_join)
+{
+    int left[] = { 1, 2, 2, 4, 5, 7 };
+    int right[] = { 2, 2, 3, 5, 5, 6, 7 };
+
+    auto pairs = from(left, left + _countof(left))
+                 .merge_join(from(right, right + _countof(right)),
+                             [](int x){ return x; },
+                             [](int y){ return y; },
+                             [](int x, int y){ return x * 10 + y; })
+                 .to_vector();
+    // 2 x 2 matches for key 2, 1 x 2 for key 5, 1 x 1 for key 7
+    int expect[] = { 22, 22, 22, 22, 55, 55, 77 };
+    VERIFY_EQ(_countof(expect), pairs.size());
+    VERIFY(std::equal(pairs.begin(), pairs.end(), expect));
+
+    auto hashed = from(left, left + _countof(left))
+                  .join(from(right, right + _countof(right)),
+                        [](int x){ return x; },
+                        [](int y){ return y; },
+                        [](int x, int y){ return x * 10 + y; })
+                  .to_vector();
+    VERIFY(std::equal(hashed.begin(), hashed.end(), expect));
+}
+
+TEST(test_parallel)
+{
+    vector<int> xs = vector_range(0, 10000);
+    auto q = from(xs).parallel(4);
+
+    VERIFY_EQ(49995000, q.sum());
+    VERIFY_EQ(10000u, q.count());
+    VERIFY_EQ(5000u, q.count([](int x){ return x % 2 == 0; }));
+    VERIFY_EQ(0, q.min());
+    VERIFY_EQ(9999, q.max());
+    VERIFY(q.any([](int x){ return x == 7777; }));
+    VERIFY(!q.any([](int x){ return x < 0; }));
+    VERIFY(q.all([](int x){ return x >= 0; }));
+
+    auto evens_squared = q.where([](int x){ return x % 2 == 0; })
+                          .select([](int x){ return (long long)x * x; });
+    auto expected = from(xs).where([](int x){ return x % 2 == 0; })
+                            .select([](int x){ return (long long)x * x; });
+    VERIFY_EQ(expected.sum(), evens_squared.sum());
+
+    auto v = evens_squared.to_vector();
+    auto ev = expected.to_vector();
+    VERIFY(v == ev);
+
+    VERIFY_EQ(10000, q.aggregate(0, [](int n, int){ return n + 1; }, std::plus<int>()));
+
+    // more chunks than elements, and an empty input
+    vector<int> few = vector_range(0, 3);
+    VERIFY_EQ(3, from(few).parallel(16).sum());
+    vector<int> none;
+    VERIFY_EQ(0, from(none).parallel(4).sum());
+    VERIFY(!from(none).parallel(4).any([](int){ return true; }));
+
+    // the chunks share one sort
+    std::atomic<int> keys(0);
+    auto sorted = from(xs).order_by_descending([&](int x){ ++keys; return x; }).parallel(4);
+    VERIFY_EQ(9999, sorted.to_vector().front());
+    VERIFY_EQ(10000, keys.load());
+
+    // custom executor
+    int tasks = 0;
+    std::vector<std::thread> threads;
+    auto counted = from(xs).parallel(3, [&](std::function<void()> task) {
+        ++tasks;
+        threads.push_back(std::thread(task));
+    });
+    VERIFY_EQ(49995000, counted.sum());
+    VERIFY_EQ(2, tasks);
+    for (auto& t : threads) { t.join(); }
+    threads.clear();
+
+    // an executor that fails after starting one task
+    tasks = 0;
+    auto failing = from(xs).parallel(4, [&](std::function<void()> task) {
+        if (++tasks > 1) {
+            throw std::runtime_error("no more threads");
+        }
+        threads.push_back(std::thread(task));
+    });
+    bool thrown = false;
+    try {
+        failing.sum();
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    VERIFY(thrown);
+    for (auto& t : threads) { t.join(); }
+
+    // an executor that queues the tasks to the calling thread, which runs them after the query
+    std::vector<std::function<void()>> queued;
+    auto deferred = from(xs).parallel(4, [&](std::function<void()> task) {
+        queued.push_back(std::move(task));
+    });
+    VERIFY_EQ(49995000, deferred.sum());
+    VERIFY_EQ(3u, queued.size());
+    for (auto& task : queued) { task(); }
+
+    VERIFY(q.any());
+    VERIFY(!from(none).parallel(4).any());
+}
+
+TEST(test_blocked)
+{
+    vector<int> xs = vector_range(0, 10000);
+    auto q = from(xs).blocked<64>();
+
+    VERIFY_EQ(49995000, q.sum());
+    VERIFY_EQ(10000u, q.count());
+    VERIFY_EQ(0, q.min());
+    VERIFY_EQ(9999, q.max());
+
+    auto evens_squared = q.where([](int x){ return x % 2 == 0; })
+                          .select([](int x){ return (long long)x * x; });
+    auto expected = from(xs).where([](int x){ return x % 2 == 0; })
+                            .select([](int x){ return (long long)x * x; });
+    VERIFY_EQ(expected.sum(), evens_squared.sum());
+    VERIFY_EQ(5000u, evens_squared.count());
+    VERIFY(evens_squared.to_vector() == expected.to_vector());
+    VERIFY_EQ(4LL, evens_squared.where([](long long x){ return x > 0; }).min());
+
+    VERIFY_EQ(10000, q.aggregate(0, [](int n, int){ return n + 1; }));
+
+    // a source that is random access but not contiguous
+    auto range = int_range(0, 1000);
+    auto gathered = from(range).select([](int x){ return x * 3; }).blocked<100>();
+    VERIFY_EQ(1498500, gathered.sum());
+    VERIFY_EQ(334u, gathered.where([](int x){ return x % 9 == 0; }).count());
+
+    // partial blocks, nothing selected, and an empty input
+    vector<int> few = vector_range(0, 3);
+    VERIFY_EQ(3, from(few).blocked().sum());
+    VERIFY_EQ(0u, from(xs).blocked().where([](int x){ return x < 0; }).count());
+    vector<int> none;
+    VERIFY_EQ(0, from(none).blocked().sum());
+    VERIFY(from(none).blocked().to_vector().empty());
+}
+
+TEST(test_distinct)
+{
+    vector<int> xs{3, 1, 3, 2, 1, 5, 2, 4};
+    vector<int> ys{5, 6, 1, 6, 7};
+
+    auto d = from(xs).distinct().to_vector();
+    VERIFY_EQ(5u, d.size());
+    VERIFY(d == (vector<int>{3, 1, 2, 5, 4}));
+    VERIFY_EQ(5u, from(xs).distinct(100).count());
+
+    auto u = from(xs).union_with(from(ys)).to_vector();
+    VERIFY(u == (vector<int>{3, 1, 2, 5, 4, 6, 7}));
+
+    auto i = from(xs).intersect(from(ys)).to_vector();
+    VERIFY(i == (vector<int>{1, 5}));
+
+    // skip applies to the set operators
+    VERIFY_EQ(4u, from(xs).distinct().skip(1).count());
+    VERIFY_EQ(2, from(xs).distinct().skip(2).first());
+    VERIFY_EQ(6, from(xs).union_with(from(ys)).skip(5).first());
+    VERIFY_EQ(1u, from(xs).intersect(from(ys)).skip(1).count());
+    VERIFY_EQ(2u, from(xs).except(from(ys)).skip(1).count());
+
+    auto ex = from(xs).except(from(ys)).to_vector();
+    VERIFY(ex == (vector<int>{3, 2, 4}));
+
+    // custom hash and equality: compare by parity
+    auto p = from(xs).distinct(parity_hash(), parity_equal()).to_vector();
+    VERIFY(p == (vector<int>{3, 2}));
+    auto pi = from(ys).intersect(from(xs), parity_hash(), parity_equal(), 2).to_vector();
+    VERIFY(pi == (vector<int>{5, 6}));
+
+    // lazy: only what is read is evaluated
+    int evaluated = 0;
+    auto counted = from(xs).select([&](int x){ ++evaluated; return x; }).distinct();
+    VERIFY_EQ(3, counted.first());
+    VERIFY(evaluated <= 2); // the first element only, read for the set and for first()
+
+    vector<int> none;
+    VERIFY(from(none).distinct().empty());
+    VERIFY(from(none).union_with(from(none)).empty());
+    VERIFY_EQ(0u, from(xs).intersect(from(none)).count());
+    VERIFY_EQ(5u, from(xs).except(from(none)).count());
+}
+
 TEST(test_symbolname)
 {
     auto complexQuery = 
@@ -327,6 +758,39 @@ TEST(test_element_accessors)
     VERIFY_EQ(42, q.last());
 }
 
+TEST(test_random_access_accessors)
+{
+    vector<int> v = vector_range(0, 100);
+    auto q = from(v)
+             .select([](int x){return x*2;});
+
+    VERIFY((std::is_same<decltype(q)::cursor::cursor_category, random_access_cursor_tag>::value));
+    VERIFY_EQ(100, q.count());
+    VERIFY_EQ(20, q.element_at(10));
+    VERIFY_EQ(20, q[10]);
+    VERIFY_EQ(198, q.last());
+    VERIFY_EQ(0, q.element_at_or_default(100));
+
+    bool thrown = false;
+    try { q.element_at(100); } catch (std::logic_error&) { thrown = true; }
+    VERIFY(thrown);
+
+    auto skipped = q.skip(95);
+    VERIFY_EQ(5, skipped.count());
+    VERIFY_EQ(190, skipped.first());
+    VERIFY_EQ(196, skipped[3]);
+    VERIFY_EQ(0, q.skip(200).count());
+
+    auto taken = q.skip(10).take(5);
+    VERIFY_EQ(5, taken.count());
+    VERIFY_EQ(28, taken.last());
+    VERIFY_EQ(120, taken.sum());
+
+    auto it = q.begin();
+    it += 50;
+    VERIFY_EQ(100, *it);
+}
+
 //////////////////// New style cursors ////////////////////
 
 TEST(test_cursor_dynamic)
@@ -419,6 +883,154 @@ TEST(test_late_bind)
     cout << "typeof q1.late_bind() ==> " << typeid(q1.late_bind()).name() << endl;
 }
 
+TEST(test_late_bind_blocks)
+{
+    vector<int> xs = vector_range(0, 100);
+    auto q = from(xs).where([](int x){ return x % 3 == 0; }).select([](int x){ return x * 2; }).late_bind();
+
+    VERIFY_EQ(from(xs).where([](int x){ return x % 3 == 0; }).select([](int x){ return x * 2; }).sum(), q.sum());
+    VERIFY_EQ(34u, q.count());
+    VERIFY_EQ(0, q.first());
+
+    // copies keep their own position, including elements already fetched
+    auto cur = q.get_cursor();
+    cur.inc(); cur.inc(); cur.inc();
+    auto copy = cur;
+    cur.inc();
+    VERIFY_EQ(18, copy.get());
+    VERIFY_EQ(24, cur.get());
+
+    // next_block reads the remainder in blocks
+    int block[16];
+    VERIFY_EQ(16u, cur.next_block(block, 16));
+    VERIFY_EQ(24, block[0]);
+    VERIFY_EQ(54, block[5]);
+    VERIFY_EQ(14u, cur.next_block(block, 16));
+    VERIFY_EQ(198, block[13]);
+    VERIFY(cur.empty());
+    VERIFY_EQ(30, copy.next_block(block, 16) ? block[2] : -1);
+
+    // references are batched as pointers, without copying
+    vector<int> ys = vector_range(0, 40);
+    dynamic_cursor<int&> refs = from(ys).get_cursor();
+    refs.get() = 42;
+    VERIFY_EQ(42, ys[0]);
+    for (; !refs.empty(); refs.inc()) {
+        refs.get() += 1;
+    }
+    VERIFY_EQ(43, ys[0]);
+    VERIFY_EQ(40, ys[39]);
+    VERIFY_EQ(40 * 41 / 2 + 42, from(ys).late_bind().sum());
+
+    // empty() does not read ahead of the current element
+    int selected = 0;
+    auto counted = from(xs).select([&](int x){ ++selected; return x; }).late_bind();
+    auto lazy = counted.get_cursor();
+    VERIFY(!lazy.empty());
+    VERIFY_EQ(0, selected);
+    lazy.inc();
+    VERIFY(!lazy.empty());
+    VERIFY_EQ(0, selected);
+    VERIFY_EQ(1, lazy.get());
+
+    // elements too large to batch are fetched one at a time
+    struct large { int values[32]; };
+    vector<large> ls(10);
+    for (int i = 0; i != 10; ++i) {
+        ls[i].values[31] = i;
+    }
+    auto large_cur = from(ls).select([](const large& x){ return x; }).late_bind().get_cursor();
+    large_cur.inc();
+    auto large_copy = large_cur;
+    large_cur.inc();
+    VERIFY_EQ(1, large_copy.get().values[31]);
+    VERIFY_EQ(2, large_cur.get().values[31]);
+    large l[16];
+    VERIFY_EQ(8u, large_cur.next_block(l, 16));
+    VERIFY_EQ(9, l[7].values[31]);
+
+    // moved from cursors are empty
+    dynamic_cursor<int> moved(std::move(cur));
+    VERIFY(cur.empty());
+    VERIFY(moved.empty());
+}
+
+TEST(test_late_bind_onepass)
+{
+    // references into a onepass cursor go stale when it moves, so they are not batched
+    std::istringstream in("1 2 3 4 5 6 7 8");
+    auto q = from(std::istream_iterator<int>(in), std::istream_iterator<int>()).late_bind();
+    vector<int> result;
+    for (auto cur = q.get_cursor(); !cur.empty(); cur.inc()) {
+        result.push_back(cur.get());
+    }
+
+    VERIFY_EQ(8u, result.size());
+    for (int i = 0; i != 8; ++i) {
+        VERIFY_EQ(i + 1, result[i]);
+    }
+
+    // values are not read ahead either, so first() leaves the rest in the stream
+    std::istringstream values("1 2 3 4 5 6 7 8");
+    auto selected = from(std::istream_iterator<int>(values), std::istream_iterator<int>())
+        .select([](int x){ return x * 10; }).late_bind();
+    VERIFY_EQ(10, selected.first());
+    int next = 0;
+    values >> next;
+    VERIFY_EQ(2, next);
+}
+
+TEST(test_mapped_file)
+{
+    const char* path = "cpplinq_mapped_file.txt";
+    {
+        ofstream out(path, ios::binary);
+        out << "alpha\r\nbeta\n\ngamma";
+    }
+
+    {
+        auto lines = from_mapped_lines(path).select([](string_view s){ return string(s); }).to_vector();
+        VERIFY_EQ(4u, lines.size());
+        VERIFY_EQ(string("alpha"), lines[0]);
+        VERIFY_EQ(string("beta"), lines[1]);
+        VERIFY_EQ(string(), lines[2]);
+        VERIFY_EQ(string("gamma"), lines[3]);
+        VERIFY(string_view("beta") == from_mapped_lines(path).skip(1).first());
+        VERIFY_EQ(2, from_mapped_lines(path).skip(2).count());
+
+        // 6 byte records: "alpha\r", "\nbeta\n", "\ngamma"
+        auto records = from_mapped_records(path, 6);
+        VERIFY_EQ(3, records.count());
+        VERIFY(string_view("\nbeta\n") == records.element_at(1));
+        VERIFY(string_view("\ngamma") == records.last());
+    }
+
+    {
+        // the cursors keep the mapping alive after their query is gone
+        auto line_cur = from_mapped_lines(path).get_cursor();
+        auto record_cur = from_mapped_records(path, 6).get_cursor();
+        line_cur.inc();
+        VERIFY(string_view("beta") == line_cur.get());
+        VERIFY(string_view("alpha\r") == record_cur.get());
+    }
+
+    {
+        ofstream out(path, ios::binary);
+    }
+    VERIFY_EQ(0, from_mapped_lines(path).count());
+    VERIFY_EQ(0, from_mapped_records(path, 4).count());
+
+    remove(path);
+
+    bool thrown = false;
+    try {
+        from_mapped_lines(path);
+    } catch (const system_error&) {
+        thrown = true;
+    }
+    VERIFY(thrown);
+}
+
 struct stopwatch
 {
     time_t t0, t1;
@@ -514,6 +1126,47 @@ TEST(test_performance)
 #endif
 }
 
+TEST(test_blocked_performance)
+{
+    vector<double> xs(1 << 16);
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = double(i % 1000);
+    }
+
+    double blocked_result = 0, loop_result = 0;
+    auto blocked = [&](int n){
+        for (int i = 0; i < n; ++i) {
+            blocked_result = from(xs).blocked()
+                .where([](double x){ return x < 500; })
+                .select([](double x){ return x * 0.5; })
+                .sum();
+        }
+    };
+    auto loop = [&](int n){
+        for (int i = 0; i < n; ++i) {
+            double sum = 0;
+            for (auto x : xs) {
+                if (x < 500) {
+                    sum += x * 0.5;
+                }
+            }
+            loop_result = sum;
+        }
+    };
+
+    blocked(1);
+    loop(1);
+    VERIFY_EQ(loop_result, blocked_result);
+
+#ifdef PERF
+    cout << "blocked where/select/sum" << endl;
+    test_perf(blocked);
+    cout << endl << "hand written loop" << endl;
+    test_perf(loop);
+    cout << endl;
+#endif
+}
+
 // SUM TESTS
 
 TEST(test_sum_ints)
@@ -1,19 +1,13 @@
 
 #include <rxcpp/rx-lite.hpp>
 #include <rxcpp/operators/rx-reduce.hpp>
-#include <rxcpp/operators/rx-filter.hpp>
 #include <rxcpp/operators/rx-map.hpp>
 #include <rxcpp/operators/rx-tap.hpp>
-#include <rxcpp/operators/rx-concat_map.hpp>
 #include <rxcpp/operators/rx-flat_map.hpp>
+#include <rxcpp/operators/rx-framing.hpp>
 #include <rxcpp/operators/rx-concat.hpp>
-#include <rxcpp/operators/rx-merge.hpp>
 #include <rxcpp/operators/rx-repeat.hpp>
-#include <rxcpp/operators/rx-publish.hpp>
-#include <rxcpp/operators/rx-ref_count.hpp>
 #include <rxcpp/operators/rx-window.hpp>
-#include <rxcpp/operators/rx-window_toggle.hpp>
-#include <rxcpp/operators/rx-start_with.hpp>
 namespace Rx {
 using namespace rxcpp;
 using namespace rxcpp::sources;
@@ -22,7 +16,7 @@ using namespace rxcpp::util;
 }
 using namespace Rx;
 
-#include <regex>
+#include <iterator>
 #include <random>
 using namespace std;
 using namespace std::chrono;
@@ -62,45 +56,10 @@ int main()
     //
     // recover lines of text from byte stream
     //
-    
-    auto removespaces = [](string s){
-        s.erase(remove_if(s.begin(), s.end(), ::isspace), s.end());
-        return s;
-    };
 
-    // create strings split on \r
-    auto strings = bytes |
-        concat_map([](vector<uint8_t> v){
-            string s(v.begin(), v.end());
-            regex delim(R"/(\r)/");
-            cregex_token_iterator cursor(&s[0], &s[0] + s.size(), delim, {-1, 0});
-            cregex_token_iterator end;
-            vector<string> splits(cursor, end);
-            return iterate(move(splits));
-        }) |
-        filter([](const string& s){
-            return !s.empty();
-        }) |
-        publish() |
-        ref_count();
-
-    // filter to last string in each line
-    auto closes = strings |
-        filter(
-            [](const string& s){
-                return s.back() == '\r';
-            }) |
-        Rx::map([](const string&){return 0;});
-
-    // group strings by line
-    auto linewindows = strings |
-        window_toggle(closes | start_with(0), [=](int){return closes;});
-
-    // reduce the strings for a line into one string
-    auto lines = linewindows |
-        flat_map([&](observable<string> w) {
-            return w | start_with<string>("") | sum() | Rx::map(removespaces);
-        });
+    // split on \r, carrying partial lines across packets
+    auto lines = bytes |
+        split_on_delimiter('\r');
 
     // print result
     lines |
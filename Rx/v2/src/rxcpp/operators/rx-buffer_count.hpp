@@ -88,8 +88,13 @@ struct buffer_count
             if (cursor++ % this->skip == 0) {
                 chunks.emplace_back();
             }
-            for(auto& chunk : chunks) {
-                chunk.push_back(v);
+            if (!chunks.empty()) {
+                // the last chunk takes the value, the others copy it
+                auto last = std::prev(chunks.end());
+                for(auto chunk = chunks.begin(); chunk != last; ++chunk) {
+                    chunk->push_back(v);
+                }
+                last->push_back(std::move(v));
             }
             while (!chunks.empty() && int(chunks.front().size()) == this->count) {
                 dest.on_next(std::move(chunks.front()));
@@ -0,0 +1,406 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+/*! \file rx-concat_eager.hpp
+
+    \brief For each item from this observable subscribe to it ahead of time, keeping up to max_prefetch of them subscribed at once.
+           Deliver the items of each of them in the order received, buffering the items of the later ones until the earlier ones complete.
+
+    \tparam Coordination  the type of the scheduler (optional).
+
+    \param  max_prefetch  the maximum number of observables that are subscribed at the same time, including the one being delivered.
+    \param  max_buffered  the most items that are buffered for an observable that is not being delivered (optional, 1024 by default, 0 is unlimited).
+    \param  cn            the scheduler to synchronize sources from different contexts (optional).
+
+    \return  Observable that emits the items emitted by each of the Observables emitted by the source observable, one after the other, without interleaving them.
+
+    concat subscribes to each observable only after the previous one completes. concat_eager overlaps their latency while keeping the same output.
+    When max_buffered items are buffered for an observable that is not being delivered, no more observables are subscribed ahead
+    until that observable is reached. An observable that sends another item while its buffer is full is unsubscribed, since there
+    is no way to pause it, and its buffer is dropped. It is subscribed again when it is reached, as concat would have subscribed it,
+    so the memory used is bounded by max_prefetch * max_buffered. The side effects of a cold observable that was stopped this way
+    run again when it is subscribed again.
+    An error from an observable that is not being delivered is held until the observables before it have completed.
+
+    Observables that emit on different threads need a coordination, such as serialize_new_thread(), to serialize their items.
+
+    \sample
+    \code{.cpp}
+    auto fetches = rxcpp::observable<>::range(1, 3).
+        map([](int i){ return rxcpp::observable<>::timer(std::chrono::milliseconds(100)).map([=](long){ return i; }); });
+    // the three timers run concurrently, the values are emitted in order after ~100ms
+    fetches.concat_eager(3, rxcpp::serialize_new_thread()).
+        as_blocking().
+        subscribe([](int v){ printf("OnNext: %d\n", v); });
+    \endcode
+*/
+
+#if !defined(RXCPP_OPERATORS_RX_CONCAT_EAGER_HPP)
+#define RXCPP_OPERATORS_RX_CONCAT_EAGER_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace operators {
+
+namespace detail {
+
+template<class... AN>
+struct concat_eager_invalid_arguments {};
+
+template<class... AN>
+struct concat_eager_invalid : public rxo::operator_base<concat_eager_invalid_arguments<AN...>> {
+    using type = observable<concat_eager_invalid_arguments<AN...>, concat_eager_invalid<AN...>>;
+};
+template<class... AN>
+using concat_eager_invalid_t = typename concat_eager_invalid<AN...>::type;
+
+template<class T, class Observable, class Coordination>
+struct concat_eager
+    : public operator_base<rxu::value_type_t<rxu::decay_t<T>>>
+{
+    typedef concat_eager<T, Observable, Coordination> this_type;
+
+    typedef rxu::decay_t<T> source_value_type;
+    typedef rxu::decay_t<Observable> source_type;
+    typedef rxu::decay_t<Coordination> coordination_type;
+
+    typedef typename coordination_type::coordinator_type coordinator_type;
+
+    typedef typename source_type::source_operator_type source_operator_type;
+    typedef source_value_type collection_type;
+    typedef typename collection_type::value_type value_type;
+
+    struct values
+    {
+        values(source_operator_type o, std::size_t mp, std::size_t mb, coordination_type sf)
+            : source_operator(std::move(o))
+            , max_prefetch(mp == 0 ? 1 : mp)
+            , max_buffered(mb)
+            , coordination(std::move(sf))
+        {
+        }
+        source_operator_type source_operator;
+        std::size_t max_prefetch;
+        // 0 is unlimited
+        std::size_t max_buffered;
+        static const std::size_t default_max_buffered = 1024;
+        coordination_type coordination;
+    };
+    values initial;
+
+    concat_eager(const source_type& o, std::size_t max_prefetch, std::size_t max_buffered, coordination_type sf)
+        : initial(o.source_operator, max_prefetch, max_buffered, std::move(sf))
+    {
+    }
+
+    template<class Subscriber>
+    void on_subscribe(Subscriber scbr) const {
+        static_assert(is_subscriber<Subscriber>::value, "subscribe must be passed a subscriber");
+
+        typedef Subscriber output_type;
+
+        struct inner_type
+        {
+            explicit inner_type(collection_type c)
+                : collection(std::move(c))
+                , lifetime(composite_subscription::empty())
+                , completed(false)
+                , stopped(false)
+            {
+            }
+            collection_type collection;
+            composite_subscription lifetime;
+            // items received before this inner reached the front
+            std::deque<value_type> buffer;
+            bool completed;
+            // unsubscribed when its buffer overflowed, subscribed again when it reaches the front
+            bool stopped;
+            rxu::maybe<rxu::error_ptr> error;
+        };
+        typedef std::shared_ptr<inner_type> inner_ptr;
+
+        struct concat_eager_state_type
+            : public std::enable_shared_from_this<concat_eager_state_type>
+            , public values
+        {
+            concat_eager_state_type(values i, coordinator_type coor, output_type oarg)
+                : values(i)
+                , source(i.source_operator)
+                , sourceLifetime(composite_subscription::empty())
+                , draining(false)
+                , coordinator(std::move(coor))
+                , out(std::move(oarg))
+            {
+            }
+
+            // true when an inner that is not being delivered has buffered max_buffered items
+            // or was stopped
+            bool full() const
+            {
+                if (this->max_buffered == 0) {
+                    return false;
+                }
+                for (std::size_t i = 1; i < active.size(); ++i) {
+                    if (active[i]->stopped || active[i]->buffer.size() >= this->max_buffered) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            // subscribe the front again if it was stopped, then subscribe to pending
+            // collections until max_prefetch are active, or the buffers are full
+            void fill()
+            {
+                if (!active.empty() && active.front()->stopped) {
+                    active.front()->stopped = false;
+                    subscribe_to(active.front());
+                }
+                while (active.size() < this->max_prefetch && !pending.empty() && !full()) {
+                    auto inner = std::make_shared<inner_type>(std::move(pending.front()));
+                    pending.pop_front();
+                    active.push_back(inner);
+                    subscribe_to(inner);
+                }
+            }
+
+            void subscribe_to(inner_ptr inner)
+            {
+                auto state = this->shared_from_this();
+
+                inner->lifetime = composite_subscription();
+
+                // when the out observer is unsubscribed all the
+                // inner subscriptions are unsubscribed as well
+                auto innercstoken = state->out.add(inner->lifetime);
+
+                inner->lifetime.add(make_subscription([state, innercstoken](){
+                    state->out.remove(innercstoken);
+                }));
+
+                auto selectedSource = on_exception(
+                    [&](){return state->coordinator.in(inner->collection);},
+                    state->out);
+                if (selectedSource.empty()) {
+                    return;
+                }
+
+                // this subscribe does not share the out subscription
+                // so that when it is unsubscribed the out will continue
+                auto sinkInner = make_subscriber<value_type>(
+                    state->out,
+                    inner->lifetime,
+                // on_next
+                    [state, inner](value_type ct) {
+                        if (state->active.front() == inner) {
+                            if (inner->buffer.empty()) {
+                                state->out.on_next(std::move(ct));
+                                return;
+                            }
+                        } else if (state->max_buffered != 0 && inner->buffer.size() >= state->max_buffered) {
+                            // the buffer is full, stop this inner until it is reached
+                            inner->stopped = true;
+                            inner->buffer.clear();
+                            inner->lifetime.unsubscribe();
+                            return;
+                        }
+                        inner->buffer.push_back(std::move(ct));
+                    },
+                // on_error
+                    [state, inner](rxu::error_ptr e) {
+                        inner->error.reset(e);
+                        state->drain();
+                    },
+                //on_completed
+                    [state, inner](){
+                        inner->completed = true;
+                        state->drain();
+                    }
+                );
+                auto selectedSinkInner = on_exception(
+                    [&](){return state->coordinator.out(sinkInner);},
+                    state->out);
+                if (selectedSinkInner.empty()) {
+                    return;
+                }
+                selectedSource->subscribe(std::move(selectedSinkInner.get()));
+            }
+
+            // deliver the front inner's buffer and move past completed inners
+            void drain()
+            {
+                if (draining) {
+                    // the loop on the stack will see the new state
+                    return;
+                }
+                draining = true;
+                while (!active.empty() && out.is_subscribed()) {
+                    auto inner = active.front();
+                    while (!inner->buffer.empty() && out.is_subscribed()) {
+                        auto value = std::move(inner->buffer.front());
+                        inner->buffer.pop_front();
+                        out.on_next(std::move(value));
+                    }
+                    if (!inner->error.empty()) {
+                        out.on_error(inner->error.get());
+                        break;
+                    }
+                    if (!inner->completed) {
+                        break;
+                    }
+                    active.pop_front();
+                    inner->lifetime.unsubscribe();
+                    fill();
+                }
+                draining = false;
+                if (active.empty() && pending.empty() && !sourceLifetime.is_subscribed()) {
+                    out.on_completed();
+                }
+            }
+
+            observable<source_value_type, source_operator_type> source;
+            composite_subscription sourceLifetime;
+            // subscribed in order, the front is being delivered
+            std::deque<inner_ptr> active;
+            // received but not yet subscribed
+            std::deque<collection_type> pending;
+            bool draining;
+            coordinator_type coordinator;
+            output_type out;
+        };
+
+        auto coordinator = initial.coordination.create_coordinator(scbr.get_subscription());
+
+        // take a copy of the values for each subscription
+        auto state = std::make_shared<concat_eager_state_type>(initial, std::move(coordinator), std::move(scbr));
+
+        state->sourceLifetime = composite_subscription();
+
+        // when the out observer is unsubscribed all the
+        // inner subscriptions are unsubscribed as well
+        state->out.add(state->sourceLifetime);
+
+        auto source = on_exception(
+            [&](){return state->coordinator.in(state->source);},
+            state->out);
+        if (source.empty()) {
+            return;
+        }
+
+        // this subscribe does not share the observer subscription
+        // so that when it is unsubscribed the observer can be called
+        // until the inner subscriptions have finished
+        auto sink = make_subscriber<collection_type>(
+            state->out,
+            state->sourceLifetime,
+        // on_next
+            [state](collection_type st) {
+                state->pending.push_back(std::move(st));
+                state->fill();
+            },
+        // on_error
+            [state](rxu::error_ptr e) {
+                state->out.on_error(e);
+            },
+        // on_completed
+            [state]() {
+                if (state->active.empty() && state->pending.empty()) {
+                    state->out.on_completed();
+                }
+            }
+        );
+        auto selectedSink = on_exception(
+            [&](){return state->coordinator.out(sink);},
+            state->out);
+        if (selectedSink.empty()) {
+            return;
+        }
+        source->subscribe(std::move(selectedSink.get()));
+    }
+};
+
+}
+
+/*! @copydoc rx-concat_eager.hpp
+*/
+template<class... AN>
+auto concat_eager(AN&&... an)
+    ->     operator_factory<concat_eager_tag, AN...> {
+    return operator_factory<concat_eager_tag, AN...>(std::make_tuple(std::forward<AN>(an)...));
+}
+
+}
+
+template<>
+struct member_overload<concat_eager_tag>
+{
+    template<class Observable, class Count,
+        class Enabled = rxu::enable_if_all_true_type_t<
+            is_observable<Observable>,
+            std::is_integral<Count>>,
+        class SourceValue = rxu::value_type_t<Observable>,
+        class ConcatEager = rxo::detail::concat_eager<SourceValue, rxu::decay_t<Observable>, identity_one_worker>,
+        class Value = rxu::value_type_t<SourceValue>,
+        class Result = observable<Value, ConcatEager>
+    >
+    static Result member(Observable&& o, Count max_prefetch) {
+        return Result(ConcatEager(std::forward<Observable>(o), max_prefetch, ConcatEager::values::default_max_buffered, identity_current_thread()));
+    }
+
+    template<class Observable, class Count, class Coordination,
+        class Enabled = rxu::enable_if_all_true_type_t<
+            is_observable<Observable>,
+            std::is_integral<Count>,
+            is_coordination<Coordination>>,
+        class SourceValue = rxu::value_type_t<Observable>,
+        class ConcatEager = rxo::detail::concat_eager<SourceValue, rxu::decay_t<Observable>, rxu::decay_t<Coordination>>,
+        class Value = rxu::value_type_t<SourceValue>,
+        class Result = observable<Value, ConcatEager>
+    >
+    static Result member(Observable&& o, Count max_prefetch, Coordination&& cn) {
+        return Result(ConcatEager(std::forward<Observable>(o), max_prefetch, ConcatEager::values::default_max_buffered, std::forward<Coordination>(cn)));
+    }
+
+    template<class Observable, class Count, class BufferCount,
+        class Enabled = rxu::enable_if_all_true_type_t<
+            is_observable<Observable>,
+            std::is_integral<Count>,
+            std::is_integral<BufferCount>>,
+        class SourceValue = rxu::value_type_t<Observable>,
+        class ConcatEager = rxo::detail::concat_eager<SourceValue, rxu::decay_t<Observable>, identity_one_worker>,
+        class Value = rxu::value_type_t<SourceValue>,
+        class Result = observable<Value, ConcatEager>
+    >
+    static Result member(Observable&& o, Count max_prefetch, BufferCount max_buffered) {
+        return Result(ConcatEager(std::forward<Observable>(o), max_prefetch, max_buffered, identity_current_thread()));
+    }
+
+    template<class Observable, class Count, class BufferCount, class Coordination,
+        class Enabled = rxu::enable_if_all_true_type_t<
+            is_observable<Observable>,
+            std::is_integral<Count>,
+            std::is_integral<BufferCount>,
+            is_coordination<Coordination>>,
+        class SourceValue = rxu::value_type_t<Observable>,
+        class ConcatEager = rxo::detail::concat_eager<SourceValue, rxu::decay_t<Observable>, rxu::decay_t<Coordination>>,
+        class Value = rxu::value_type_t<SourceValue>,
+        class Result = observable<Value, ConcatEager>
+    >
+    static Result member(Observable&& o, Count max_prefetch, BufferCount max_buffered, Coordination&& cn) {
+        return Result(ConcatEager(std::forward<Observable>(o), max_prefetch, max_buffered, std::forward<Coordination>(cn)));
+    }
+
+    template<class... AN>
+    static operators::detail::concat_eager_invalid_t<AN...> member(AN...) {
+        std::terminate();
+        return {};
+        static_assert(sizeof...(AN) == 10000, "concat_eager takes (MaxPrefetch, optional MaxBuffered, optional Coordination)");
+    }
+};
+
+}
+
+#endif
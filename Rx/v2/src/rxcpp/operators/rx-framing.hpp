@@ -0,0 +1,451 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+/*! \file rx-framing.hpp
+
+    \brief Recover frames from an observable of byte chunks.
+
+    The source emits chunks of bytes, such as std::string or std::vector<uint8_t>, that are cut at arbitrary points.
+    These operators find the frames in the chunks and emit each frame as a std::string. A frame that is cut by the
+    end of a chunk is carried to the next chunk. When the chunks are rxcpp::byte_slice, the frames are byte_slice too
+    and a frame that is inside one chunk shares the storage of the chunk instead of being copied.
+
+    split_on_delimiter(delimiter) emits the bytes between delimiters. The delimiter is not included in the frame.
+    The bytes after the last delimiter are emitted as a frame when the source completes.
+
+    split_lines() emits the lines of text. Lines end with '\\n', a '\\r' that precedes the '\\n' is removed.
+
+    length_prefixed_frames(prefix_size, max_frame_length) emits the payloads of frames that start with a big endian,
+    unsigned length of prefix_size bytes (default 4). A length that is longer than max_frame_length (default 64 MiB)
+    emits a std::length_error instead of waiting for the payload. When the source completes in the middle of a frame,
+    an error is emitted.
+
+    \sample
+    \code{.cpp}
+    auto packets = rxcpp::observable<>::from(std::string("ab\\r\\ncd"), std::string("e\\r\\nf"));
+    packets.
+        split_lines().
+        subscribe([](const std::string& line){ printf("%s\n", line.c_str()); });
+    \endcode
+    \code
+    ab
+    cde
+    f
+    \endcode
+*/
+
+#if !defined(RXCPP_OPERATORS_RX_FRAMING_HPP)
+#define RXCPP_OPERATORS_RX_FRAMING_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace operators {
+
+namespace detail {
+
+template<class... AN>
+struct framing_invalid_arguments {};
+
+template<class... AN>
+struct framing_invalid : public rxo::operator_base<framing_invalid_arguments<AN...>> {
+    using type = observable<framing_invalid_arguments<AN...>, framing_invalid<AN...>>;
+};
+template<class... AN>
+using framing_invalid_t = typename framing_invalid<AN...>::type;
+
+template<class Chunk>
+struct is_byte_chunk
+{
+    struct not_void {};
+    template<class CT>
+    static auto check(int) -> decltype((*(CT*)nullptr).data() + (*(CT*)nullptr).size());
+    template<class CT>
+    static not_void check(...);
+
+    typedef decltype(check<rxu::decay_t<Chunk>>(0)) pointer_type;
+    static const bool value = std::is_pointer<pointer_type>::value &&
+        sizeof(typename std::remove_pointer<pointer_type>::type) == 1;
+};
+
+template<class Chunk>
+inline const char* chunk_bytes(const Chunk& c) {
+    return reinterpret_cast<const char*>(c.data());
+}
+
+// frames are copied into a std::string
+template<class Chunk>
+struct frame_traits
+{
+    typedef std::string frame_type;
+
+    static frame_type from_chunk(const Chunk&, const char* first, const char* last) {
+        return std::string(first, last);
+    }
+    static frame_type from_partial(const char* first, const char* last) {
+        return std::string(first, last);
+    }
+};
+
+// frames that are inside one chunk share the storage of the chunk
+template<>
+struct frame_traits<byte_slice>
+{
+    typedef byte_slice frame_type;
+
+    static frame_type from_chunk(const byte_slice& chunk, const char* first, const char* last) {
+        return chunk.slice(first - chunk_bytes(chunk), last - first);
+    }
+    static frame_type from_partial(const char* first, const char* last) {
+        return byte_slice(first, last - first);
+    }
+};
+
+template<class T>
+struct split_on_delimiter
+{
+    typedef rxu::decay_t<T> source_value_type;
+    typedef frame_traits<source_value_type> traits;
+    typedef typename traits::frame_type value_type;
+
+    static_assert(is_byte_chunk<source_value_type>::value, "split_on_delimiter requires a contiguous container of bytes, such as std::string or std::vector<uint8_t>");
+
+    split_on_delimiter(char d, bool cr)
+        : delimiter(d)
+        , strip_cr(cr)
+    {
+    }
+    char delimiter;
+    bool strip_cr;
+
+    template<class Subscriber>
+    struct split_on_delimiter_observer
+    {
+        typedef split_on_delimiter_observer<Subscriber> this_type;
+        typedef rxu::decay_t<Subscriber> dest_type;
+        typedef observer<T, this_type> observer_type;
+        dest_type dest;
+        char delimiter;
+        bool strip_cr;
+        // the start of a frame that was cut by the end of a chunk.
+        // the buffer is reused, so it only allocates when a partial frame is longer than any before it.
+        mutable std::string partial;
+
+        split_on_delimiter_observer(dest_type d, char delim, bool cr)
+            : dest(std::move(d))
+            , delimiter(delim)
+            , strip_cr(cr)
+        {
+        }
+
+        const char* trim(const char* first, const char* last) const {
+            if (strip_cr && first != last && *(last - 1) == '\r') {
+                --last;
+            }
+            return last;
+        }
+        void emit_partial() const {
+            auto first = partial.data();
+            dest.on_next(traits::from_partial(first, trim(first, first + partial.size())));
+            partial.clear();
+        }
+
+        void on_next(const source_value_type& chunk) const {
+            auto cursor = chunk_bytes(chunk);
+            auto end = cursor + chunk.size();
+            while (cursor != end) {
+                auto found = static_cast<const char*>(std::memchr(cursor, delimiter, end - cursor));
+                if (!found) {
+                    partial.append(cursor, end);
+                    return;
+                }
+                if (partial.empty()) {
+                    dest.on_next(traits::from_chunk(chunk, cursor, trim(cursor, found)));
+                } else {
+                    partial.append(cursor, found);
+                    emit_partial();
+                }
+                cursor = found + 1;
+            }
+        }
+        void on_error(rxu::error_ptr e) const {
+            dest.on_error(e);
+        }
+        void on_completed() const {
+            if (!partial.empty()) {
+                emit_partial();
+            }
+            dest.on_completed();
+        }
+
+        static subscriber<T, observer_type> make(dest_type d, char delim, bool cr) {
+            auto cs = d.get_subscription();
+            return make_subscriber<T>(std::move(cs), observer_type(this_type(std::move(d), delim, cr)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(split_on_delimiter_observer<Subscriber>::make(std::move(dest), delimiter, strip_cr)) {
+        return      split_on_delimiter_observer<Subscriber>::make(std::move(dest), delimiter, strip_cr);
+    }
+};
+
+template<class T>
+struct length_prefixed_frames
+{
+    typedef rxu::decay_t<T> source_value_type;
+    typedef frame_traits<source_value_type> traits;
+    typedef typename traits::frame_type value_type;
+
+    static_assert(is_byte_chunk<source_value_type>::value, "length_prefixed_frames requires a contiguous container of bytes, such as std::string or std::vector<uint8_t>");
+
+    static const std::size_t default_max_frame_length = 64 * 1024 * 1024;
+
+    length_prefixed_frames(std::size_t p, std::size_t m)
+        : prefix_size(p)
+        // the prefix and the payload must fit in a size_t
+        , max_frame_length(std::min(m, std::numeric_limits<std::size_t>::max() - p))
+    {
+    }
+    std::size_t prefix_size;
+    std::size_t max_frame_length;
+
+    template<class Subscriber>
+    struct length_prefixed_frames_observer
+    {
+        typedef length_prefixed_frames_observer<Subscriber> this_type;
+        typedef rxu::decay_t<Subscriber> dest_type;
+        typedef observer<T, this_type> observer_type;
+        dest_type dest;
+        std::size_t prefix_size;
+        std::size_t max_frame_length;
+        // the prefix and payload of a frame that was cut by the end of a chunk
+        mutable std::string partial;
+        mutable bool failed;
+
+        length_prefixed_frames_observer(dest_type d, std::size_t p, std::size_t m)
+            : dest(std::move(d))
+            , prefix_size(p)
+            , max_frame_length(m)
+            , failed(false)
+        {
+        }
+
+        // returns false and emits an error when the length is longer than max_frame_length
+        bool frame_size(const char* prefix, std::size_t& size) const {
+            std::size_t length = 0;
+            for (std::size_t i = 0; i != prefix_size; ++i) {
+                length = (length << 8) | static_cast<unsigned char>(prefix[i]);
+            }
+            if (length > max_frame_length) {
+                failed = true;
+                partial.clear();
+                dest.on_error(rxu::make_error_ptr(std::length_error("length_prefixed_frames: the length of a frame is longer than max_frame_length")));
+                return false;
+            }
+            size = prefix_size + length;
+            return true;
+        }
+
+        void on_next(const source_value_type& chunk) const {
+            if (failed) {
+                return;
+            }
+            auto cursor = chunk_bytes(chunk);
+            auto end = cursor + chunk.size();
+            while (cursor != end) {
+                std::size_t available = end - cursor;
+                if (!partial.empty()) {
+                    if (partial.size() < prefix_size) {
+                        auto count = std::min(prefix_size - partial.size(), available);
+                        partial.append(cursor, count);
+                        cursor += count;
+                        if (partial.size() < prefix_size) {
+                            return;
+                        }
+                        available -= count;
+                    }
+                    std::size_t size = 0;
+                    if (!frame_size(partial.data(), size)) {
+                        return;
+                    }
+                    auto count = std::min(size - partial.size(), available);
+                    partial.append(cursor, count);
+                    cursor += count;
+                    if (partial.size() == size) {
+                        dest.on_next(traits::from_partial(partial.data() + prefix_size, partial.data() + partial.size()));
+                        partial.clear();
+                    }
+                    continue;
+                }
+                std::size_t size = 0;
+                if (available < prefix_size) {
+                    partial.append(cursor, end);
+                    return;
+                }
+                if (!frame_size(cursor, size)) {
+                    return;
+                }
+                if (available < size) {
+                    partial.append(cursor, end);
+                    return;
+                }
+                dest.on_next(traits::from_chunk(chunk, cursor + prefix_size, cursor + size));
+                cursor += size;
+            }
+        }
+        void on_error(rxu::error_ptr e) const {
+            dest.on_error(e);
+        }
+        void on_completed() const {
+            if (failed) {
+                return;
+            }
+            if (!partial.empty()) {
+                dest.on_error(rxu::make_error_ptr(std::runtime_error("length_prefixed_frames: the source completed in the middle of a frame")));
+                return;
+            }
+            dest.on_completed();
+        }
+
+        static subscriber<T, observer_type> make(dest_type d, std::size_t p, std::size_t m) {
+            auto cs = d.get_subscription();
+            return make_subscriber<T>(std::move(cs), observer_type(this_type(std::move(d), p, m)));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(length_prefixed_frames_observer<Subscriber>::make(std::move(dest), prefix_size, max_frame_length)) {
+        return      length_prefixed_frames_observer<Subscriber>::make(std::move(dest), prefix_size, max_frame_length);
+    }
+};
+
+}
+
+/*! @copydoc rx-framing.hpp
+*/
+template<class... AN>
+auto split_on_delimiter(AN&&... an)
+    ->     operator_factory<split_on_delimiter_tag, AN...> {
+    return operator_factory<split_on_delimiter_tag, AN...>(std::make_tuple(std::forward<AN>(an)...));
+}
+
+/*! @copydoc rx-framing.hpp
+*/
+template<class... AN>
+auto split_lines(AN&&... an)
+    ->     operator_factory<split_lines_tag, AN...> {
+    return operator_factory<split_lines_tag, AN...>(std::make_tuple(std::forward<AN>(an)...));
+}
+
+/*! @copydoc rx-framing.hpp
+*/
+template<class... AN>
+auto length_prefixed_frames(AN&&... an)
+    ->     operator_factory<length_prefixed_frames_tag, AN...> {
+    return operator_factory<length_prefixed_frames_tag, AN...>(std::make_tuple(std::forward<AN>(an)...));
+}
+
+}
+
+template<>
+struct member_overload<split_on_delimiter_tag>
+{
+    template<class Observable,
+        class Enabled = rxu::enable_if_all_true_type_t<
+            is_observable<Observable>>,
+        class SourceValue = rxu::value_type_t<Observable>,
+        class Split = rxo::detail::split_on_delimiter<SourceValue>,
+        class Value = rxu::value_type_t<Split>>
+    static auto member(Observable&& o, char delimiter)
+    -> decltype(o.template lift<Value>(Split(delimiter, false))) {
+        return  o.template lift<Value>(Split(delimiter, false));
+    }
+
+    template<class... AN>
+    static operators::detail::framing_invalid_t<AN...> member(AN...) {
+        std::terminate();
+        return {};
+        static_assert(sizeof...(AN) == 10000, "split_on_delimiter takes (char)");
+    }
+};
+
+template<>
+struct member_overload<split_lines_tag>
+{
+    template<class Observable,
+        class Enabled = rxu::enable_if_all_true_type_t<
+            is_observable<Observable>>,
+        class SourceValue = rxu::value_type_t<Observable>,
+        class Split = rxo::detail::split_on_delimiter<SourceValue>,
+        class Value = rxu::value_type_t<Split>>
+    static auto member(Observable&& o)
+    -> decltype(o.template lift<Value>(Split('\n', true))) {
+        return  o.template lift<Value>(Split('\n', true));
+    }
+
+    template<class... AN>
+    static operators::detail::framing_invalid_t<AN...> member(AN...) {
+        std::terminate();
+        return {};
+        static_assert(sizeof...(AN) == 10000, "split_lines takes no arguments");
+    }
+};
+
+template<>
+struct member_overload<length_prefixed_frames_tag>
+{
+    template<class Observable,
+        class Enabled = rxu::enable_if_all_true_type_t<
+            is_observable<Observable>>,
+        class SourceValue = rxu::value_type_t<Observable>,
+        class Frames = rxo::detail::length_prefixed_frames<SourceValue>,
+        class Value = rxu::value_type_t<Frames>>
+    static auto member(Observable&& o)
+    -> decltype(o.template lift<Value>(Frames(4, Frames::default_max_frame_length))) {
+        return  o.template lift<Value>(Frames(4, Frames::default_max_frame_length));
+    }
+
+    template<class Observable, class PrefixSize,
+        class Enabled = rxu::enable_if_all_true_type_t<
+            is_observable<Observable>,
+            std::is_integral<rxu::decay_t<PrefixSize>>>,
+        class SourceValue = rxu::value_type_t<Observable>,
+        class Frames = rxo::detail::length_prefixed_frames<SourceValue>,
+        class Value = rxu::value_type_t<Frames>>
+    static auto member(Observable&& o, PrefixSize&& prefix_size)
+    -> decltype(o.template lift<Value>(Frames(static_cast<std::size_t>(prefix_size), Frames::default_max_frame_length))) {
+        return  member(std::forward<Observable>(o), std::forward<PrefixSize>(prefix_size), static_cast<std::size_t>(Frames::default_max_frame_length));
+    }
+
+    template<class Observable, class PrefixSize, class MaxFrameLength,
+        class Enabled = rxu::enable_if_all_true_type_t<
+            is_observable<Observable>,
+            std::is_integral<rxu::decay_t<PrefixSize>>,
+            std::is_integral<rxu::decay_t<MaxFrameLength>>>,
+        class SourceValue = rxu::value_type_t<Observable>,
+        class Frames = rxo::detail::length_prefixed_frames<SourceValue>,
+        class Value = rxu::value_type_t<Frames>>
+    static auto member(Observable&& o, PrefixSize&& prefix_size, MaxFrameLength&& max_frame_length)
+    -> decltype(o.template lift<Value>(Frames(static_cast<std::size_t>(prefix_size), static_cast<std::size_t>(max_frame_length)))) {
+        if (prefix_size < 1 || static_cast<std::size_t>(prefix_size) > sizeof(std::size_t)) {
+            rxu::throw_exception(std::out_of_range("length_prefixed_frames: prefix_size must be from 1 to sizeof(std::size_t)"));
+        }
+        return  o.template lift<Value>(Frames(static_cast<std::size_t>(prefix_size), static_cast<std::size_t>(max_frame_length)));
+    }
+
+    template<class... AN>
+    static operators::detail::framing_invalid_t<AN...> member(AN...) {
+        std::terminate();
+        return {};
+        static_assert(sizeof...(AN) == 10000, "length_prefixed_frames takes (optional PrefixSize, optional MaxFrameLength)");
+    }
+};
+
+}
+
+#endif
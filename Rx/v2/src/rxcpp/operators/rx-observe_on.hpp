@@ -87,12 +87,14 @@ struct observe_on
             mutable typename mode::type current;
             coordinator_type coordinator;
             dest_type destination;
+            drain_budget budget;
 
-            observe_on_state(dest_type d, coordinator_type coor, composite_subscription cs)
+            observe_on_state(dest_type d, coordinator_type coor, composite_subscription cs, drain_budget b)
                 : lifetime(std::move(cs))
                 , current(mode::Empty)
                 , coordinator(std::move(coor))
                 , destination(std::move(d))
+                , budget(b)
             {
             }
 
@@ -128,6 +130,7 @@ struct observe_on
                     auto drain = [keepAlive, this](const rxsc::schedulable& self){
                         using std::swap;
                         RXCPP_TRY {
+                            auto meter = budget.start(self);
                             for (;;) {
                                 if (drain_queue.empty() || !destination.is_subscribed()) {
                                     std::unique_lock<std::mutex> guard(lock);
@@ -147,9 +150,11 @@ struct observe_on
                                 auto notification = std::move(drain_queue.front());
                                 drain_queue.pop_front();
                                 notification->accept(destination);
-                                std::unique_lock<std::mutex> guard(lock);
-                                self();
-                                if (lifetime.is_subscribed()) break;
+                                if (meter.spend(self) && lifetime.is_subscribed()) {
+                                    std::unique_lock<std::mutex> guard(lock);
+                                    self();
+                                    break;
+                                }
                             }
                         }
                         RXCPP_CATCH(...) {
@@ -178,8 +183,8 @@ struct observe_on
         };
         std::shared_ptr<observe_on_state> state;
 
-        observe_on_observer(dest_type d, coordinator_type coor, composite_subscription cs)
-            : state(std::make_shared<observe_on_state>(std::move(d), std::move(coor), std::move(cs)))
+        observe_on_observer(dest_type d, coordinator_type coor, composite_subscription cs, drain_budget b)
+            : state(std::make_shared<observe_on_state>(std::move(d), std::move(coor), std::move(cs), b))
         {
         }
 
@@ -206,7 +211,7 @@ struct observe_on
             auto coor = cn.create_coordinator(d.get_subscription());
             d.add(cs);
 
-            this_type o(d, std::move(coor), cs);
+            this_type o(d, std::move(coor), cs, get_drain_budget(cn));
             auto keepAlive = o.state;
             cs.add([=](){
                 std::unique_lock<std::mutex> guard(keepAlive->lock);
@@ -261,6 +266,7 @@ struct member_overload<observe_on_tag>
 class observe_on_one_worker : public coordination_base
 {
     rxsc::scheduler factory;
+    drain_budget budget;
 
     class input_type
     {
@@ -303,6 +309,7 @@ class observe_on_one_worker : public coordination_base
 public:
 
     explicit observe_on_one_worker(rxsc::scheduler sc) : factory(sc) {}
+    observe_on_one_worker(rxsc::scheduler sc, drain_budget b) : factory(sc), budget(b) {}
 
     typedef coordinator<input_type> coordinator_type;
 
@@ -310,6 +317,14 @@ public:
         return factory.now();
     }
 
+    inline rxsc::scheduler get_scheduler() const {
+        return factory;
+    }
+
+    inline drain_budget get_drain_budget() const {
+        return budget;
+    }
+
     inline coordinator_type create_coordinator(composite_subscription cs = composite_subscription()) const {
         auto w = factory.create_worker(std::move(cs));
         return coordinator_type(input_type(std::move(w)));
@@ -330,6 +345,28 @@ inline observe_on_one_worker observe_on_new_thread() {
     return r;
 }
 
+/// observe on the specified level of the default priority_loop. items from a more urgent level
+/// are delivered first when items from several levels are waiting on the loop.
+inline observe_on_one_worker observe_on_priority(rxsc::priority_level::type level) {
+    static observe_on_one_worker high(rxsc::make_priority_loop(rxsc::priority_level::high));
+    static observe_on_one_worker normal(rxsc::make_priority_loop(rxsc::priority_level::normal));
+    static observe_on_one_worker background(rxsc::make_priority_loop(rxsc::priority_level::background));
+    switch (level) {
+    case rxsc::priority_level::high:
+        return high;
+    case rxsc::priority_level::background:
+        return background;
+    default:
+        return normal;
+    }
+}
+
+/// observe on the deadline_loop with the specified latency budget. each item is given a deadline of
+/// budget after it is sent and the loop delivers the items from all pipelines earliest deadline first.
+inline observe_on_one_worker observe_on_deadline(const rxsc::deadline_loop& loop, rxsc::scheduler::clock_type::duration budget) {
+    return observe_on_one_worker(loop.get_scheduler(budget));
+}
+
 }
 
 #endif
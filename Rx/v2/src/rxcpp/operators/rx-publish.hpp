@@ -86,6 +86,35 @@ auto publish_synchronized(AN&&... an)
      return operator_factory<publish_synchronized_tag, AN...>(std::make_tuple(std::forward<AN>(an)...));
 }
 
+/*! \brief Turn a cold observable hot and give each subscriber a bounded queue that is sent on its own worker.
+
+    \tparam  Coordination  the type of the scheduler.
+
+    \param  cn        a scheduler that provides a worker for each subscriber.
+    \param  capacity  the maximum number of values queued for each subscriber.
+    \param  policy    the rxcpp::subjects::overflow_policy that decides which value is lost when a queue is full.
+    \param  cs        the subscription to control lifetime (optional).
+
+    \return  rxcpp::connectable_observable that upon connection causes the source observable to emit items to its observers.
+
+    The source sends each value by queueing it for each subscriber, so a slow subscriber only loses its own values
+    and does not delay the source or the other subscribers.
+
+    \sample
+    \code{.cpp}
+    auto values = rxcpp::observable<>::range(1, 1000).
+        publish_on(rxcpp::observe_on_new_thread(), 16, rxcpp::subjects::overflow_policy::drop_oldest);
+    values.subscribe([](int v){ printf("fast: %d\n", v); });
+    values.subscribe([](int v){ std::this_thread::sleep_for(std::chrono::milliseconds(10)); printf("slow: %d\n", v); });
+    values.connect();
+    \endcode
+*/
+template<class... AN>
+auto publish_on(AN&&... an)
+    ->      operator_factory<publish_on_tag, AN...> {
+     return operator_factory<publish_on_tag, AN...>(std::make_tuple(std::forward<AN>(an)...));
+}
+
 }
 
 template<>
@@ -159,6 +188,31 @@ struct member_overload<publish_synchronized_tag>
     }
 };
 
+template<>
+struct member_overload<publish_on_tag>
+{
+    template<class Observable, class Coordination, class Capacity,
+        class Enabled = rxu::enable_if_all_true_type_t<
+            is_observable<Observable>,
+            is_coordination<Coordination>,
+            std::is_integral<rxu::decay_t<Capacity>>>,
+        class SourceValue = rxu::value_type_t<Observable>,
+        class Subject = rxsub::dispatch<SourceValue, rxu::decay_t<Coordination>>,
+        class Multicast = rxo::detail::multicast<SourceValue, rxu::decay_t<Observable>, Subject>,
+        class Result = connectable_observable<SourceValue, Multicast>
+        >
+    static Result member(Observable&& o, Coordination&& cn, Capacity&& capacity, rxsub::overflow_policy::type policy, composite_subscription cs = composite_subscription()) {
+        return Result(Multicast(std::forward<Observable>(o), Subject(std::forward<Coordination>(cn), static_cast<std::size_t>(capacity), policy, cs)));
+    }
+
+    template<class... AN>
+    static operators::detail::publish_invalid_t<AN...> member(AN...) {
+        std::terminate();
+        return {};
+        static_assert(sizeof...(AN) == 10000, "publish_on takes (Coordination, Capacity, OverflowPolicy, optional CompositeSubscription)");
+    }
+};
+
 }
 
 #endif
@@ -123,11 +123,19 @@ namespace detail {
 
 class blocking_factory
 {
+    rxsc::wait_policy policy;
 public:
+    blocking_factory()
+    {
+    }
+    explicit blocking_factory(rxsc::wait_policy wp)
+        : policy(std::move(wp))
+    {
+    }
     template<class Observable>
     auto operator()(Observable&& source)
-        -> decltype(std::forward<Observable>(source).as_blocking()) {
-        return      std::forward<Observable>(source).as_blocking();
+        -> decltype(std::forward<Observable>(source).as_blocking(rxsc::wait_policy())) {
+        return      std::forward<Observable>(source).as_blocking(policy);
     }
 };
 
@@ -146,6 +154,17 @@ inline auto as_blocking()
     return  detail::blocking_factory();
 }
 
+/*! Return a new observable that contains the blocking methods for this observable and waits using the specified wait_policy.
+
+    \param  wp  the policy that decides how the blocking methods wait for values.
+
+    \return  An observable that contains the blocking methods for this observable.
+*/
+inline auto as_blocking(rxsc::wait_policy wp)
+    ->      detail::blocking_factory {
+    return  detail::blocking_factory(std::move(wp));
+}
+
 
 }
 
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_BYTE_SLICE_HPP)
+#define RXCPP_RX_BYTE_SLICE_HPP
+
+#include "rx-includes.hpp"
+
+namespace rxcpp {
+
+/// an immutable range of bytes in refcounted storage.
+/// copies and slices share the storage, so a byte_slice can be sent to any number of subscribers,
+/// buffered and replayed at the cost of a refcount instead of a copy of the bytes.
+/// the storage is released when the last slice that refers to it is destroyed.
+class byte_slice
+{
+    std::shared_ptr<const void> storage;
+    const uint8_t* first;
+    std::size_t length;
+
+    byte_slice(std::shared_ptr<const void> s, const uint8_t* f, std::size_t l)
+        : storage(std::move(s))
+        , first(f)
+        , length(l)
+    {
+    }
+
+    template<class Container>
+    static byte_slice adopt(Container&& c) {
+        auto owned = std::make_shared<rxu::decay_t<Container>>(std::forward<Container>(c));
+        auto f = reinterpret_cast<const uint8_t*>(owned->data());
+        auto l = owned->size();
+        return byte_slice(std::move(owned), f, l);
+    }
+
+public:
+    typedef uint8_t value_type;
+    typedef const uint8_t* const_iterator;
+    typedef const_iterator iterator;
+
+    byte_slice()
+        : first(nullptr)
+        , length(0)
+    {
+    }
+
+    /// take ownership of the bytes without a copy
+    explicit byte_slice(std::string&& s)
+        : byte_slice(adopt(std::move(s)))
+    {
+    }
+    /// take ownership of the bytes without a copy
+    explicit byte_slice(std::vector<uint8_t>&& v)
+        : byte_slice(adopt(std::move(v)))
+    {
+    }
+    /// copy the bytes into new storage
+    byte_slice(const void* p, std::size_t l)
+        : byte_slice(adopt(std::vector<uint8_t>(static_cast<const uint8_t*>(p), static_cast<const uint8_t*>(p) + l)))
+    {
+    }
+
+    const uint8_t* data() const {
+        return first;
+    }
+    std::size_t size() const {
+        return length;
+    }
+    bool empty() const {
+        return length == 0;
+    }
+    const_iterator begin() const {
+        return first;
+    }
+    const_iterator end() const {
+        return first + length;
+    }
+    uint8_t operator[](std::size_t i) const {
+        return first[i];
+    }
+
+    /// return a slice of count bytes starting at offset that shares this storage.
+    /// count is clamped to the end of this slice.
+    byte_slice slice(std::size_t offset, std::size_t count = std::numeric_limits<std::size_t>::max()) const {
+        if (offset > length) {
+            rxu::throw_exception(std::out_of_range("byte_slice::slice offset is past the end"));
+        }
+        return byte_slice(storage, first + offset, std::min(count, length - offset));
+    }
+
+    /// true when both slices refer to the same bytes of the same storage
+    bool shares(const byte_slice& other) const {
+        return storage == other.storage && first == other.first && length == other.length;
+    }
+
+    std::string to_string() const {
+        return std::string(reinterpret_cast<const char*>(first), length);
+    }
+};
+
+inline bool operator==(const byte_slice& lhs, const byte_slice& rhs) {
+    return lhs.size() == rhs.size() && (lhs.data() == rhs.data() || std::equal(lhs.begin(), lhs.end(), rhs.begin()));
+}
+inline bool operator!=(const byte_slice& lhs, const byte_slice& rhs) {
+    return !(lhs == rhs);
+}
+
+inline std::ostream& operator<<(std::ostream& out, const byte_slice& b) {
+    return out << b.to_string();
+}
+
+}
+
+#endif
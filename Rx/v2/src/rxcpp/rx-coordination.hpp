@@ -111,6 +111,82 @@ public:
     }
 };
 
+/// limits the notifications that a drain delivers in one action before it yields the
+/// worker to the other actions queued on it. the drain reschedules itself to continue.
+/// the default delivers one notification per action.
+struct drain_budget
+{
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    drain_budget()
+        : items(1)
+        , time(clock_type::duration::zero())
+    {
+    }
+    /// 0 items or a zero time is no limit
+    explicit drain_budget(std::size_t i, clock_type::duration t = clock_type::duration::zero())
+        : items(i)
+        , time(t)
+    {
+    }
+
+    /// measures one action of a drain against the budget
+    class meter
+    {
+        std::size_t items;
+        clock_type::duration time;
+        std::size_t delivered;
+        clock_type::time_point started;
+    public:
+        template<class Clock>
+        meter(std::size_t i, clock_type::duration t, const Clock& c)
+            : items(i)
+            , time(t)
+            , delivered(0)
+            , started(t > clock_type::duration::zero() ? c.now() : clock_type::time_point())
+        {
+        }
+        /// count a delivered notification and return true when the budget is spent
+        template<class Clock>
+        bool spend(const Clock& c) {
+            ++delivered;
+            return (items != 0 && delivered >= items) ||
+                (time > clock_type::duration::zero() && !(c.now() - started < time));
+        }
+    };
+
+    template<class Clock>
+    meter start(const Clock& c) const {
+        return meter(items, time, c);
+    }
+
+    std::size_t items;
+    clock_type::duration time;
+};
+
+namespace detail {
+
+template<class T, class C = rxu::types_checked>
+struct has_drain_budget : public std::false_type {};
+
+template<class T>
+struct has_drain_budget<T, typename rxu::types_checked_from<decltype((*(const T*)nullptr).get_drain_budget())>::type>
+    : public std::true_type {};
+
+}
+
+/// the drain_budget of a coordination, or the default for coordinations without one
+template<class Coordination>
+auto get_drain_budget(const Coordination& cn)
+    -> typename std::enable_if<detail::has_drain_budget<Coordination>::value, drain_budget>::type {
+    return cn.get_drain_budget();
+}
+template<class Coordination>
+auto get_drain_budget(const Coordination&)
+    -> typename std::enable_if<!detail::has_drain_budget<Coordination>::value, drain_budget>::type {
+    return drain_budget();
+}
+
 class identity_one_worker : public coordination_base
 {
     rxsc::scheduler factory;
@@ -161,6 +237,10 @@ public:
         return factory.now();
     }
 
+    inline rxsc::scheduler get_scheduler() const {
+        return factory;
+    }
+
     inline coordinator_type create_coordinator(composite_subscription cs = composite_subscription()) const {
         auto w = factory.create_worker(std::move(cs));
         return coordinator_type(input_type(std::move(w)));
@@ -290,6 +370,10 @@ public:
         return factory.now();
     }
 
+    inline rxsc::scheduler get_scheduler() const {
+        return factory;
+    }
+
     inline coordinator_type create_coordinator(composite_subscription cs = composite_subscription()) const {
         auto w = factory.create_worker(std::move(cs));
         std::shared_ptr<std::mutex> lock = std::make_shared<std::mutex>();
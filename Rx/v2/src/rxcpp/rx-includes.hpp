@@ -165,6 +165,7 @@
 #include <stdlib.h>
 
 #include <cstddef>
+#include <cstring>
 
 #include <iostream>
 #include <iomanip>
@@ -175,6 +176,7 @@
 #include <array>
 #include <vector>
 #include <algorithm>
+#include <limits>
 #include <atomic>
 #include <map>
 #include <set>
@@ -184,6 +186,7 @@
 #include <future>
 #include <list>
 #include <queue>
+#include <random>
 #include <chrono>
 #include <condition_variable>
 #include <initializer_list>
@@ -199,6 +202,7 @@
 
 #include "rx-util.hpp"
 #include "rx-predef.hpp"
+#include "rx-byte_slice.hpp"
 #include "rx-subscription.hpp"
 #include "rx-observer.hpp"
 #include "rx-scheduler.hpp"
@@ -221,6 +225,7 @@
 #include "operators/rx-buffer_time_count.hpp"
 #include "operators/rx-combine_latest.hpp"
 #include "operators/rx-concat.hpp"
+#include "operators/rx-concat_eager.hpp"
 #include "operators/rx-concat_map.hpp"
 #include "operators/rx-connect_forever.hpp"
 #include "operators/rx-debounce.hpp"
@@ -231,6 +236,7 @@
 #include "operators/rx-filter.hpp"
 #include "operators/rx-finally.hpp"
 #include "operators/rx-flat_map.hpp"
+#include "operators/rx-framing.hpp"
 #include "operators/rx-group_by.hpp"
 #include "operators/rx-ignore_elements.hpp"
 #include "operators/rx-map.hpp"
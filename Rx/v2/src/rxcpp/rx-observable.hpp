@@ -169,10 +169,11 @@ template<class T, class Observable>
 class blocking_observable
 {
     template<class Obsvbl, class... ArgN>
-    static auto blocking_subscribe(const Obsvbl& source, bool do_rethrow, ArgN&&... an)
+    static auto blocking_subscribe(const Obsvbl& source, const rxsc::wait_policy& policy, bool do_rethrow, ArgN&&... an)
         -> void {
         std::mutex lock;
         std::condition_variable wake;
+        rxsc::wait_signal signal;
         bool disposed = false;
         rxu::error_ptr error;
 
@@ -197,13 +198,14 @@ class blocking_observable
             [&](){
                 std::unique_lock<std::mutex> guard(lock);
                 disposed = true;
+                signal.notify();
                 wake.notify_one();
             });
 
         source.subscribe(std::move(scbr));
 
         std::unique_lock<std::mutex> guard(lock);
-        wake.wait(guard,
+        policy.wait(guard, wake, signal,
             [&](){
                 return disposed;
             });
@@ -214,10 +216,13 @@ class blocking_observable
 public:
     typedef rxu::decay_t<Observable> observable_type;
     observable_type source;
+    rxsc::wait_policy policy;
     ~blocking_observable()
     {
     }
     blocking_observable(observable_type s) : source(std::move(s)) {}
+    /// the blocking methods wait for the source using the specified policy
+    blocking_observable(observable_type s, rxsc::wait_policy wp) : source(std::move(s)), policy(std::move(wp)) {}
 
     ///
     /// `subscribe` will cause this observable to emit values to the provided subscriber.
@@ -237,7 +242,7 @@ public:
     template<class... ArgN>
     auto subscribe(ArgN&&... an) const
         -> void {
-        return blocking_subscribe(source, false, std::forward<ArgN>(an)...);
+        return blocking_subscribe(source, policy, false, std::forward<ArgN>(an)...);
     }
 
     ///
@@ -262,7 +267,7 @@ public:
     template<class... ArgN>
     auto subscribe_with_rethrow(ArgN&&... an) const
         -> void {
-        return blocking_subscribe(source, true, std::forward<ArgN>(an)...);
+        return blocking_subscribe(source, policy, true, std::forward<ArgN>(an)...);
     }
 
     /*! Return the first item emitted by this blocking_observable, or throw an std::runtime_error exception if it emits no items.
@@ -333,7 +338,7 @@ public:
     */
     int count() const {
         int result = 0;
-        source.count().as_blocking().subscribe_with_rethrow(
+        source.count().as_blocking(policy).subscribe_with_rethrow(
             [&](int v){result = v;});
         return result;
     }
@@ -356,7 +361,7 @@ public:
         \snippet output.txt blocking sum error sample
     */
     T sum() const {
-        return source.sum().as_blocking().last();
+        return source.sum().as_blocking(policy).last();
     }
 
     /*! Return the average value of all items emitted by this blocking_observable, or throw an std::runtime_error exception if it emits no items.
@@ -377,7 +382,7 @@ public:
         \snippet output.txt blocking average error sample
     */
     double average() const {
-        return source.average().as_blocking().last();
+        return source.average().as_blocking(policy).last();
     }
 
     /*! Return the max of all items emitted by this blocking_observable, or throw an std::runtime_error exception if it emits no items.
@@ -398,7 +403,7 @@ public:
     \snippet output.txt blocking max error sample
 */
     T max() const {
-        return source.max().as_blocking().last();
+        return source.max().as_blocking(policy).last();
     }
 
     /*! Return the min of all items emitted by this blocking_observable, or throw an std::runtime_error exception if it emits no items.
@@ -419,7 +424,162 @@ public:
     \snippet output.txt blocking min error sample
 */
     T min() const {
-        return source.min().as_blocking().last();
+        return source.min().as_blocking(policy).last();
+    }
+};
+
+/*!
+    \brief a collection of the values emitted by an observable. Its input iterators block until the next value is emitted, so it can be used with std algorithms or as a cpplinq source: `cpplinq::from(q)`.
+
+    Each call to begin() subscribes to the source, when the iterator is first read. Values that arrive faster than they are read are buffered, and the subscription is unsubscribed when the last iterator of a traversal is destroyed.
+    If the source calls on_error, the error is rethrown by the iterator after the values emitted before the error have been read.
+
+    \ingroup group-observable
+
+*/
+template<class T, class Observable>
+class observable_query
+{
+    typedef rxu::decay_t<Observable> observable_type;
+
+    struct state_type
+    {
+        explicit state_type(const observable_type& s)
+            : source(s)
+            , subscribed(false)
+            , done(false)
+        {
+        }
+        ~state_type()
+        {
+            lifetime.unsubscribe();
+        }
+
+        // waits for the next value. returns false at the end of the stream.
+        static bool wait(const std::shared_ptr<state_type>& state) {
+            std::unique_lock<std::mutex> guard(state->lock);
+            if (!state->subscribed) {
+                state->subscribed = true;
+                guard.unlock();
+                subscribe(state);
+                guard.lock();
+            }
+            state->wake.wait(guard,
+                [&](){
+                    return !state->buffer.empty() || state->done;
+                });
+            if (state->buffer.empty() && state->error) {rxu::rethrow_exception(state->error);}
+            return !state->buffer.empty();
+        }
+
+        static void subscribe(const std::shared_ptr<state_type>& state) {
+            std::weak_ptr<state_type> weak = state;
+            auto finish = [weak](rxu::error_ptr e){
+                if (auto s = weak.lock()) {
+                    std::unique_lock<std::mutex> guard(s->lock);
+                    s->error = e;
+                    s->done = true;
+                    s->wake.notify_one();
+                }
+            };
+            state->source.subscribe(
+                state->lifetime,
+                [weak](T v){
+                    if (auto s = weak.lock()) {
+                        std::unique_lock<std::mutex> guard(s->lock);
+                        s->buffer.push_back(std::move(v));
+                        s->wake.notify_one();
+                    }
+                },
+                [finish](rxu::error_ptr e){
+                    finish(e);
+                },
+                [finish](){
+                    finish(rxu::error_ptr());
+                });
+        }
+
+        observable_type source;
+        composite_subscription lifetime;
+        std::mutex lock;
+        std::condition_variable wake;
+        std::deque<T> buffer;
+        bool subscribed;
+        bool done;
+        rxu::error_ptr error;
+    };
+
+public:
+    class iterator
+    {
+        std::shared_ptr<state_type> state;
+
+        bool at_end() const {
+            return !state || !state_type::wait(state);
+        }
+
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        iterator() {}
+        explicit iterator(std::shared_ptr<state_type> s) : state(std::move(s)) {}
+
+        reference operator*() const {
+            if (at_end()) {
+                rxu::throw_exception(std::logic_error("observable_query: dereference past end"));
+            }
+            // the deque does not move its elements when values are added at the back
+            std::unique_lock<std::mutex> guard(state->lock);
+            return state->buffer.front();
+        }
+        pointer operator->() const {
+            return std::addressof(**this);
+        }
+        iterator& operator++() {
+            if (!at_end()) {
+                std::unique_lock<std::mutex> guard(state->lock);
+                state->buffer.pop_front();
+            }
+            return *this;
+        }
+        // copies share the position, so postfix increment keeps the current value in a proxy
+        class postfix_proxy
+        {
+            T value;
+        public:
+            explicit postfix_proxy(T v) : value(std::move(v)) {}
+            reference operator*() const {
+                return value;
+            }
+        };
+        postfix_proxy operator++(int) {
+            postfix_proxy result(**this);
+            ++*this;
+            return result;
+        }
+        bool operator==(const iterator& other) const {
+            return at_end() ? other.at_end() : state == other.state;
+        }
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+    };
+    typedef iterator const_iterator;
+    typedef T value_type;
+
+    observable_type source;
+
+    explicit observable_query(observable_type s) : source(std::move(s)) {}
+
+    iterator begin() const {
+        return iterator(std::make_shared<state_type>(source));
+    }
+    iterator end() const {
+        return iterator();
     }
 };
 
@@ -593,6 +753,32 @@ public:
         static_assert(sizeof...(AN) == 0, "as_blocking() was passed too many arguments.");
     }
 
+    /*! Return a blocking_observable that waits for this observable using the specified wait_policy.
+
+        \param  wp  the policy that decides how the blocking methods wait for values.
+
+        \return  blocking_observable
+    */
+    blocking_observable<T, this_type> as_blocking(rxsc::wait_policy wp) const {
+        return blocking_observable<T, this_type>(*this, std::move(wp));
+    }
+
+    /*! Returns a collection of the values emitted by this observable, whose input iterators block until the next value arrives.
+
+        \return  observable_query of the values of this observable.
+
+        \sample
+        \code{.cpp}
+        auto q = rxcpp::observable<>::range(1, 10).subscribe_on(rxcpp::observe_on_new_thread()).to_query();
+        auto evens = cpplinq::from(q).where([](int v){ return v % 2 == 0; }).to_vector();
+        \endcode
+    */
+    template<class... AN>
+    observable_query<T, this_type> to_query(AN**...) const {
+        return observable_query<T, this_type>(*this);
+        static_assert(sizeof...(AN) == 0, "to_query() was passed too many arguments.");
+    }
+
     /// \cond SHOW_SERVICE_MEMBERS
 
     ///
@@ -1057,6 +1243,17 @@ public:
         return      observable_member(concat_tag{},                *this, std::forward<AN>(an)...);
     }
 
+    /*! @copydoc rx-concat_eager.hpp
+     */
+    template<class... AN>
+    auto concat_eager(AN&&... an) const
+        /// \cond SHOW_SERVICE_MEMBERS
+        -> decltype(observable_member(concat_eager_tag{}, *(this_type*)nullptr, std::forward<AN>(an)...))
+        /// \endcond
+    {
+        return      observable_member(concat_eager_tag{},                *this, std::forward<AN>(an)...);
+    }
+
     /*! @copydoc rx-concat_map.hpp
      */
     template<class... AN>
@@ -1168,6 +1365,17 @@ public:
         return      observable_member(publish_synchronized_tag{},                *this, std::forward<AN>(an)...);
     }
 
+    /*! @copydoc rxcpp::operators::publish_on
+     */
+    template<class... AN>
+    auto publish_on(AN&&... an) const
+        /// \cond SHOW_SERVICE_MEMBERS
+        -> decltype(observable_member(publish_on_tag{}, *(this_type*)nullptr, std::forward<AN>(an)...))
+        /// \endcond
+    {
+        return      observable_member(publish_on_tag{},                *this, std::forward<AN>(an)...);
+    }
+
     /*! @copydoc rx-replay.hpp
      */
     template<class... AN>
@@ -1460,6 +1668,39 @@ public:
     {
         return      observable_member(pairwise_tag{},                *this, std::forward<AN>(an)...);
     }
+
+    /*! @copydoc rx-framing.hpp
+     */
+    template<class... AN>
+    auto split_on_delimiter(AN&&... an) const
+        /// \cond SHOW_SERVICE_MEMBERS
+        -> decltype(observable_member(split_on_delimiter_tag{}, *(this_type*)nullptr, std::forward<AN>(an)...))
+        /// \endcond
+    {
+        return      observable_member(split_on_delimiter_tag{},                *this, std::forward<AN>(an)...);
+    }
+
+    /*! @copydoc rx-framing.hpp
+     */
+    template<class... AN>
+    auto split_lines(AN&&... an) const
+        /// \cond SHOW_SERVICE_MEMBERS
+        -> decltype(observable_member(split_lines_tag{}, *(this_type*)nullptr, std::forward<AN>(an)...))
+        /// \endcond
+    {
+        return      observable_member(split_lines_tag{},                *this, std::forward<AN>(an)...);
+    }
+
+    /*! @copydoc rx-framing.hpp
+     */
+    template<class... AN>
+    auto length_prefixed_frames(AN&&... an) const
+        /// \cond SHOW_SERVICE_MEMBERS
+        -> decltype(observable_member(length_prefixed_frames_tag{}, *(this_type*)nullptr, std::forward<AN>(an)...))
+        /// \endcond
+    {
+        return      observable_member(length_prefixed_frames_tag{},                *this, std::forward<AN>(an)...);
+    }
 };
 
 template<class T, class SourceOperator>
@@ -1641,6 +1882,33 @@ public:
         -> decltype(rxs::interval(initial, period, std::move(cn))) {
         return      rxs::interval(initial, period, std::move(cn));
     }
+    /*! @copydoc rx-interval.hpp
+     */
+    template<class Coordination>
+    static auto interval(rxsc::scheduler::clock_type::duration period, rxsc::periodic_catch_up::type catch_up, Coordination cn)
+        -> decltype(rxs::interval(period, catch_up, std::move(cn))) {
+        return      rxs::interval(period, catch_up, std::move(cn));
+    }
+    /*! @copydoc rx-interval.hpp
+     */
+    template<class Coordination>
+    static auto interval(rxsc::scheduler::clock_type::time_point initial, rxsc::scheduler::clock_type::duration period, rxsc::periodic_catch_up::type catch_up, Coordination cn)
+        -> decltype(rxs::interval(initial, period, catch_up, std::move(cn))) {
+        return      rxs::interval(initial, period, catch_up, std::move(cn));
+    }
+    /*! @copydoc rx-interval.hpp
+     */
+    static auto interval(rxsc::periodic_timer timer)
+        -> decltype(rxs::interval(std::move(timer))) {
+        return      rxs::interval(std::move(timer));
+    }
+    /*! @copydoc rx-shared_ticker.hpp
+     */
+    template<class Coordination>
+    static auto shared_ticker(rxsc::scheduler::clock_type::duration period, Coordination cn)
+        -> decltype(rxs::shared_ticker(period, std::move(cn))) {
+        return      rxs::shared_ticker(period, std::move(cn));
+    }
 
     /*! @copydoc rx-timer.hpp
      */
@@ -1687,6 +1955,20 @@ public:
         -> decltype(rxs::iterate(std::move(c), std::move(cn))) {
         return      rxs::iterate(std::move(c), std::move(cn));
     }
+    /*! @copydoc rx-from_query.hpp
+     */
+    template<class Query>
+    static auto from_query(Query q, std::size_t chunk = rxs::from_query_default_chunk)
+        -> decltype(rxs::from_query(std::move(q), identity_current_thread(), chunk)) {
+        return      rxs::from_query(std::move(q), identity_current_thread(), chunk);
+    }
+    /*! @copydoc rx-from_query.hpp
+     */
+    template<class Query, class Coordination>
+    static auto from_query(Query q, Coordination cn, std::size_t chunk = rxs::from_query_default_chunk)
+        -> decltype(rxs::from_query(std::move(q), std::move(cn), chunk)) {
+        return      rxs::from_query(std::move(q), std::move(cn), chunk);
+    }
 
     /*! @copydoc rxcpp::sources::from()
      */
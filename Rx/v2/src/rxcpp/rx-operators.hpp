@@ -161,6 +161,13 @@ struct concat_tag {
     };
 };
 
+struct concat_eager_tag {
+    template<class Included>
+    struct include_header{
+        static_assert(Included::value, "missing include: please #include <rxcpp/operators/rx-concat_eager.hpp>");
+    };
+};
+
 struct concat_map_tag {
     template<class Included>
     struct include_header{
@@ -224,6 +231,15 @@ struct finally_tag {
     };
 };
 
+struct split_on_delimiter_tag {
+    template<class Included>
+    struct include_header{
+        static_assert(Included::value, "missing include: please #include <rxcpp/operators/rx-framing.hpp>");
+    };
+};
+struct split_lines_tag : split_on_delimiter_tag {};
+struct length_prefixed_frames_tag : split_on_delimiter_tag {};
+
 struct flat_map_tag {
     template<class Included>
     struct include_header{
@@ -327,6 +343,7 @@ struct publish_tag {
     };
 };
 struct publish_synchronized_tag : publish_tag {};
+struct publish_on_tag : publish_tag {};
     
 struct repeat_tag {
     template<class Included>
@@ -176,8 +176,42 @@ public:
     virtual void schedule(clock_type::time_point when, const schedulable& scbl) const = 0;
 };
 
+/// what schedule_periodically does when an occurance is run late enough that one or more periods have passed
+struct periodic_catch_up
+{
+    enum type {
+        /// run once for each missed occurance, back to back
+        burst,
+        /// drop the missed occurances and wait for the next one that is due in the future
+        skip,
+        /// run once for all of the missed occurances and then wait for the next one
+        coalesce
+    };
+};
+
 namespace detail {
 
+/// return the next occurance after target, measured from the same origin so that it does not drift.
+inline scheduler_base::clock_type::time_point next_periodic_target(
+    scheduler_base::clock_type::time_point target,
+    scheduler_base::clock_type::duration period,
+    scheduler_base::clock_type::time_point now,
+    periodic_catch_up::type catch_up)
+{
+    target += period;
+    if (catch_up == periodic_catch_up::burst || period <= scheduler_base::clock_type::duration::zero() || !(target < now)) {
+        return target;
+    }
+    auto late = now - target;
+    auto missed = late / period;
+    if (catch_up == periodic_catch_up::coalesce) {
+        // the most recent occurance that is due
+        return target + (missed * period);
+    }
+    // the first occurance that is not in the past
+    return target + ((missed + ((late % period) != scheduler_base::clock_type::duration::zero() ? 1 : 0)) * period);
+}
+
 template<class F>
 struct is_action_function
 {
@@ -289,6 +323,22 @@ public:
         schedule_periodically_rebind(now() + initial, period, scbl);
     }
 
+    /// insert the supplied schedulable to be run at the initial time specified and then again at initial + (N * period)
+    /// when an occurance is run late, catch_up selects whether the missed occurances are run, skipped or coalesced into one.
+    /// this will continue until the worker or schedulable is unsubscribed.
+    inline void schedule_periodically(clock_type::time_point initial, clock_type::duration period, periodic_catch_up::type catch_up, const schedulable& scbl) const {
+        // force rebinding scbl to this worker
+        schedule_periodically_rebind(initial, period, catch_up, scbl);
+    }
+
+    /// insert the supplied schedulable to be run at now() + the initial delay specified and then again at now() + initial + (N * period)
+    /// when an occurance is run late, catch_up selects whether the missed occurances are run, skipped or coalesced into one.
+    /// this will continue until the worker or schedulable is unsubscribed.
+    inline void schedule_periodically(clock_type::duration initial, clock_type::duration period, periodic_catch_up::type catch_up, const schedulable& scbl) const {
+        // force rebinding scbl to this worker
+        schedule_periodically_rebind(now() + initial, period, catch_up, scbl);
+    }
+
     /// use the supplied arguments to make a schedulable and then insert it to be run
     template<class Arg0, class... ArgN>
     auto schedule(Arg0&& a0, ArgN&&... an) const
@@ -319,8 +369,18 @@ public:
             is_subscription<Arg0>::value) &&
             !is_schedulable<Arg0>::value>::type;
     /// use the supplied arguments to make a schedulable and then insert it to be run
+    template<class Arg0, class... ArgN>
+    auto schedule_periodically(clock_type::time_point initial, clock_type::duration period, periodic_catch_up::type catch_up, Arg0&& a0, ArgN&&... an) const
+        -> typename std::enable_if<
+            (detail::is_action_function<Arg0>::value ||
+            is_subscription<Arg0>::value) &&
+            !is_schedulable<Arg0>::value>::type;
+    /// use the supplied arguments to make a schedulable and then insert it to be run
     template<class... ArgN>
     void schedule_periodically_rebind(clock_type::time_point initial, clock_type::duration period, const schedulable& scbl, ArgN&&... an) const;
+    /// use the supplied arguments to make a schedulable and then insert it to be run
+    template<class... ArgN>
+    void schedule_periodically_rebind(clock_type::time_point initial, clock_type::duration period, periodic_catch_up::type catch_up, const schedulable& scbl, ArgN&&... an) const;
 };
 
 inline bool operator==(const worker& lhs, const worker& rhs) {
@@ -414,6 +474,13 @@ public:
     }
 };
 
+inline bool operator==(const scheduler& lhs, const scheduler& rhs) {
+    return lhs.inner == rhs.inner;
+}
+inline bool operator!=(const scheduler& lhs, const scheduler& rhs) {
+    return !(lhs == rhs);
+}
+
 template<class Scheduler, class... ArgN>
 inline scheduler make_scheduler(ArgN&&... an) {
     return scheduler(std::static_pointer_cast<scheduler_interface>(std::make_shared<Scheduler>(std::forward<ArgN>(an)...)));
@@ -843,21 +910,36 @@ auto worker::schedule_periodically(clock_type::time_point initial, clock_type::d
         !is_schedulable<Arg0>::value>::type {
     schedule_periodically_rebind(initial, period, make_schedulable(*this, std::forward<Arg0>(a0), std::forward<ArgN>(an)...));
 }
+template<class Arg0, class... ArgN>
+auto worker::schedule_periodically(clock_type::time_point initial, clock_type::duration period, periodic_catch_up::type catch_up, Arg0&& a0, ArgN&&... an) const
+    -> typename std::enable_if<
+        (detail::is_action_function<Arg0>::value ||
+        is_subscription<Arg0>::value) &&
+        !is_schedulable<Arg0>::value>::type {
+    schedule_periodically_rebind(initial, period, catch_up, make_schedulable(*this, std::forward<Arg0>(a0), std::forward<ArgN>(an)...));
+}
 template<class... ArgN>
 void worker::schedule_periodically_rebind(clock_type::time_point initial, clock_type::duration period, const schedulable& scbl, ArgN&&... an) const {
+    schedule_periodically_rebind(initial, period, periodic_catch_up::burst, scbl, std::forward<ArgN>(an)...);
+}
+template<class... ArgN>
+void worker::schedule_periodically_rebind(clock_type::time_point initial, clock_type::duration period, periodic_catch_up::type catch_up, const schedulable& scbl, ArgN&&... an) const {
     auto keepAlive = *this;
     auto target = std::make_shared<clock_type::time_point>(initial);
     auto activity = make_schedulable(scbl, keepAlive, std::forward<ArgN>(an)...);
     auto periodic = make_schedulable(
         activity,
-        [keepAlive, target, period, activity](schedulable self) {
+        [keepAlive, target, period, catch_up, activity](schedulable self) {
             // any recursion requests will be pushed to the scheduler queue
             recursion r(false);
             // call action
             activity(r.get_recurse());
 
-            // schedule next occurance (if the action took longer than 'period' target will be in the past)
-            *target += period;
+            // schedule next occurance. the target is always initial + (N * period), so
+            // a late occurance does not delay the ones after it. if the action took
+            // longer than 'period' target will be in the past and catch_up decides how
+            // many of the missed occurances are run.
+            *target = detail::next_periodic_target(*target, period, keepAlive.now(), catch_up);
             self.schedule(*target);
         });
     trace_activity().schedule_when_enter(*inner.get(), *target, periodic);
@@ -882,65 +964,250 @@ struct time_schedulable
 };
 
 
+// orders the items of a schedulable_queue by when
+struct earlier_when
+{
+    template<class Item>
+    bool operator()(const Item& lhs, const Item& rhs) const {
+        return lhs.when < rhs.when;
+    }
+};
+
 // Sorts time_schedulable items in priority order sorted
 // on value of time_schedulable.when. Items with equal
-// values for when are sorted in fifo order.
-template<class TimePoint>
+// values for when are sorted in fifo order. Loops that
+// keep other times with their items pass their own Item,
+// which has a 'what' schedulable, and an Earlier that
+// orders the items by one of those times.
+// Items that are unsubscribed while queued are removed
+// when the queue grows to twice the size it had after the
+// last removal, so the queue does not fill with cancelled
+// timers that are far from the top. Timers pushed with
+// push_timer are also counted when they are cancelled, and
+// the loop is notified once they are half of the queue, so
+// that it removes them with compact_cancelled before it
+// waits. The storage is released when the queue drops to a
+// quarter of its capacity.
+template<class TimePoint, class Item = time_schedulable<TimePoint>, class Earlier = earlier_when>
 class schedulable_queue {
 public:
-    typedef time_schedulable<TimePoint> item_type;
-    typedef std::pair<item_type, int64_t> elem_type;
-    typedef std::vector<elem_type> container_type;
+    typedef Item item_type;
     typedef const item_type& const_reference;
 
+    // the smallest size that is compacted
+    enum { compact_minimum = 64 };
+
 private:
+    struct elem_type
+    {
+        elem_type(item_type i, int64_t o)
+            : item(std::move(i))
+            , ordinal(o)
+            , watched(false)
+        {
+        }
+        item_type item;
+        int64_t ordinal;
+        // the callback that counts the cancellation of a timer
+        bool watched;
+        composite_subscription::weak_subscription watch;
+    };
+    typedef std::vector<elem_type> container_type;
+
     struct compare_elem
     {
         bool operator()(const elem_type& lhs, const elem_type& rhs) const {
-            if (lhs.first.when == rhs.first.when) {
-                return lhs.second > rhs.second;
+            Earlier earlier;
+            if (earlier(rhs.item, lhs.item)) {
+                return true;
             }
-            else {
-                return lhs.first.when > rhs.first.when;
+            else if (earlier(lhs.item, rhs.item)) {
+                return false;
             }
+            return lhs.ordinal > rhs.ordinal;
         }
     };
 
-    typedef std::priority_queue<
+    struct queue_type : public std::priority_queue<
         elem_type,
         container_type,
         compare_elem
-    > queue_type;
+    >
+    {
+        // remove the items that are unsubscribed, restore the heap
+        // and release the storage that is far beyond the size.
+        // returns the number of timers that were removed
+        std::size_t compact() {
+            auto& c = this->c;
+            std::size_t timers = 0;
+            c.erase(std::remove_if(c.begin(), c.end(), [&](const elem_type& e){
+                    if (e.item.what.is_subscribed()) {
+                        return false;
+                    }
+                    timers += e.watched ? 1 : 0;
+                    return true;
+                }), c.end());
+            std::make_heap(c.begin(), c.end(), this->comp);
+            if (oversized()) {
+                container_type shrunk;
+                shrunk.reserve(std::max<std::size_t>(compact_minimum, c.size() * 2));
+                for (auto& e : c) {
+                    shrunk.push_back(std::move(e));
+                }
+                c.swap(shrunk);
+            }
+            return timers;
+        }
+
+        std::size_t capacity() const {
+            return this->c.capacity();
+        }
+
+        // the capacity is more than twice what compact keeps
+        bool oversized() const {
+            return this->c.capacity() > 2 * std::max<std::size_t>(compact_minimum, this->c.size() * 2);
+        }
+    };
+
+    // shared with the callbacks that count the cancelled timers, which may run on any thread
+    struct cancel_state
+    {
+        cancel_state()
+            : count(0)
+            , threshold(compact_minimum)
+            , notified(false)
+        {
+        }
+        std::atomic<std::size_t> count;
+        std::atomic<std::size_t> threshold;
+        std::atomic<bool> notified;
+        // the thread in push_timer, which notifies the loop itself after the push
+        std::atomic<std::thread::id> pusher;
+        std::function<void()> notify;
+    };
 
     queue_type q;
 
     int64_t ordinal;
+    std::size_t compact_at;
+    std::shared_ptr<cancel_state> cancelled;
+
+    void maybe_compact() {
+        if (q.size() >= compact_at) {
+            compact();
+        }
+    }
+
+    // the callback of a removed timer may still be running on the thread
+    // that unsubscribed it, so the count is not allowed to wrap
+    void release_cancelled(std::size_t removed) {
+        auto count = cancelled->count.load();
+        while (!cancelled->count.compare_exchange_weak(count, count > removed ? count - removed : 0)) {
+        }
+    }
+
+    std::size_t compact_timers() {
+        auto removed = q.compact();
+        release_cancelled(removed);
+        compact_at = std::max<std::size_t>(compact_minimum, q.size() * 2);
+        cancelled->notified = false;
+        update_threshold();
+        return removed;
+    }
+
+    void update_threshold() {
+        cancelled->threshold = std::max<std::size_t>(compact_minimum, q.size() / 2);
+    }
 public:
 
     schedulable_queue() 
         : ordinal(0) 
+        , compact_at(compact_minimum)
+        , cancelled(std::make_shared<cancel_state>())
     {
     }
 
     const_reference top() const {
-        return q.top().first;
+        return q.top().item;
     }
 
     void pop() {
+        auto& e = q.top();
+        if (e.watched) {
+            if (e.item.what.is_subscribed()) {
+                e.item.what.get_subscription().remove(e.watch);
+            } else {
+                release_cancelled(1);
+            }
+        }
         q.pop();
+        if (q.oversized()) {
+            compact();
+        }
     }
 
     bool empty() const {
         return q.empty();
     }
 
+    std::size_t size() const {
+        return q.size();
+    }
+
+    std::size_t capacity() const {
+        return q.capacity();
+    }
+
     void push(const item_type& value) {
+        maybe_compact();
         q.push(elem_type(value, ordinal++));
     }
 
     void push(item_type&& value) {
+        maybe_compact();
         q.push(elem_type(std::move(value), ordinal++));
     }
+
+    /// push an item that may wait far from the top. if it is unsubscribed while
+    /// queued it is counted, and notify is called once the cancelled timers are
+    /// half of the queue
+    void push_timer(item_type value) {
+        maybe_compact();
+        elem_type e(std::move(value), ordinal++);
+        auto st = cancelled;
+        st->pusher = std::this_thread::get_id();
+        e.watch = e.item.what.get_subscription().add([st](){
+            if (++st->count >= st->threshold && st->pusher.load() != std::this_thread::get_id() &&
+                !st->notified.exchange(true) && st->notify) {
+                st->notify();
+            }
+        });
+        st->pusher = std::thread::id();
+        e.watched = true;
+        q.push(std::move(e));
+        update_threshold();
+    }
+
+    /// called on the thread that cancels a timer, once enough timers are cancelled
+    /// that the loop should call compact_cancelled. it is not called for a timer
+    /// that is cancelled while push_timer adds its callback, so it may take the
+    /// lock of the loop
+    void set_notify_cancelled(std::function<void()> notify) {
+        cancelled->notify = std::move(notify);
+    }
+
+    /// remove the cancelled timers when they are at least half of the queue.
+    /// loops call this before they wait for the top item
+    void compact_cancelled() {
+        // timers that are cancelled while the queue is compacted are counted after it
+        while (cancelled->count >= cancelled->threshold && compact_timers() != 0) {
+        }
+    }
+
+    /// remove the items that are unsubscribed and release the unused storage
+    void compact() {
+        compact_timers();
+    }
 };
 
 }
@@ -950,6 +1217,7 @@ namespace rxsc=schedulers;
 
 }
 
+#include "schedulers/rx-waitpolicy.hpp"
 #include "schedulers/rx-currentthread.hpp"
 #include "schedulers/rx-runloop.hpp"
 #include "schedulers/rx-newthread.hpp"
@@ -957,5 +1225,8 @@ namespace rxsc=schedulers;
 #include "schedulers/rx-immediate.hpp"
 #include "schedulers/rx-virtualtime.hpp"
 #include "schedulers/rx-sameworker.hpp"
+#include "schedulers/rx-periodictimer.hpp"
+#include "schedulers/rx-priorityloop.hpp"
+#include "schedulers/rx-deadlineloop.hpp"
 
 #endif
@@ -38,7 +38,9 @@ namespace rxs=sources;
 #include "sources/rx-create.hpp"
 #include "sources/rx-range.hpp"
 #include "sources/rx-iterate.hpp"
+#include "sources/rx-from_query.hpp"
 #include "sources/rx-interval.hpp"
+#include "sources/rx-shared_ticker.hpp"
 #include "sources/rx-empty.hpp"
 #include "sources/rx-defer.hpp"
 #include "sources/rx-never.hpp"
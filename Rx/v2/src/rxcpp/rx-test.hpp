@@ -133,5 +133,7 @@ auto operator | (const rxcpp::test::testable_observable<T>& source, OperatorFact
 }
 
 #include "schedulers/rx-test.hpp"
+#include "schedulers/rx-fasttest.hpp"
+#include "schedulers/rx-simulation.hpp"
 
 #endif
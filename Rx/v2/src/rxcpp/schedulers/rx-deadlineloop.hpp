@@ -0,0 +1,303 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_SCHEDULER_DEADLINE_LOOP_HPP)
+#define RXCPP_RX_SCHEDULER_DEADLINE_LOOP_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace schedulers {
+
+/// describes an item that was started after its deadline
+struct deadline_miss
+{
+    typedef scheduler_base::clock_type clock_type;
+
+    deadline_miss(clock_type::time_point d, clock_type::time_point s)
+        : deadline(d)
+        , started(s)
+    {
+    }
+
+    clock_type::duration lateness() const {
+        return started - deadline;
+    }
+
+    clock_type::time_point deadline;
+    clock_type::time_point started;
+};
+
+/// a deadline_loop runs the items of all its workers on one thread in earliest deadline first order.
+/// each scheduler of the loop has a latency budget; the deadline of an item is the time it was
+/// scheduled for plus the budget of the scheduler that created its worker.
+/// items that are due are run in order of deadline, then in the order that they were scheduled.
+/// when an item is started after its deadline the miss is counted and reported to the
+/// handler passed to the loop. the handler is called on the loop thread before the item is run.
+class deadline_loop
+{
+    typedef deadline_loop this_type;
+    typedef scheduler_base::clock_type clock_type;
+
+public:
+    typedef std::function<void(const deadline_miss&)> miss_handler;
+
+private:
+    struct deadline_item
+    {
+        deadline_item(clock_type::time_point w, clock_type::time_point d, schedulable s)
+            : when(w)
+            , deadline(d)
+            , what(std::move(s))
+        {
+        }
+        clock_type::time_point when;
+        clock_type::time_point deadline;
+        schedulable what;
+    };
+
+    struct earlier_deadline
+    {
+        bool operator()(const deadline_item& lhs, const deadline_item& rhs) const {
+            return lhs.deadline < rhs.deadline;
+        }
+    };
+
+    struct loop_state : public std::enable_shared_from_this<loop_state>
+    {
+        // the waiting items are sorted by when
+        typedef detail::schedulable_queue<
+            clock_type::time_point, deadline_item> queue_item_time;
+
+        // the ready items are sorted by deadline
+        typedef detail::schedulable_queue<
+            clock_type::time_point, deadline_item, earlier_deadline> queue_item_deadline;
+
+        explicit loop_state(miss_handler mh)
+            : on_miss(std::move(mh))
+            , missed(0)
+        {
+        }
+
+        composite_subscription lifetime;
+        miss_handler on_miss;
+        mutable std::mutex lock;
+        mutable std::condition_variable wake;
+        queue_item_time waiting;
+        queue_item_deadline ready;
+        std::atomic<std::size_t> missed;
+        std::thread worker;
+        recursion r;
+
+        bool empty() const {
+            return waiting.empty() && ready.empty();
+        }
+
+        // move the items that are due to the ready queue
+        void release(clock_type::time_point now) {
+            while (!waiting.empty() && !(now < waiting.top().when)) {
+                auto& top = waiting.top();
+                if (top.what.is_subscribed()) {
+                    ready.push(top);
+                }
+                waiting.pop();
+            }
+            while (!ready.empty() && !ready.top().what.is_subscribed()) {
+                ready.pop();
+            }
+        }
+    };
+
+    struct budget_worker : public worker_interface
+    {
+    private:
+        typedef budget_worker this_type;
+        budget_worker(const this_type&);
+
+        std::shared_ptr<loop_state> state;
+        clock_type::duration budget;
+
+    public:
+        virtual ~budget_worker()
+        {
+        }
+        budget_worker(std::shared_ptr<loop_state> ls, clock_type::duration b)
+            : state(std::move(ls))
+            , budget(b)
+        {
+        }
+
+        virtual clock_type::time_point now() const {
+            return clock_type::now();
+        }
+
+        virtual void schedule(const schedulable& scbl) const {
+            schedule(now(), scbl);
+        }
+
+        virtual void schedule(clock_type::time_point when, const schedulable& scbl) const {
+            if (scbl.is_subscribed()) {
+                bool timer = now() < when;
+                std::unique_lock<std::mutex> guard(state->lock);
+                if (timer) {
+                    state->waiting.push_timer(deadline_item(when, when + budget, scbl));
+                } else {
+                    state->waiting.push(deadline_item(when, when + budget, scbl));
+                }
+                state->r.reset(false);
+            }
+            state->wake.notify_one();
+        }
+    };
+
+    // stops the thread when the loop and all of its schedulers are gone
+    struct loop_owner
+    {
+        explicit loop_owner(std::shared_ptr<loop_state> ls)
+            : state(std::move(ls))
+        {
+        }
+        ~loop_owner()
+        {
+            state->lifetime.unsubscribe();
+        }
+        std::shared_ptr<loop_state> state;
+    };
+
+    struct budget_scheduler : public scheduler_interface
+    {
+    private:
+        typedef budget_scheduler this_type;
+        budget_scheduler(const this_type&);
+
+        std::shared_ptr<loop_owner> owner;
+        clock_type::duration budget;
+
+    public:
+        budget_scheduler(std::shared_ptr<loop_owner> o, clock_type::duration b)
+            : owner(std::move(o))
+            , budget(b)
+        {
+        }
+        virtual ~budget_scheduler()
+        {
+        }
+
+        virtual clock_type::time_point now() const {
+            return clock_type::now();
+        }
+
+        virtual worker create_worker(composite_subscription cs) const {
+            return worker(std::move(cs), std::make_shared<budget_worker>(owner->state, budget));
+        }
+    };
+
+    std::shared_ptr<loop_owner> owner;
+
+    void start(thread_factory& tf) {
+        auto keepAlive = owner->state;
+
+        // wake the thread to remove the cancelled timers
+        std::weak_ptr<loop_state> weak = keepAlive;
+        keepAlive->waiting.set_notify_cancelled([weak](){
+            if (auto st = weak.lock()) {
+                std::unique_lock<std::mutex> guard(st->lock);
+                st->wake.notify_one();
+            }
+        });
+
+        keepAlive->lifetime.add([keepAlive](){
+            std::unique_lock<std::mutex> guard(keepAlive->lock);
+            keepAlive->waiting = loop_state::queue_item_time{};
+            keepAlive->ready = loop_state::queue_item_deadline{};
+            keepAlive->wake.notify_one();
+
+            if (keepAlive->worker.joinable() && keepAlive->worker.get_id() != std::this_thread::get_id()) {
+                guard.unlock();
+                keepAlive->worker.join();
+            }
+            else {
+                keepAlive->worker.detach();
+            }
+        });
+
+        keepAlive->worker = tf([keepAlive](){
+
+            // take ownership
+            detail::action_queue::ensure(std::make_shared<budget_worker>(keepAlive, clock_type::duration::zero()));
+            // release ownership
+            RXCPP_UNWIND_AUTO([]{
+                detail::action_queue::destroy();
+            });
+
+            for(;;) {
+                std::unique_lock<std::mutex> guard(keepAlive->lock);
+                if (keepAlive->empty()) {
+                    keepAlive->wake.wait(guard, [keepAlive](){
+                        return !keepAlive->lifetime.is_subscribed() || !keepAlive->empty();
+                    });
+                }
+                if (!keepAlive->lifetime.is_subscribed()) {
+                    break;
+                }
+                auto now = clock_type::now();
+                keepAlive->release(now);
+                if (keepAlive->ready.empty()) {
+                    if (!keepAlive->waiting.empty()) {
+                        // copy the time, a push while waiting may reallocate the queue
+                        auto when = keepAlive->waiting.top().when;
+                        keepAlive->waiting.compact_cancelled();
+                        keepAlive->wake.wait_until(guard, when);
+                    }
+                    continue;
+                }
+                auto deadline = keepAlive->ready.top().deadline;
+                auto what = keepAlive->ready.top().what;
+                keepAlive->ready.pop();
+                keepAlive->r.reset(keepAlive->empty());
+                guard.unlock();
+                if (deadline < now) {
+                    ++keepAlive->missed;
+                    if (keepAlive->on_miss) {
+                        keepAlive->on_miss(deadline_miss(deadline, now));
+                    }
+                }
+                what(keepAlive->r.get_recurse());
+            }
+        });
+    }
+
+public:
+    explicit deadline_loop(miss_handler on_miss = miss_handler())
+        : owner(std::make_shared<loop_owner>(std::make_shared<loop_state>(std::move(on_miss))))
+    {
+        thread_factory tf([](std::function<void()> start){
+            return std::thread(std::move(start));
+        });
+        start(tf);
+    }
+    deadline_loop(thread_factory tf, miss_handler on_miss = miss_handler())
+        : owner(std::make_shared<loop_owner>(std::make_shared<loop_state>(std::move(on_miss))))
+    {
+        start(tf);
+    }
+
+    /// return a scheduler whose workers give each item a deadline of budget after it is due.
+    /// the loop runs as long as this or any of its schedulers exist.
+    scheduler get_scheduler(clock_type::duration budget) const {
+        return make_scheduler<budget_scheduler>(owner, budget);
+    }
+
+    /// the number of items that were started after their deadline
+    std::size_t missed() const {
+        return owner->state->missed;
+    }
+};
+
+}
+
+}
+
+#endif
@@ -66,22 +66,27 @@ private:
     composite_subscription loops_lifetime;
     std::vector<worker> loops;
 
+    static std::thread start_thread(std::function<void()> start) {
+        return std::thread(std::move(start));
+    }
+
 public:
     event_loop()
-        : factory([](std::function<void()> start){
-            return std::thread(std::move(start));
-        })
-        , newthread(make_new_thread())
-        , count(0)
+        : event_loop(&start_thread, wait_policy())
     {
-        auto remaining = std::max(std::thread::hardware_concurrency(), unsigned(4));
-        while (remaining--) {
-            loops.push_back(newthread.create_worker(loops_lifetime));
-        }
     }
     explicit event_loop(thread_factory tf)
+        : event_loop(std::move(tf), wait_policy())
+    {
+    }
+    /// the loops wait for new items using the specified policy
+    explicit event_loop(wait_policy wp)
+        : event_loop(&start_thread, std::move(wp))
+    {
+    }
+    event_loop(thread_factory tf, wait_policy wp)
         : factory(tf)
-        , newthread(make_new_thread(tf))
+        , newthread(make_new_thread(tf, std::move(wp)))
         , count(0)
     {
         auto remaining = std::max(std::thread::hardware_concurrency(), unsigned(4));
@@ -110,6 +115,12 @@ inline scheduler make_event_loop() {
 inline scheduler make_event_loop(thread_factory tf) {
     return make_scheduler<event_loop>(tf);
 }
+inline scheduler make_event_loop(wait_policy wp) {
+    return make_scheduler<event_loop>(std::move(wp));
+}
+inline scheduler make_event_loop(thread_factory tf, wait_policy wp) {
+    return make_scheduler<event_loop>(tf, std::move(wp));
+}
 
 }
 
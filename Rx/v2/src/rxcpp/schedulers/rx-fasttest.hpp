@@ -0,0 +1,265 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_SCHEDULER_FAST_TEST_HPP)
+#define RXCPP_RX_SCHEDULER_FAST_TEST_HPP
+
+#include "../rx-includes.hpp"
+#include "rx-virtualclock.hpp"
+
+namespace rxcpp {
+
+namespace schedulers {
+
+/// the counts, times and hash of the notifications received by a summary subscriber.
+/// two runs that send the same values at the same times have equal summaries.
+struct notification_summary
+{
+    notification_summary()
+        : next_count(0)
+        , error_count(0)
+        , completed_count(0)
+        , first_next(-1)
+        , last_next(-1)
+        , terminated(-1)
+        , hash(0)
+    {
+    }
+
+    std::size_t next_count;
+    std::size_t error_count;
+    std::size_t completed_count;
+    /// the clock of the first and last on_next, -1 when there was none
+    long first_next;
+    long last_next;
+    /// the clock of the on_error or on_completed, -1 when there was none
+    long terminated;
+    /// the combined hash of the time and value of each on_next, in order
+    std::size_t hash;
+
+    void combine(std::size_t h) {
+        hash ^= h + static_cast<std::size_t>(0x9e3779b97f4a7c15ull) + (hash << 6) + (hash >> 2);
+    }
+};
+
+inline bool operator==(const notification_summary& lhs, const notification_summary& rhs) {
+    return lhs.next_count == rhs.next_count &&
+        lhs.error_count == rhs.error_count &&
+        lhs.completed_count == rhs.completed_count &&
+        lhs.first_next == rhs.first_next &&
+        lhs.last_next == rhs.last_next &&
+        lhs.terminated == rhs.terminated &&
+        lhs.hash == rhs.hash;
+}
+inline bool operator!=(const notification_summary& lhs, const notification_summary& rhs) {
+    return !(lhs == rhs);
+}
+
+inline std::ostream& operator<<(std::ostream& out, const notification_summary& s) {
+    return out << "{next: " << s.next_count << " @" << s.first_next << "-" << s.last_next
+        << ", error: " << s.error_count << ", completed: " << s.completed_count << " @" << s.terminated
+        << ", hash: " << s.hash << "}";
+}
+
+/// fast_test is a virtual time scheduler for replaying large schedules, where rxsc::test is too slow.
+/// items that have not run are released when the fast_test and all of its copies are destroyed.
+/// the clock is a count of milliseconds, as in rxsc::test, but
+///  - an item scheduled for now runs at the current clock, not one tick later.
+///  - items are run from one queue without the extra schedulable that test makes for each item.
+///  - make_timed_source keeps one item in the queue for each subscription, instead of one for each message,
+///    and sends all the messages that are due in that item.
+///  - make_summary_subscriber records counts and a hash instead of a vector of notifications.
+class fast_test : public scheduler
+{
+public:
+    typedef scheduler_base::clock_type clock_type;
+
+private:
+    struct fast_test_state : public detail::virtual_clock_state<fast_test_state>
+    {
+        typedef detail::schedulable_queue<long> queue_item_time;
+
+        queue_item_time q;
+        recursion r;
+
+        bool pop_due(long time, long& when, schedulable& what) {
+            if (q.empty() || time < q.top().when) {
+                return false;
+            }
+            when = q.top().when;
+            what = q.top().what;
+            q.pop();
+            return true;
+        }
+
+        void run(const schedulable& what) {
+            r.reset(q.empty());
+            what(r.get_recurse());
+        }
+
+        void clear() {
+            q = queue_item_time{};
+        }
+    };
+
+    struct fast_test_worker : public worker_interface
+    {
+        std::shared_ptr<fast_test_state> state;
+
+        explicit fast_test_worker(std::shared_ptr<fast_test_state> st)
+            : state(std::move(st))
+        {
+        }
+
+        virtual clock_type::time_point now() const {
+            return state->to_time_point(state->clock_now);
+        }
+
+        virtual void schedule(const schedulable& scbl) const {
+            state->q.push(fast_test_state::queue_item_time::item_type(state->clock_now, scbl));
+            state->r.reset(false);
+        }
+
+        virtual void schedule(clock_type::time_point when, const schedulable& scbl) const {
+            state->q.push(fast_test_state::queue_item_time::item_type(state->due(when), scbl));
+            state->r.reset(false);
+        }
+    };
+
+    struct fast_test_type : public scheduler_interface
+    {
+        std::shared_ptr<fast_test_state> state;
+
+        explicit fast_test_type(std::shared_ptr<fast_test_state> st)
+            : state(std::move(st))
+        {
+        }
+
+        virtual clock_type::time_point now() const {
+            return state->to_time_point(state->clock_now);
+        }
+
+        virtual worker create_worker(composite_subscription cs) const {
+            return worker(std::move(cs), std::make_shared<fast_test_worker>(state));
+        }
+    };
+
+    typedef detail::virtual_clock_owner<fast_test_state> fast_test_owner;
+
+    std::shared_ptr<fast_test_owner> owner;
+    std::shared_ptr<fast_test_state> state;
+
+    explicit fast_test(std::shared_ptr<fast_test_state> st)
+        : scheduler(std::static_pointer_cast<scheduler_interface>(std::make_shared<fast_test_type>(st)))
+        , owner(std::make_shared<fast_test_owner>(st))
+        , state(std::move(st))
+    {
+    }
+
+public:
+    fast_test()
+        : fast_test(std::make_shared<fast_test_state>())
+    {
+    }
+
+    long clock() const {
+        return state->clock_now;
+    }
+
+    clock_type::time_point to_time_point(long absolute) const {
+        return state->to_time_point(absolute);
+    }
+
+    /// the number of items that have been run
+    std::size_t executed() const {
+        return state->executed;
+    }
+
+    /// the number of items in the queue, including items that are unsubscribed
+    std::size_t pending() const {
+        return state->q.size();
+    }
+
+    /// run items until the queue is empty
+    void start() const {
+        state->run_until(std::numeric_limits<long>::max());
+    }
+
+    /// run all the items that are due at or before time, then set the clock to time
+    void advance_to(long time) const {
+        state->advance_to(time);
+    }
+
+    void advance_by(long time) const {
+        advance_to(state->clock_now + time);
+    }
+
+    /// return an observable that sends the value of each element from first to last at the time of the element and
+    /// then completes. the elements are pairs of (long time, T value) sorted by time. elements with a time that has
+    /// passed when the observable is subscribed are sent immediately.
+    template<class T, class Iterator>
+    observable<T> make_timed_source(Iterator first, Iterator last) const {
+        auto st = state;
+        auto sc = static_cast<const scheduler&>(*this);
+        return make_observable_dynamic<T>([st, sc, first, last](subscriber<T> o){
+            auto controller = sc.create_worker(o.get_subscription());
+            auto cursor = std::make_shared<Iterator>(first);
+            // the schedulable only holds a weak reference to the worker
+            auto send = [st, o, cursor, last, controller](const schedulable& self){
+                auto& it = *cursor;
+                while (it != last && !(st->clock_now < it->first)) {
+                    if (!o.is_subscribed()) {
+                        return;
+                    }
+                    o.on_next(it->second);
+                    ++it;
+                }
+                if (it == last) {
+                    o.on_completed();
+                    return;
+                }
+                self.schedule(st->to_time_point(it->first));
+            };
+            if (first == last) {
+                controller.schedule(send);
+            } else {
+                controller.schedule(st->to_time_point(first->first), send);
+            }
+        });
+    }
+
+    /// return a subscriber that adds each notification to the summary
+    template<class T, class Hash = std::hash<T>>
+    subscriber<T> make_summary_subscriber(std::shared_ptr<notification_summary> summary, Hash hash = Hash()) const {
+        auto st = state;
+        return make_subscriber<T>(
+            [st, summary, hash](const T& v){
+                auto now = st->clock_now;
+                if (summary->next_count++ == 0) {
+                    summary->first_next = now;
+                }
+                summary->last_next = now;
+                summary->combine(std::hash<long>()(now));
+                summary->combine(hash(v));
+            },
+            [st, summary](rxu::error_ptr){
+                ++summary->error_count;
+                summary->terminated = st->clock_now;
+            },
+            [st, summary](){
+                ++summary->completed_count;
+                summary->terminated = st->clock_now;
+            }).as_dynamic();
+    }
+};
+
+inline fast_test make_fast_test() {
+    return fast_test();
+}
+
+}
+
+}
+
+#endif
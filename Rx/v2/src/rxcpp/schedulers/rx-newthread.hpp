@@ -39,14 +39,17 @@ private:
             {
             }
 
-            explicit new_worker_state(composite_subscription cs)
+            new_worker_state(composite_subscription cs, wait_policy wp)
                 : lifetime(cs)
+                , policy(std::move(wp))
             {
             }
 
             composite_subscription lifetime;
+            wait_policy policy;
             mutable std::mutex lock;
             mutable std::condition_variable wake;
+            mutable wait_signal signal;
             mutable queue_item_time q;
             std::thread worker;
             recursion r;
@@ -64,16 +67,26 @@ private:
         {
         }
 
-        new_worker(composite_subscription cs, thread_factory& tf)
-            : state(std::make_shared<new_worker_state>(cs))
+        new_worker(composite_subscription cs, thread_factory& tf, const wait_policy& wp)
+            : state(std::make_shared<new_worker_state>(cs, wp.for_worker()))
         {
             auto keepAlive = state;
 
+            // wake the thread to remove the cancelled timers
+            std::weak_ptr<new_worker_state> weak = state;
+            state->q.set_notify_cancelled([weak](){
+                if (auto st = weak.lock()) {
+                    std::unique_lock<std::mutex> guard(st->lock);
+                    st->wake.notify_one();
+                }
+            });
+
             state->lifetime.add([keepAlive](){
                 std::unique_lock<std::mutex> guard(keepAlive->lock);
                 auto expired = std::move(keepAlive->q);
                 keepAlive->q = new_worker_state::queue_item_time{};
                 if (!keepAlive->q.empty()) std::terminate();
+                keepAlive->signal.notify();
                 keepAlive->wake.notify_one();
 
                 if (keepAlive->worker.joinable() && keepAlive->worker.get_id() != std::this_thread::get_id()) {
@@ -97,7 +110,7 @@ private:
                 for(;;) {
                     std::unique_lock<std::mutex> guard(keepAlive->lock);
                     if (keepAlive->q.empty()) {
-                        keepAlive->wake.wait(guard, [keepAlive](){
+                        keepAlive->policy.wait(guard, keepAlive->wake, keepAlive->signal, [keepAlive](){
                             return !keepAlive->lifetime.is_subscribed() || !keepAlive->q.empty();
                         });
                     }
@@ -111,6 +124,7 @@ private:
                     }
                     auto when = peek.when;
                     if (clock_type::now() < when) {
+                        keepAlive->q.compact_cancelled();
                         keepAlive->wake.wait_until(guard, when);
                         continue;
                     }
@@ -133,15 +147,22 @@ private:
 
         virtual void schedule(clock_type::time_point when, const schedulable& scbl) const {
             if (scbl.is_subscribed()) {
+                bool timer = now() < when;
                 std::unique_lock<std::mutex> guard(state->lock);
-                state->q.push(new_worker_state::item_type(when, scbl));
+                if (timer) {
+                    state->q.push_timer(new_worker_state::item_type(when, scbl));
+                } else {
+                    state->q.push(new_worker_state::item_type(when, scbl));
+                }
                 state->r.reset(false);
             }
+            state->signal.notify();
             state->wake.notify_one();
         }
     };
 
     mutable thread_factory factory;
+    wait_policy policy;
 
 public:
     new_thread()
@@ -154,6 +175,19 @@ public:
         : factory(tf)
     {
     }
+    /// the workers wait for new items using the specified policy
+    explicit new_thread(wait_policy wp)
+        : factory([](std::function<void()> start){
+            return std::thread(std::move(start));
+        })
+        , policy(std::move(wp))
+    {
+    }
+    new_thread(thread_factory tf, wait_policy wp)
+        : factory(tf)
+        , policy(std::move(wp))
+    {
+    }
     virtual ~new_thread()
     {
     }
@@ -163,7 +197,7 @@ public:
     }
 
     virtual worker create_worker(composite_subscription cs) const {
-        return worker(cs, std::make_shared<new_worker>(cs, factory));
+        return worker(cs, std::make_shared<new_worker>(cs, factory, policy));
     }
 };
 
@@ -174,6 +208,12 @@ inline scheduler make_new_thread() {
 inline scheduler make_new_thread(thread_factory tf) {
     return make_scheduler<new_thread>(tf);
 }
+inline scheduler make_new_thread(wait_policy wp) {
+    return make_scheduler<new_thread>(std::move(wp));
+}
+inline scheduler make_new_thread(thread_factory tf, wait_policy wp) {
+    return make_scheduler<new_thread>(tf, std::move(wp));
+}
 
 }
 
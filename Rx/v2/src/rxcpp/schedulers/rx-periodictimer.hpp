@@ -0,0 +1,200 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_SCHEDULER_PERIODIC_TIMER_HPP)
+#define RXCPP_RX_SCHEDULER_PERIODIC_TIMER_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace schedulers {
+
+/// a periodic_timer runs every action added to it from one periodic schedule on one worker.
+/// the occurances are at origin + (N * period) and are numbered from 1, so many actions with the
+/// same period share one timer instead of each scheduling their own.
+/// the schedule is only active while at least one action is added.
+/// adding or removing an action does not schedule anything while the timer is active.
+class periodic_timer
+{
+    typedef periodic_timer this_type;
+    typedef scheduler_base::clock_type clock_type;
+
+    struct action_type
+    {
+        explicit action_type(std::function<void(long)> w)
+            : what(std::move(w))
+        {
+        }
+        composite_subscription lifetime;
+        std::function<void(long)> what;
+    };
+    typedef std::shared_ptr<action_type> action_ptr;
+
+    struct state_type
+        : public std::enable_shared_from_this<state_type>
+    {
+        state_type(worker w, clock_type::time_point o, clock_type::duration p, periodic_catch_up::type cu)
+            : controller(std::move(w))
+            , origin(o)
+            , period(p)
+            , catch_up(cu)
+            , count(0)
+            , running(composite_subscription::empty())
+        {
+        }
+
+        worker controller;
+        clock_type::time_point origin;
+        clock_type::duration period;
+        periodic_catch_up::type catch_up;
+
+        mutable std::mutex lock;
+        // actions added since the last occurance
+        std::vector<action_ptr> added;
+        // the number of actions that are not unsubscribed
+        std::size_t count;
+        // the lifetime of the schedule, unsubscribed when there are no actions
+        composite_subscription running;
+
+        // the actions that have run. taken by each occurance while it runs them,
+        // which the worker does one at a time, and cleared by release
+        std::vector<action_ptr> active;
+
+        clock_type::time_point first_after(clock_type::time_point now) const {
+            if (!(origin < now) || period <= clock_type::duration::zero()) {
+                return origin;
+            }
+            auto since = now - origin;
+            auto n = since / period + ((since % period) != clock_type::duration::zero() ? 1 : 0);
+            return origin + (n * period);
+        }
+
+        long number_of(clock_type::time_point target) const {
+            if (period <= clock_type::duration::zero()) {
+                return 1;
+            }
+            return static_cast<long>((target - origin) / period) + 1;
+        }
+
+        void start(composite_subscription lifetime) {
+            auto state = this->shared_from_this();
+            auto target = std::make_shared<clock_type::time_point>(first_after(controller.now()));
+            controller.schedule(*target, make_schedulable(controller, lifetime,
+                [state, target](const schedulable& self){
+                    state->run(state->number_of(*target));
+                    *target = detail::next_periodic_target(*target, state->period, state->controller.now(), state->catch_up);
+                    self.schedule(*target);
+                }));
+        }
+
+        void run(long n) {
+            std::vector<action_ptr> current;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                active.insert(active.end(), added.begin(), added.end());
+                added.clear();
+                current.swap(active);
+            }
+            // an action may add or remove actions while it runs. added actions
+            // are run from the next occurance, removed actions are compacted here.
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i != current.size(); ++i) {
+                auto a = current[i];
+                if (!a->lifetime.is_subscribed()) {
+                    continue;
+                }
+                a->what(n);
+                if (a->lifetime.is_subscribed()) {
+                    current[kept++] = std::move(a);
+                }
+            }
+            current.resize(kept);
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                // the actions are dropped when the last one was removed while they ran
+                if (count != 0) {
+                    active.swap(current);
+                }
+            }
+        }
+
+        void release() {
+            composite_subscription stop = composite_subscription::empty();
+            std::vector<action_ptr> expired;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                if (--count == 0) {
+                    stop = running;
+                    running = composite_subscription::empty();
+                    // the actions are destroyed now rather than at an occurance that will not run
+                    expired.swap(added);
+                    expired.insert(expired.end(), active.begin(), active.end());
+                    active.clear();
+                }
+            }
+            stop.unsubscribe();
+        }
+    };
+
+    std::shared_ptr<state_type> state;
+
+public:
+    /// the first occurance is at now()
+    periodic_timer(worker w, clock_type::duration period, periodic_catch_up::type catch_up = periodic_catch_up::burst)
+        : state(std::make_shared<state_type>(w, w.now(), period, catch_up))
+    {
+    }
+    /// the occurances are at origin + (N * period)
+    periodic_timer(worker w, clock_type::time_point origin, clock_type::duration period, periodic_catch_up::type catch_up = periodic_catch_up::burst)
+        : state(std::make_shared<state_type>(std::move(w), origin, period, catch_up))
+    {
+    }
+
+    clock_type::duration get_period() const {
+        return state->period;
+    }
+    const worker& get_worker() const {
+        return state->controller;
+    }
+    /// the number of actions that have been added and not removed
+    std::size_t size() const {
+        std::unique_lock<std::mutex> guard(state->lock);
+        return state->count;
+    }
+
+    /// add an action that is called with the number of each occurance on the worker,
+    /// starting with the next occurance. unsubscribe the returned subscription to remove it.
+    composite_subscription add(std::function<void(long)> what) const {
+        auto a = std::make_shared<action_type>(std::move(what));
+        std::weak_ptr<state_type> weak = state;
+        a->lifetime.add([weak](){
+            auto st = weak.lock();
+            if (st) {
+                st->release();
+            }
+        });
+
+        composite_subscription start = composite_subscription::empty();
+        {
+            std::unique_lock<std::mutex> guard(state->lock);
+            state->added.push_back(a);
+            if (++state->count == 1) {
+                start = state->running = composite_subscription();
+            }
+        }
+        // the worker may run the first occurance before schedule returns,
+        // so the lock must not be held
+        if (start.is_subscribed()) {
+            state->start(start);
+        }
+        return a->lifetime;
+    }
+};
+
+}
+
+}
+
+#endif
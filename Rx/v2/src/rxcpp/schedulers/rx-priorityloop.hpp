@@ -0,0 +1,302 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_SCHEDULER_PRIORITY_LOOP_HPP)
+#define RXCPP_RX_SCHEDULER_PRIORITY_LOOP_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace schedulers {
+
+/// the lanes of a priority_loop, from the most to the least urgent
+struct priority_level
+{
+    enum type {
+        high,
+        normal,
+        background
+    };
+    static const int count = 3;
+};
+
+/// a priority_loop runs the items of all its workers on one thread.
+/// each worker belongs to a priority level. when items from more than one
+/// level are due, the item from the most urgent level is run first.
+/// items of the same level are run in order of when, then in the order
+/// that they were scheduled.
+/// to prevent starvation, a level that has a due item and has been passed
+/// over starvation_limit times in a row is run next.
+class priority_loop
+{
+    typedef priority_loop this_type;
+    typedef scheduler_base::clock_type clock_type;
+
+    struct loop_state : public std::enable_shared_from_this<loop_state>
+    {
+        typedef detail::schedulable_queue<
+            clock_type::time_point> queue_item_time;
+
+        typedef queue_item_time::item_type item_type;
+
+        loop_state(std::size_t limit)
+            : starvation_limit(limit == 0 ? 1 : limit)
+        {
+            for (auto& b : bypassed) {
+                b = 0;
+            }
+        }
+
+        composite_subscription lifetime;
+        std::size_t starvation_limit;
+        mutable std::mutex lock;
+        mutable std::condition_variable wake;
+        mutable queue_item_time q[priority_level::count];
+        std::size_t bypassed[priority_level::count];
+        std::thread worker;
+        recursion r;
+
+        bool empty() const {
+            for (auto& lane : q) {
+                if (!lane.empty()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // returns the lane of the next item to run or -1 when no item is due.
+        // next is set to the earliest item when no item is due.
+        int select(clock_type::time_point now, clock_type::time_point& next) {
+            bool due[priority_level::count];
+            int selected = -1;
+            bool waiting = false;
+            for (int level = 0; level != priority_level::count; ++level) {
+                auto& lane = q[level];
+                while (!lane.empty() && !lane.top().what.is_subscribed()) {
+                    lane.pop();
+                }
+                due[level] = !lane.empty() && !(now < lane.top().when);
+                if (due[level]) {
+                    if (selected < 0 || bypassed[level] >= starvation_limit) {
+                        // a starved lane takes precedence over the more urgent lanes,
+                        // the most urgent of the starved lanes is selected
+                        if (selected < 0 || bypassed[selected] < starvation_limit) {
+                            selected = level;
+                        }
+                    }
+                } else if (!lane.empty() && (!waiting || lane.top().when < next)) {
+                    waiting = true;
+                    next = lane.top().when;
+                }
+            }
+            if (selected >= 0) {
+                for (int level = 0; level != priority_level::count; ++level) {
+                    if (level == selected) {
+                        bypassed[level] = 0;
+                    } else if (due[level] && level > selected) {
+                        ++bypassed[level];
+                    }
+                }
+            } else if (!waiting) {
+                next = clock_type::time_point::max();
+            }
+            return selected;
+        }
+    };
+
+    struct lane_worker : public worker_interface
+    {
+    private:
+        typedef lane_worker this_type;
+        lane_worker(const this_type&);
+
+        std::shared_ptr<loop_state> state;
+        int level;
+
+    public:
+        virtual ~lane_worker()
+        {
+        }
+        lane_worker(std::shared_ptr<loop_state> ls, int l)
+            : state(std::move(ls))
+            , level(l)
+        {
+        }
+
+        virtual clock_type::time_point now() const {
+            return clock_type::now();
+        }
+
+        virtual void schedule(const schedulable& scbl) const {
+            schedule(now(), scbl);
+        }
+
+        virtual void schedule(clock_type::time_point when, const schedulable& scbl) const {
+            if (scbl.is_subscribed()) {
+                bool timer = now() < when;
+                std::unique_lock<std::mutex> guard(state->lock);
+                if (timer) {
+                    state->q[level].push_timer(loop_state::item_type(when, scbl));
+                } else {
+                    state->q[level].push(loop_state::item_type(when, scbl));
+                }
+                state->r.reset(false);
+            }
+            state->wake.notify_one();
+        }
+    };
+
+    // stops the thread when the loop and all of its schedulers are gone
+    struct loop_owner
+    {
+        explicit loop_owner(std::shared_ptr<loop_state> ls)
+            : state(std::move(ls))
+        {
+        }
+        ~loop_owner()
+        {
+            state->lifetime.unsubscribe();
+        }
+        std::shared_ptr<loop_state> state;
+    };
+
+    struct lane_scheduler : public scheduler_interface
+    {
+    private:
+        typedef lane_scheduler this_type;
+        lane_scheduler(const this_type&);
+
+        std::shared_ptr<loop_owner> owner;
+        int level;
+
+    public:
+        lane_scheduler(std::shared_ptr<loop_owner> o, int l)
+            : owner(std::move(o))
+            , level(l)
+        {
+        }
+        virtual ~lane_scheduler()
+        {
+        }
+
+        virtual clock_type::time_point now() const {
+            return clock_type::now();
+        }
+
+        virtual worker create_worker(composite_subscription cs) const {
+            return worker(std::move(cs), std::make_shared<lane_worker>(owner->state, level));
+        }
+    };
+
+    std::shared_ptr<loop_owner> owner;
+    std::vector<scheduler> lanes;
+
+    void start(thread_factory& tf) {
+        auto keepAlive = owner->state;
+
+        // wake the thread to remove the cancelled timers
+        std::weak_ptr<loop_state> weak = keepAlive;
+        for (auto& lane : keepAlive->q) {
+            lane.set_notify_cancelled([weak](){
+                if (auto st = weak.lock()) {
+                    std::unique_lock<std::mutex> guard(st->lock);
+                    st->wake.notify_one();
+                }
+            });
+        }
+
+        keepAlive->lifetime.add([keepAlive](){
+            std::unique_lock<std::mutex> guard(keepAlive->lock);
+            for (auto& lane : keepAlive->q) {
+                lane = loop_state::queue_item_time{};
+            }
+            keepAlive->wake.notify_one();
+
+            if (keepAlive->worker.joinable() && keepAlive->worker.get_id() != std::this_thread::get_id()) {
+                guard.unlock();
+                keepAlive->worker.join();
+            }
+            else {
+                keepAlive->worker.detach();
+            }
+        });
+
+        keepAlive->worker = tf([keepAlive](){
+
+            // take ownership
+            detail::action_queue::ensure(std::make_shared<lane_worker>(keepAlive, static_cast<int>(priority_level::normal)));
+            // release ownership
+            RXCPP_UNWIND_AUTO([]{
+                detail::action_queue::destroy();
+            });
+
+            for(;;) {
+                std::unique_lock<std::mutex> guard(keepAlive->lock);
+                if (keepAlive->empty()) {
+                    keepAlive->wake.wait(guard, [keepAlive](){
+                        return !keepAlive->lifetime.is_subscribed() || !keepAlive->empty();
+                    });
+                }
+                if (!keepAlive->lifetime.is_subscribed()) {
+                    break;
+                }
+                clock_type::time_point next;
+                auto level = keepAlive->select(clock_type::now(), next);
+                if (level < 0) {
+                    if (next != clock_type::time_point::max()) {
+                        for (auto& lane : keepAlive->q) {
+                            lane.compact_cancelled();
+                        }
+                        keepAlive->wake.wait_until(guard, next);
+                    }
+                    continue;
+                }
+                auto what = keepAlive->q[level].top().what;
+                keepAlive->q[level].pop();
+                keepAlive->r.reset(keepAlive->empty());
+                guard.unlock();
+                what(keepAlive->r.get_recurse());
+            }
+        });
+
+        for (int level = 0; level != priority_level::count; ++level) {
+            lanes.push_back(make_scheduler<lane_scheduler>(owner, level));
+        }
+    }
+
+public:
+    explicit priority_loop(std::size_t starvation_limit = 8)
+        : owner(std::make_shared<loop_owner>(std::make_shared<loop_state>(starvation_limit)))
+    {
+        thread_factory tf([](std::function<void()> start){
+            return std::thread(std::move(start));
+        });
+        start(tf);
+    }
+    priority_loop(thread_factory tf, std::size_t starvation_limit = 8)
+        : owner(std::make_shared<loop_owner>(std::make_shared<loop_state>(starvation_limit)))
+    {
+        start(tf);
+    }
+
+    /// return the scheduler for the workers of the specified level.
+    /// the loop runs as long as this or any of its schedulers exist.
+    scheduler get_scheduler(priority_level::type level) const {
+        return lanes[level];
+    }
+};
+
+/// return the scheduler for the specified level of the default priority_loop
+inline scheduler make_priority_loop(priority_level::type level) {
+    static priority_loop instance;
+    return instance.get_scheduler(level);
+}
+
+}
+
+}
+
+#endif
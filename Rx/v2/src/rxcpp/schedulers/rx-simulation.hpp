@@ -0,0 +1,242 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_SCHEDULER_SIMULATION_HPP)
+#define RXCPP_RX_SCHEDULER_SIMULATION_HPP
+
+#include "../rx-includes.hpp"
+#include "rx-virtualclock.hpp"
+
+namespace rxcpp {
+
+namespace schedulers {
+
+/// simulation is a virtual time scheduler that models a number of threads, for testing concurrent pipelines
+/// without real threads and without sleeping.
+/// each worker that is created is assigned to one of the virtual threads, in turn, as event_loop does.
+/// the items of one virtual thread run in order. when the items of more than one virtual thread are due at
+/// the same time, the one that runs next is chosen by a random generator seeded with the seed, so each seed
+/// is one deterministic interleaving and a loop over seeds explores many of them.
+/// all the items run on the thread that calls start or advance_to.
+/// items that have not run are released when the simulation and all of its copies are destroyed.
+class simulation : public scheduler
+{
+public:
+    typedef scheduler_base::clock_type clock_type;
+
+private:
+    struct simulation_state : public detail::virtual_clock_state<simulation_state>
+    {
+        typedef detail::schedulable_queue<long> queue_item_time;
+
+        simulation_state(std::size_t threads, unsigned long s)
+            : choices(0)
+            , next_thread(0)
+            , seed(s)
+            , generator(static_cast<std::mt19937::result_type>(s))
+            , virtual_threads(threads == 0 ? 1 : threads)
+        {
+        }
+
+        std::size_t choices;
+        std::size_t next_thread;
+        unsigned long seed;
+        std::mt19937 generator;
+        std::vector<queue_item_time> virtual_threads;
+        std::vector<std::size_t> ready;
+
+        std::size_t pending() const {
+            std::size_t count = 0;
+            for (auto& q : virtual_threads) {
+                count += q.size();
+            }
+            return count;
+        }
+
+        // fill ready with the virtual threads that have an item at the earliest time.
+        // returns false when there are no items at or before time
+        bool find_ready(long time) {
+            ready.clear();
+            long earliest = time;
+            for (std::size_t i = 0; i != virtual_threads.size(); ++i) {
+                auto& q = virtual_threads[i];
+                if (q.empty() || earliest < q.top().when) {
+                    continue;
+                }
+                if (q.top().when < earliest) {
+                    earliest = q.top().when;
+                    ready.clear();
+                }
+                ready.push_back(i);
+            }
+            return !ready.empty();
+        }
+
+        // remove the next item of one of the virtual threads in ready
+        bool pop_due(long time, long& when, schedulable& what) {
+            if (!find_ready(time)) {
+                return false;
+            }
+            std::size_t chosen = ready.front();
+            if (ready.size() > 1) {
+                // the modulo keeps the choice the same for every standard library
+                chosen = ready[generator() % ready.size()];
+                ++choices;
+            }
+            auto& q = virtual_threads[chosen];
+            when = q.top().when;
+            what = q.top().what;
+            q.pop();
+            return true;
+        }
+
+        void run(const schedulable& what) {
+            // a new item is always queued, so that the other virtual threads can run in between
+            recursion r;
+            r.reset(false);
+            what(r.get_recurse());
+        }
+
+        void clear() {
+            for (auto& q : virtual_threads) {
+                q = queue_item_time{};
+            }
+        }
+    };
+
+    struct simulation_worker : public worker_interface
+    {
+        std::shared_ptr<simulation_state> state;
+        std::size_t thread;
+
+        simulation_worker(std::shared_ptr<simulation_state> st, std::size_t t)
+            : state(std::move(st))
+            , thread(t)
+        {
+        }
+
+        virtual clock_type::time_point now() const {
+            return state->to_time_point(state->clock_now);
+        }
+
+        virtual void schedule(const schedulable& scbl) const {
+            push(state->clock_now, scbl);
+        }
+
+        virtual void schedule(clock_type::time_point when, const schedulable& scbl) const {
+            push(state->due(when), scbl);
+        }
+
+        void push(long at, const schedulable& scbl) const {
+            // the schedulable only holds a weak reference to the worker, so the
+            // worker is kept alive by the item until the item has run.
+            // the item shares scbl's subscription, so that the queue and run_until
+            // see that it was cancelled
+            auto keep = scbl.get_worker();
+            auto run = make_schedulable(
+                scbl,
+                keep,
+                [scbl, keep](const schedulable&) {
+                    recursion r;
+                    r.reset(false);
+                    if (scbl.is_subscribed()) {
+                        scbl(r.get_recurse());
+                    }
+                });
+            state->virtual_threads[thread].push(simulation_state::queue_item_time::item_type(at, run));
+        }
+    };
+
+    struct simulation_type : public scheduler_interface
+    {
+        std::shared_ptr<simulation_state> state;
+
+        explicit simulation_type(std::shared_ptr<simulation_state> st)
+            : state(std::move(st))
+        {
+        }
+
+        virtual clock_type::time_point now() const {
+            return state->to_time_point(state->clock_now);
+        }
+
+        virtual worker create_worker(composite_subscription cs) const {
+            auto thread = state->next_thread++ % state->virtual_threads.size();
+            return worker(std::move(cs), std::make_shared<simulation_worker>(state, thread));
+        }
+    };
+
+    typedef detail::virtual_clock_owner<simulation_state> simulation_owner;
+
+    std::shared_ptr<simulation_owner> owner;
+    std::shared_ptr<simulation_state> state;
+
+    explicit simulation(std::shared_ptr<simulation_state> st)
+        : scheduler(std::static_pointer_cast<scheduler_interface>(std::make_shared<simulation_type>(st)))
+        , owner(std::make_shared<simulation_owner>(st))
+        , state(std::move(st))
+    {
+    }
+
+public:
+    simulation(std::size_t threads, unsigned long seed)
+        : simulation(std::make_shared<simulation_state>(threads, seed))
+    {
+    }
+
+    long clock() const {
+        return state->clock_now;
+    }
+
+    clock_type::time_point to_time_point(long absolute) const {
+        return state->to_time_point(absolute);
+    }
+
+    unsigned long seed() const {
+        return state->seed;
+    }
+
+    std::size_t threads() const {
+        return state->virtual_threads.size();
+    }
+
+    /// the number of items that have been run
+    std::size_t executed() const {
+        return state->executed;
+    }
+
+    /// the number of times that more than one virtual thread was ready and the seed chose between them
+    std::size_t choices() const {
+        return state->choices;
+    }
+
+    /// the number of items in the queues, including items that are unsubscribed
+    std::size_t pending() const {
+        return state->pending();
+    }
+
+    /// run items until the queues are empty
+    void start() const {
+        state->run_until(std::numeric_limits<long>::max());
+    }
+
+    /// run all the items that are due at or before time, then set the clock to time
+    void advance_to(long time) const {
+        state->advance_to(time);
+    }
+
+    void advance_by(long time) const {
+        advance_to(state->clock_now + time);
+    }
+};
+
+inline simulation make_simulation(std::size_t threads, unsigned long seed) {
+    return simulation(threads, seed);
+}
+
+}
+
+}
+
+#endif
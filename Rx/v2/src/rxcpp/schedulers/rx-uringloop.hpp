@@ -0,0 +1,714 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_SCHEDULER_URING_LOOP_HPP)
+#define RXCPP_RX_SCHEDULER_URING_LOOP_HPP
+
+#include "../rx-includes.hpp"
+
+#if !defined(__linux__)
+#error "rx-uringloop.hpp requires linux"
+#endif
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <unordered_map>
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/*! \file rx-uringloop.hpp
+
+    \brief A scheduler that runs its items on one thread that waits for timers, wakeups and reads in an io_uring.
+
+    This header is not included by rx.hpp, since it includes the linux headers.
+
+    The thread sleeps in one io_uring_enter call that submits the pending requests and waits for the first completion.
+    The earliest item that is not yet due is an absolute timeout request, items scheduled from other threads wake the
+    thread through an eventfd read and read() requests complete in the same ring, so any number of timers, wakeups and
+    reads that are ready together are collected with one transition into the kernel.
+
+    \sample
+    \code{.cpp}
+    #include <rxcpp/schedulers/rx-uringloop.hpp>
+
+    rxcpp::schedulers::uring_loop loop;
+    auto sc = loop.get_scheduler();
+    rxcpp::observable<>::interval(std::chrono::milliseconds(1), rxcpp::observe_on_one_worker(sc)).
+        take(10).
+        subscribe([](long n){ printf("%ld\n", n); });
+    loop.read(fd, 0, 4096).
+        subscribe([](const std::string& bytes){ printf("read %d bytes\n", static_cast<int>(bytes.size())); });
+    \endcode
+*/
+
+namespace rxcpp {
+
+namespace schedulers {
+
+namespace detail {
+
+inline void throw_system_error(int error, const char* what) {
+    rxu::throw_exception(std::system_error(error, std::system_category(), what));
+}
+
+// a minimal io_uring that is driven through the system calls.
+// only the thread that owns the ring may use it.
+class uring
+{
+    typedef uring this_type;
+    uring(const this_type&);
+    this_type& operator=(const this_type&);
+
+    int fd;
+    unsigned entries;
+
+    void* sq_ring;
+    std::size_t sq_ring_size;
+    void* cq_ring;
+    std::size_t cq_ring_size;
+    io_uring_sqe* sqes;
+    std::size_t sqes_size;
+
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    io_uring_cqe* cqes;
+
+    // prepared requests that have not been submitted
+    unsigned pending;
+
+    template<class T>
+    static T* at(void* base, unsigned offset) {
+        return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+    }
+
+    void release() {
+        if (sqes) {
+            ::munmap(sqes, sqes_size);
+        }
+        if (cq_ring && cq_ring != sq_ring) {
+            ::munmap(cq_ring, cq_ring_size);
+        }
+        if (sq_ring) {
+            ::munmap(sq_ring, sq_ring_size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+public:
+    explicit uring(unsigned e)
+        : fd(-1)
+        , entries(0)
+        , sq_ring(nullptr)
+        , sq_ring_size(0)
+        , cq_ring(nullptr)
+        , cq_ring_size(0)
+        , sqes(nullptr)
+        , sqes_size(0)
+        , pending(0)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(::syscall(__NR_io_uring_setup, e, &params));
+        if (fd < 0) {
+            throw_system_error(errno, "io_uring_setup");
+        }
+        entries = params.sq_entries;
+
+        sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) {
+            sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+        }
+
+        RXCPP_UNWIND(on_failure, [this](){
+            release();
+        });
+
+        sq_ring = ::mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sq_ring == MAP_FAILED) {
+            sq_ring = nullptr;
+            throw_system_error(errno, "io_uring mmap");
+        }
+        if (single) {
+            cq_ring = sq_ring;
+        } else {
+            cq_ring = ::mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cq_ring == MAP_FAILED) {
+                cq_ring = nullptr;
+                throw_system_error(errno, "io_uring mmap");
+            }
+        }
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        void* s = ::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (s == MAP_FAILED) {
+            throw_system_error(errno, "io_uring mmap");
+        }
+        sqes = static_cast<io_uring_sqe*>(s);
+
+        sq_head = at<unsigned>(sq_ring, params.sq_off.head);
+        sq_tail = at<unsigned>(sq_ring, params.sq_off.tail);
+        sq_mask = at<unsigned>(sq_ring, params.sq_off.ring_mask);
+        sq_array = at<unsigned>(sq_ring, params.sq_off.array);
+
+        cq_head = at<unsigned>(cq_ring, params.cq_off.head);
+        cq_tail = at<unsigned>(cq_ring, params.cq_off.tail);
+        cq_mask = at<unsigned>(cq_ring, params.cq_off.ring_mask);
+        cqes = at<io_uring_cqe>(cq_ring, params.cq_off.cqes);
+
+        on_failure.dismiss();
+    }
+
+    ~uring()
+    {
+        release();
+    }
+
+    /// return a cleared request to fill in. the request is submitted by the next call to enter.
+    /// returns nullptr when the submission queue is full and the kernel will not accept more
+    /// requests until the completion queue is drained.
+    io_uring_sqe* next() {
+        unsigned tail = *sq_tail;
+        while (tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) == entries) {
+            // the submission queue is full
+            if (!enter(0)) {
+                return nullptr;
+            }
+        }
+        unsigned index = tail & *sq_mask;
+        io_uring_sqe* sqe = sqes + index;
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        ++pending;
+        return sqe;
+    }
+
+    /// submit the pending requests and wait until at least wait_for requests have completed.
+    /// returns false when the completion queue is full and must be drained before the requests are accepted
+    bool enter(unsigned wait_for) {
+        for (;;) {
+            long submitted = ::syscall(__NR_io_uring_enter, fd, pending, wait_for, wait_for ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+            if (submitted >= 0) {
+                pending -= static_cast<unsigned>(submitted);
+                return true;
+            }
+            if (errno == EINTR) {
+                if (wait_for == 0) {
+                    continue;
+                }
+                // an interrupted wait is a spurious wakeup
+                return true;
+            }
+            if (errno == EBUSY || errno == EAGAIN) {
+                return false;
+            }
+            throw_system_error(errno, "io_uring_enter");
+        }
+    }
+
+    /// call f for each completion that is ready
+    template<class F>
+    void for_each_completion(F f) {
+        unsigned head = *cq_head;
+        for (;;) {
+            unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+            if (head == tail) {
+                break;
+            }
+            io_uring_cqe cqe = cqes[head & *cq_mask];
+            ++head;
+            __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+            f(cqe);
+        }
+    }
+};
+
+}
+
+/// a uring_loop runs the items of all its workers on one thread that sleeps in an io_uring.
+/// items that are due are run in order of when, then in the order that they were scheduled.
+class uring_loop
+{
+    typedef uring_loop this_type;
+    typedef scheduler_base::clock_type clock_type;
+
+    // the user_data of the requests that are not reads.
+    // reads are numbered in the upper bits and have the low two bits clear
+    enum : __u64 {
+        wakeup_request = 1,
+        timeout_remove_request = 2,
+        cancel_request = 6,
+        timeout_request = 3
+    };
+
+    struct loop_state : public std::enable_shared_from_this<loop_state>
+    {
+        typedef rxsc::detail::schedulable_queue<
+            clock_type::time_point> queue_item_time;
+
+        typedef queue_item_time::item_type item_type;
+
+        typedef std::function<void(int, std::string)> read_handler;
+
+        struct read_request
+        {
+            std::string buffer;
+            read_handler on_read;
+        };
+
+        explicit loop_state(unsigned entries)
+            : stopped(false)
+            , wakeup(-1)
+            , waiting(false)
+            , wakeup_armed(false)
+            , counter(0)
+            , armed(false)
+            , generation(0)
+            , read_sequence(0)
+            , ring(entries)
+        {
+            wakeup = ::eventfd(0, EFD_CLOEXEC);
+            if (wakeup < 0) {
+                detail::throw_system_error(errno, "eventfd");
+            }
+            std::memset(&deadline, 0, sizeof(deadline));
+        }
+        ~loop_state()
+        {
+            ::close(wakeup);
+        }
+
+        composite_subscription lifetime;
+        mutable std::mutex lock;
+        mutable queue_item_time q;
+        std::thread worker;
+        recursion r;
+        // no more items are queued once the loop has stopped
+        bool stopped;
+
+        // the remaining members are only used on the loop thread,
+        // except for waiting and wakeup which are used with the lock
+
+        int wakeup;
+        bool waiting;
+        bool wakeup_armed;
+        __u64 counter;
+
+        bool armed;
+        __u64 generation;
+        clock_type::time_point armed_when;
+        __kernel_timespec deadline;
+
+        __u64 read_sequence;
+        std::unordered_map<__u64, std::unique_ptr<read_request>> reads;
+
+        // the ring is declared last, so that it is closed before the
+        // counter, the deadline and the read buffers are released
+        detail::uring ring;
+
+        void wake() const {
+            ::eventfd_write(wakeup, 1);
+        }
+
+        // run the completions that are ready. the handlers do not use the ring
+        void reap() {
+            ring.for_each_completion([this](const io_uring_cqe& cqe){
+                complete(cqe);
+            });
+        }
+
+        io_uring_sqe* next_request() {
+            for (;;) {
+                auto sqe = ring.next();
+                if (sqe) {
+                    return sqe;
+                }
+                // the kernel accepts more requests once the completion queue is drained
+                reap();
+            }
+        }
+
+        void arm_wakeup() {
+            auto sqe = next_request();
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = wakeup;
+            sqe->addr = reinterpret_cast<__u64>(&counter);
+            sqe->len = sizeof(counter);
+            sqe->off = static_cast<__u64>(-1);
+            sqe->user_data = wakeup_request;
+            wakeup_armed = true;
+        }
+
+        void remove_timeout() {
+            auto sqe = next_request();
+            sqe->opcode = IORING_OP_TIMEOUT_REMOVE;
+            sqe->fd = -1;
+            sqe->addr = (generation << 2) | timeout_request;
+            sqe->user_data = timeout_remove_request;
+        }
+
+        void arm_timeout(clock_type::time_point when) {
+            if (armed) {
+                if (!(when < armed_when)) {
+                    return;
+                }
+                remove_timeout();
+            }
+            auto since = std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch()).count();
+            deadline.tv_sec = since / 1000000000;
+            deadline.tv_nsec = since % 1000000000;
+            ++generation;
+            armed = true;
+            armed_when = when;
+            auto sqe = next_request();
+            sqe->opcode = IORING_OP_TIMEOUT;
+            sqe->fd = -1;
+            sqe->addr = reinterpret_cast<__u64>(&deadline);
+            sqe->len = 1;
+            sqe->off = 0;
+            sqe->timeout_flags = IORING_TIMEOUT_ABS;
+            sqe->user_data = (generation << 2) | timeout_request;
+        }
+
+        /// returns the id of the read, which is not reused
+        __u64 submit_read(int fd, __u64 offset, std::size_t length, read_handler on_read) {
+            std::unique_ptr<read_request> request(new read_request());
+            request->buffer.resize(length);
+            request->on_read = std::move(on_read);
+            auto sqe = next_request();
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<__u64>(&request->buffer[0]);
+            sqe->len = static_cast<__u32>(length);
+            sqe->off = offset;
+            auto id = ++read_sequence << 2;
+            sqe->user_data = id;
+            reads[id] = std::move(request);
+            return id;
+        }
+
+        /// a cancelled read completes with ECANCELED, unless it completed first
+        void cancel_read(__u64 id) {
+            if (reads.find(id) == reads.end()) {
+                return;
+            }
+            auto sqe = next_request();
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = id;
+            sqe->user_data = cancel_request;
+        }
+
+        void complete(const io_uring_cqe& cqe) {
+            if (cqe.user_data == wakeup_request) {
+                // re-armed by the loop before it sleeps again
+                wakeup_armed = false;
+            } else if (cqe.user_data == timeout_remove_request || cqe.user_data == cancel_request) {
+            } else if ((cqe.user_data & 3) == timeout_request) {
+                if ((cqe.user_data >> 2) == generation) {
+                    armed = false;
+                }
+            } else {
+                auto it = reads.find(cqe.user_data);
+                if (it != reads.end()) {
+                    auto request = std::move(it->second);
+                    reads.erase(it);
+                    if (cqe.res >= 0) {
+                        request->buffer.resize(static_cast<std::size_t>(cqe.res));
+                    }
+                    request->on_read(cqe.res, std::move(request->buffer));
+                }
+            }
+        }
+
+        void run() {
+            arm_wakeup();
+
+            for(;;) {
+                std::unique_lock<std::mutex> guard(lock);
+                if (!lifetime.is_subscribed()) {
+                    break;
+                }
+                while (!q.empty() && !q.top().what.is_subscribed()) {
+                    q.pop();
+                }
+                if (!q.empty() && !(clock_type::now() < q.top().when)) {
+                    auto what = q.top().what;
+                    q.pop();
+                    r.reset(q.empty());
+                    guard.unlock();
+                    what(r.get_recurse());
+                    continue;
+                }
+                bool timed = !q.empty();
+                auto when = timed ? q.top().when : clock_type::time_point();
+                q.compact_cancelled();
+                waiting = true;
+                guard.unlock();
+
+                if (timed) {
+                    arm_timeout(when);
+                }
+                if (!wakeup_armed) {
+                    arm_wakeup();
+                }
+                // submit the new requests and sleep until a timeout, wakeup or read completes
+                ring.enter(1);
+                reap();
+
+                guard.lock();
+                waiting = false;
+            }
+        }
+
+        // cancel the requests that are in flight and wait for them to complete,
+        // so that the kernel is done with the memory that they refer to
+        void drain() {
+            std::vector<__u64> ids;
+            for (auto& read : reads) {
+                ids.push_back(read.first);
+            }
+            for (auto id : ids) {
+                cancel_read(id);
+            }
+            if (armed) {
+                remove_timeout();
+            }
+            if (wakeup_armed) {
+                wake();
+            }
+            while (wakeup_armed || armed || !reads.empty()) {
+                ring.enter(1);
+                reap();
+            }
+        }
+
+        // the ring failed, so the requests that are in flight cannot be reaped.
+        // stop queueing items and fail the reads, but keep their buffers, which
+        // the kernel may still write to
+        void abandon() {
+            std::unique_lock<std::mutex> guard(lock);
+            stopped = true;
+            q = queue_item_time{};
+            guard.unlock();
+
+            auto abandoned = std::move(reads);
+            reads.clear();
+            for (auto& read : abandoned) {
+                auto on_read = std::move(read.second->on_read);
+                read.second.release();
+                on_read(-ECANCELED, std::string());
+            }
+        }
+    };
+
+    struct loop_worker : public worker_interface
+    {
+    private:
+        typedef loop_worker this_type;
+        loop_worker(const this_type&);
+
+        std::shared_ptr<loop_state> state;
+
+    public:
+        virtual ~loop_worker()
+        {
+        }
+        explicit loop_worker(std::shared_ptr<loop_state> ls)
+            : state(std::move(ls))
+        {
+        }
+
+        virtual clock_type::time_point now() const {
+            return clock_type::now();
+        }
+
+        virtual void schedule(const schedulable& scbl) const {
+            schedule(now(), scbl);
+        }
+
+        virtual void schedule(clock_type::time_point when, const schedulable& scbl) const {
+            bool wake = false;
+            if (scbl.is_subscribed()) {
+                std::unique_lock<std::mutex> guard(state->lock);
+                if (state->stopped) {
+                    return;
+                }
+                if (now() < when) {
+                    state->q.push_timer(loop_state::item_type(when, scbl));
+                } else {
+                    state->q.push(loop_state::item_type(when, scbl));
+                }
+                state->r.reset(false);
+                wake = state->waiting;
+            }
+            if (wake) {
+                state->wake();
+            }
+        }
+    };
+
+    // stops the thread when the loop and all of its schedulers are gone
+    struct loop_owner
+    {
+        explicit loop_owner(std::shared_ptr<loop_state> ls)
+            : state(std::move(ls))
+        {
+        }
+        ~loop_owner()
+        {
+            state->lifetime.unsubscribe();
+        }
+        std::shared_ptr<loop_state> state;
+    };
+
+    struct loop_scheduler : public scheduler_interface
+    {
+    private:
+        typedef loop_scheduler this_type;
+        loop_scheduler(const this_type&);
+
+        std::shared_ptr<loop_owner> owner;
+
+    public:
+        explicit loop_scheduler(std::shared_ptr<loop_owner> o)
+            : owner(std::move(o))
+        {
+        }
+        virtual ~loop_scheduler()
+        {
+        }
+
+        virtual clock_type::time_point now() const {
+            return clock_type::now();
+        }
+
+        virtual worker create_worker(composite_subscription cs) const {
+            return worker(std::move(cs), std::make_shared<loop_worker>(owner->state));
+        }
+    };
+
+    std::shared_ptr<loop_owner> owner;
+    scheduler factory;
+
+    void start(thread_factory& tf) {
+        auto keepAlive = owner->state;
+
+        // the eventfd keeps the wakeup, so it does not need the lock
+        std::weak_ptr<loop_state> weak = keepAlive;
+        keepAlive->q.set_notify_cancelled([weak](){
+            if (auto st = weak.lock()) {
+                st->wake();
+            }
+        });
+
+        keepAlive->lifetime.add([keepAlive](){
+            std::unique_lock<std::mutex> guard(keepAlive->lock);
+            keepAlive->stopped = true;
+            keepAlive->q = loop_state::queue_item_time{};
+            guard.unlock();
+            keepAlive->wake();
+
+            if (keepAlive->worker.joinable() && keepAlive->worker.get_id() != std::this_thread::get_id()) {
+                keepAlive->worker.join();
+            }
+            else {
+                keepAlive->worker.detach();
+            }
+        });
+
+        keepAlive->worker = tf([keepAlive](){
+
+            // take ownership
+            rxsc::detail::action_queue::ensure(std::make_shared<loop_worker>(keepAlive));
+            // release ownership
+            RXCPP_UNWIND_AUTO([]{
+                rxsc::detail::action_queue::destroy();
+            });
+
+            RXCPP_TRY {
+                keepAlive->run();
+                keepAlive->drain();
+            } RXCPP_CATCH(const std::system_error&) {
+                keepAlive->abandon();
+            }
+        });
+    }
+
+public:
+    explicit uring_loop(unsigned entries = 64)
+        : owner(std::make_shared<loop_owner>(std::make_shared<loop_state>(entries)))
+    {
+        thread_factory tf([](std::function<void()> start){
+            return std::thread(std::move(start));
+        });
+        start(tf);
+        factory = make_scheduler<loop_scheduler>(owner);
+    }
+    uring_loop(thread_factory tf, unsigned entries = 64)
+        : owner(std::make_shared<loop_owner>(std::make_shared<loop_state>(entries)))
+    {
+        start(tf);
+        factory = make_scheduler<loop_scheduler>(owner);
+    }
+
+    /// return the scheduler for the workers of this loop.
+    /// the loop runs as long as this or its scheduler exist.
+    scheduler get_scheduler() const {
+        return factory;
+    }
+
+    /// return an observable that reads up to length bytes at offset from fd on the loop and sends them as one value.
+    /// an error from the read is sent to on_error. the read is cancelled when the subscriber unsubscribes
+    /// and when the loop stops, which sends ECANCELED. the fd must stay open until the read completes.
+    observable<std::string> read(int fd, std::uint64_t offset, std::size_t length) const {
+        auto state = owner->state;
+        auto sc = factory;
+        return observable<>::create<std::string>([=](subscriber<std::string> s){
+            // the request is submitted on the loop thread, which owns the ring
+            auto controller = sc.create_worker(s.get_subscription());
+            controller.schedule([=](const schedulable&){
+                auto id = state->submit_read(fd, offset, length, [s](int result, std::string bytes){
+                    if (!s.is_subscribed()) {
+                        return;
+                    }
+                    if (result < 0) {
+                        s.on_error(rxu::make_error_ptr(std::system_error(-result, std::system_category(), "read")));
+                        return;
+                    }
+                    s.on_next(std::move(bytes));
+                    s.on_completed();
+                });
+                s.add([state, sc, id](){
+                    // the cancel is also submitted on the loop thread
+                    auto canceller = sc.create_worker();
+                    canceller.schedule([state, id](const schedulable&){
+                        state->cancel_read(id);
+                    });
+                });
+            });
+        });
+    }
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_SCHEDULER_VIRTUAL_CLOCK_HPP)
+#define RXCPP_RX_SCHEDULER_VIRTUAL_CLOCK_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace schedulers {
+
+namespace detail {
+
+// the clock and the run loop of the fast_test and simulation schedulers.
+// the clock is a count of milliseconds. Derived provides
+//  - bool pop_due(long time, long& when, schedulable& what), which removes the next item that is due at or before time
+//  - void run(const schedulable& what), which runs an item that was removed
+//  - void clear(), which releases the items that have not run
+template<class Derived>
+struct virtual_clock_state
+{
+    typedef scheduler_base::clock_type clock_type;
+
+    virtual_clock_state()
+        : clock_now(0)
+        , executed(0)
+        , running(false)
+    {
+    }
+
+    long clock_now;
+    std::size_t executed;
+    bool running;
+
+    clock_type::time_point to_time_point(long absolute) const {
+        return clock_type::time_point(std::chrono::milliseconds(absolute));
+    }
+    long to_absolute(clock_type::time_point when) const {
+        return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(when.time_since_epoch()).count());
+    }
+
+    // the time to run an item that is scheduled for when, which is never before the clock
+    long due(clock_type::time_point when) const {
+        return std::max(clock_now, to_absolute(when));
+    }
+
+    // run the items that are due at or before time
+    void run_until(long time) {
+        if (running) {
+            std::terminate();
+        }
+        running = true;
+        RXCPP_UNWIND_AUTO([this](){running = false;});
+        auto& self = static_cast<Derived&>(*this);
+        long when = 0;
+        schedulable what;
+        while (self.pop_due(time, when, what)) {
+            if (!what.is_subscribed()) {
+                continue;
+            }
+            if (when > clock_now) {
+                clock_now = when;
+            }
+            ++executed;
+            self.run(what);
+        }
+    }
+
+    // run all the items that are due at or before time, then set the clock to time
+    void advance_to(long time) {
+        if (time < clock_now) {
+            std::terminate();
+        }
+        run_until(time);
+        clock_now = time;
+    }
+};
+
+// the items that have not run may refer to the state, so they are
+// released when the scheduler and all of its copies are gone
+template<class State>
+struct virtual_clock_owner
+{
+    explicit virtual_clock_owner(std::shared_ptr<State> st)
+        : state(std::move(st))
+    {
+    }
+    ~virtual_clock_owner()
+    {
+        state->clear();
+    }
+    std::shared_ptr<State> state;
+};
+
+}
+
+}
+
+}
+
+#endif
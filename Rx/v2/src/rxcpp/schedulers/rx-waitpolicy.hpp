@@ -0,0 +1,234 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_SCHEDULER_WAIT_POLICY_HPP)
+#define RXCPP_RX_SCHEDULER_WAIT_POLICY_HPP
+
+#include "../rx-includes.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define RXCPP_CPU_RELAX() _mm_pause()
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+#define RXCPP_CPU_RELAX() __builtin_ia32_pause()
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+#define RXCPP_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+#define RXCPP_CPU_RELAX() ((void)0)
+#endif
+
+namespace rxcpp {
+
+namespace schedulers {
+
+/// the number of waits of a wait_policy that ended in each phase
+struct wait_counters
+{
+    wait_counters()
+        : spun(0)
+        , yielded(0)
+        , parked(0)
+    {
+    }
+    /// waits that ended while spinning
+    std::size_t spun;
+    /// waits that ended while yielding the thread
+    std::size_t yielded;
+    /// waits that blocked on the condition variable
+    std::size_t parked;
+};
+
+/// a wait_signal is advanced each time the state that a wait_policy waits for changes, in addition to
+/// notifying the condition_variable, so that a spinning thread can watch it without taking the lock.
+class wait_signal
+{
+    std::atomic<std::size_t> generation;
+
+    wait_signal(const wait_signal&);
+    wait_signal& operator=(const wait_signal&);
+
+public:
+    wait_signal()
+        : generation(0)
+    {
+    }
+
+    /// call after the state has changed, with or without the lock
+    void notify() {
+        generation.fetch_add(1, std::memory_order_release);
+    }
+
+    std::size_t get() const {
+        return generation.load(std::memory_order_acquire);
+    }
+};
+
+/// a wait_policy decides how a thread waits for a condition that is signaled through a condition_variable
+/// and a wait_signal. the wait spins on the wait_signal between cpu pauses, then yields the thread, then
+/// blocks on the condition_variable. the lock is only taken to check the condition when the signal has
+/// changed, so a waiting thread does not contend with the threads that change the state. the number of
+/// spins adapts between max_spins and max_spins / 16: it is doubled when a wait ends while spinning and
+/// halved when a wait has to block.
+/// copies of a policy share the spin limit and the counters. a scheduler gives each of its threads a
+/// policy from for_worker, with its own spin limit and counters, so that the threads do not write to
+/// the same atomics on every wait. the default policy blocks immediately.
+class wait_policy
+{
+    struct state_type
+    {
+        state_type(std::size_t s, std::size_t y)
+            : max_spins(s)
+            , min_spins(s / 16)
+            , yields(y)
+            , spins(s)
+            , spun(0)
+            , yielded(0)
+            , parked(0)
+        {
+        }
+        state_type(std::shared_ptr<state_type> p)
+            : max_spins(p->max_spins)
+            , min_spins(p->min_spins)
+            , yields(p->yields)
+            , spins(p->spins.load(std::memory_order_relaxed))
+            , spun(0)
+            , yielded(0)
+            , parked(0)
+            , parent(std::move(p))
+        {
+        }
+        ~state_type()
+        {
+            if (parent) {
+                // keep the counts of a worker that has finished
+                std::unique_lock<std::mutex> guard(parent->lock);
+                parent->spun += spun;
+                parent->yielded += yielded;
+                parent->parked += parked;
+                parent->workers.erase(std::find(parent->workers.begin(), parent->workers.end(), this));
+            }
+        }
+        std::size_t max_spins;
+        std::size_t min_spins;
+        std::size_t yields;
+        std::atomic<std::size_t> spins;
+        std::atomic<std::size_t> spun;
+        std::atomic<std::size_t> yielded;
+        std::atomic<std::size_t> parked;
+
+        // the policy that this worker policy was made from
+        std::shared_ptr<state_type> parent;
+        // the worker policies made from this policy, that are included in its counters
+        std::mutex lock;
+        std::vector<state_type*> workers;
+    };
+
+    std::shared_ptr<state_type> state;
+
+public:
+    wait_policy()
+    {
+    }
+    wait_policy(std::size_t max_spins, std::size_t yields)
+        : state(std::make_shared<state_type>(max_spins, yields))
+    {
+    }
+
+    /// a policy that spins for a few microseconds before it yields and then blocks
+    static wait_policy adaptive() {
+        return wait_policy(256, 16);
+    }
+
+    /// return a policy with the same limits and its own spin limit and counters. the waits of the new
+    /// policy are included in the counters of this policy.
+    wait_policy for_worker() const {
+        wait_policy result;
+        if (state) {
+            result.state = std::make_shared<state_type>(state);
+            std::unique_lock<std::mutex> guard(state->lock);
+            state->workers.push_back(result.state.get());
+        }
+        return result;
+    }
+
+    /// wait until pred returns true. the guard must own the lock that protects the state tested by pred, and
+    /// the threads that change that state must notify both wake and signal. the lock is released while
+    /// pausing, yielding and blocking, and is only taken again to test pred when the signal has changed.
+    template<class Predicate>
+    void wait(std::unique_lock<std::mutex>& guard, std::condition_variable& wake, const wait_signal& signal, Predicate pred) const {
+        if (pred()) {
+            return;
+        }
+        if (state) {
+            auto limit = state->spins.load(std::memory_order_relaxed);
+            // read with the lock held, so any later change is seen
+            auto seen = signal.get();
+            guard.unlock();
+            // true when the signal changed and pred is now true, with the lock held
+            auto changed = [&]() {
+                if (signal.get() == seen) {
+                    return false;
+                }
+                guard.lock();
+                if (pred()) {
+                    return true;
+                }
+                seen = signal.get();
+                guard.unlock();
+                return false;
+            };
+            for (std::size_t i = 0; i != limit; ++i) {
+                if (changed()) {
+                    ++state->spun;
+                    state->spins.store(std::min(state->max_spins, std::max<std::size_t>(limit * 2, 1)), std::memory_order_relaxed);
+                    return;
+                }
+                RXCPP_CPU_RELAX();
+            }
+            for (std::size_t i = 0; i != state->yields; ++i) {
+                if (changed()) {
+                    ++state->yielded;
+                    return;
+                }
+                std::this_thread::yield();
+            }
+            guard.lock();
+            if (pred()) {
+                ++state->yielded;
+                return;
+            }
+            ++state->parked;
+            state->spins.store(std::max(state->min_spins, limit / 2), std::memory_order_relaxed);
+        }
+        wake.wait(guard, pred);
+    }
+
+    /// the number of spins the next wait will make
+    std::size_t spin_limit() const {
+        return state ? state->spins.load() : 0;
+    }
+
+    /// the waits of this policy and of the worker policies made from it
+    wait_counters counters() const {
+        wait_counters result;
+        if (state) {
+            std::unique_lock<std::mutex> guard(state->lock);
+            result.spun = state->spun;
+            result.yielded = state->yielded;
+            result.parked = state->parked;
+            for (auto w : state->workers) {
+                result.spun += w->spun;
+                result.yielded += w->yielded;
+                result.parked += w->parked;
+            }
+        }
+        return result;
+    }
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_SOURCES_RX_FILE_MAPPING_HPP)
+#define RXCPP_SOURCES_RX_FILE_MAPPING_HPP
+
+// the platform code of the memory mapped file sources. This header only depends on the
+//   standard library and the platform headers. It reports errors instead of throwing, so
+//   the user throws in its own way.
+
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rxcpp {
+
+namespace sources {
+
+namespace detail {
+
+// a read only mapping of a whole file
+class file_mapping
+{
+    const char* first;
+    std::size_t length;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+    file_mapping(const file_mapping&);
+    file_mapping& operator=(const file_mapping&);
+
+#if defined(_WIN32)
+    static bool fail(std::error_code& error, const char*& failed, const char* what) {
+        error = std::error_code(static_cast<int>(::GetLastError()), std::system_category());
+        failed = what;
+        return false;
+    }
+#else
+    static bool fail(std::error_code& error, const char*& failed, const char* what) {
+        error = std::error_code(errno, std::system_category());
+        failed = what;
+        return false;
+    }
+#endif
+
+public:
+    file_mapping()
+        : first(nullptr)
+        , length(0)
+#if defined(_WIN32)
+        , file(INVALID_HANDLE_VALUE)
+        , mapping(nullptr)
+#endif
+    {
+    }
+
+    ~file_mapping() {
+#if defined(_WIN32)
+        if (first) { ::UnmapViewOfFile(first); }
+        if (mapping) { ::CloseHandle(mapping); }
+        if (file != INVALID_HANDLE_VALUE) { ::CloseHandle(file); }
+#else
+        if (first) { ::munmap(const_cast<char*>(first), length); }
+#endif
+    }
+
+    /// maps the file at path. On failure returns false, with the error and the step that
+    /// failed ("cannot open ", "cannot get the size of " or "cannot map ").
+    bool map(const std::string& path, std::error_code& error, const char*& failed) {
+#if defined(_WIN32)
+        file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return fail(error, failed, "cannot open ");
+        }
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(file, &size)) {
+            return fail(error, failed, "cannot get the size of ");
+        }
+        length = static_cast<std::size_t>(size.QuadPart);
+        if (length) {
+            mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping) {
+                return fail(error, failed, "cannot map ");
+            }
+            first = static_cast<const char*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!first) {
+                return fail(error, failed, "cannot map ");
+            }
+        }
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return fail(error, failed, "cannot open ");
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            fail(error, failed, "cannot get the size of ");
+            ::close(fd);
+            return false;
+        }
+        const std::size_t size = static_cast<std::size_t>(st.st_size);
+        if (size) {
+            void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                fail(error, failed, "cannot map ");
+                ::close(fd);
+                return false;
+            }
+            ::madvise(p, size, MADV_SEQUENTIAL);
+            first = static_cast<const char*>(p);
+            length = size;
+        }
+        // the mapping stays valid after the descriptor is closed
+        ::close(fd);
+#endif
+        return true;
+    }
+
+    const char* data() const { return first; }
+    std::size_t size() const { return length; }
+};
+
+}
+
+}
+
+}
+
+#endif
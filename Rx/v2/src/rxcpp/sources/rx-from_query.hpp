@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_SOURCES_RX_FROM_QUERY_HPP)
+#define RXCPP_SOURCES_RX_FROM_QUERY_HPP
+
+#include "../rx-includes.hpp"
+
+/*! \file rx-from_query.hpp
+
+    \brief Returns an observable that sends each value of a query, pulling them from the query cursor in chunks, on the specified scheduler.
+
+    \tparam Query         the type of the query (any type with a get_cursor() method that returns a cpplinq style cursor, such as cpplinq::linq_driver)
+    \tparam Coordination  the type of the scheduler (optional)
+
+    \param  q      the query whose values are sent
+    \param  cn     the scheduler to use for scheduling the items (optional)
+    \param  chunk  the number of values sent by each scheduled action (optional, 64 by default)
+
+    \return  Observable that sends each value of the query.
+
+    Each subscription gets its own copy of the query and its own cursor, so the observable may be released while the values are sent. The values are pulled lazily, so the query is evaluated while it is emitted and is never copied into a container.
+    Each scheduled action sends up to chunk values, and the subscription is checked before each value, so an unsubscribe stops the query evaluation.
+
+    \sample
+    \code{.cpp}
+    std::vector<int> v = ...;
+    auto q = cpplinq::from(v).where([](int x){ return x % 2 == 0; });
+    rxcpp::observable<>::from_query(q, rxcpp::observe_on_new_thread()).
+        subscribe([](int x){ printf("OnNext: %d\n", x); });
+    \endcode
+*/
+
+namespace rxcpp {
+
+namespace sources {
+
+namespace detail {
+
+template<class Query>
+struct from_query_traits
+{
+    typedef rxu::decay_t<Query> query_type;
+    typedef rxu::decay_t<decltype((*(const query_type*)nullptr).get_cursor())> cursor_type;
+    typedef rxu::decay_t<decltype((*(const cursor_type*)nullptr).get())> value_type;
+};
+
+template<class Query, class Coordination>
+struct from_query : public source_base<rxu::value_type_t<from_query_traits<Query>>>
+{
+    typedef from_query<Query, Coordination> this_type;
+    typedef from_query_traits<Query> traits;
+
+    typedef rxu::decay_t<Coordination> coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+
+    typedef typename traits::query_type query_type;
+    typedef typename traits::cursor_type cursor_type;
+
+    struct from_query_initial_type
+    {
+        from_query_initial_type(query_type q, coordination_type cn, std::size_t chunk)
+            : query(std::move(q))
+            , coordination(std::move(cn))
+            , chunk(chunk == 0 ? 1 : chunk)
+        {
+        }
+        query_type query;
+        coordination_type coordination;
+        std::size_t chunk;
+    };
+    from_query_initial_type initial;
+
+    from_query(query_type q, coordination_type cn, std::size_t chunk)
+        : initial(std::move(q), std::move(cn), chunk)
+    {
+    }
+    template<class Subscriber>
+    void on_subscribe(Subscriber o) const {
+        static_assert(is_subscriber<Subscriber>::value, "subscribe must be passed a subscriber");
+
+        typedef typename coordinator_type::template get<Subscriber>::type output_type;
+
+        struct from_query_state_type
+        {
+            from_query_state_type(const from_query_initial_type& i, output_type o)
+                : query(i.query)
+                , cursor(query.get_cursor())
+                , chunk(i.chunk)
+                , out(std::move(o))
+            {
+            }
+            // the copy keeps any storage owned by the query alive while the cursor reads it
+            query_type query;
+            cursor_type cursor;
+            std::size_t chunk;
+            output_type out;
+        };
+
+        // creates a worker whose lifetime is the same as this subscription
+        auto coordinator = initial.coordination.create_coordinator(o.get_subscription());
+
+        auto controller = coordinator.get_worker();
+
+        // the cursor is not necessarily copyable once it has advanced, so it is shared
+        //   by the copies of the producer
+        auto state = on_exception(
+            [&](){return std::make_shared<from_query_state_type>(initial, o);},
+            o);
+        if (state.empty()) {
+            return;
+        }
+
+        auto producer = [state](const rxsc::schedulable& self){
+            auto& st = *state.get();
+            for (std::size_t sent = 0; sent != st.chunk; ++sent) {
+                if (!st.out.is_subscribed()) {
+                    // terminate loop
+                    return;
+                }
+
+                bool done = false;
+                auto value = on_exception(
+                    [&](){
+                        done = st.cursor.empty();
+                        if (done) {
+                            return rxu::maybe<rxu::value_type_t<traits>>();
+                        }
+                        rxu::maybe<rxu::value_type_t<traits>> v(st.cursor.get());
+                        st.cursor.inc();
+                        return v;
+                    },
+                    st.out);
+                if (value.empty()) {
+                    // the query threw and on_error was sent
+                    return;
+                }
+                if (done) {
+                    st.out.on_completed();
+                    // o is unsubscribed
+                    return;
+                }
+                // send next value
+                st.out.on_next(std::move(value.get().get()));
+            }
+
+            // tail recurse this same action to send the next chunk
+            self();
+        };
+        auto selectedProducer = on_exception(
+            [&](){return coordinator.act(producer);},
+            o);
+        if (selectedProducer.empty()) {
+            return;
+        }
+        controller.schedule(selectedProducer.get());
+    }
+};
+
+}
+
+const std::size_t from_query_default_chunk = 64;
+
+/*! @copydoc rx-from_query.hpp
+ */
+template<class Query>
+auto from_query(Query q, std::size_t chunk = from_query_default_chunk)
+    ->      observable<rxu::value_type_t<detail::from_query_traits<Query>>, detail::from_query<Query, identity_one_worker>> {
+    return  observable<rxu::value_type_t<detail::from_query_traits<Query>>, detail::from_query<Query, identity_one_worker>>(
+                                                                            detail::from_query<Query, identity_one_worker>(std::move(q), identity_immediate(), chunk));
+}
+/*! @copydoc rx-from_query.hpp
+ */
+template<class Query, class Coordination>
+auto from_query(Query q, Coordination cn, std::size_t chunk = from_query_default_chunk)
+    -> typename std::enable_if<is_coordination<Coordination>::value,
+            observable<rxu::value_type_t<detail::from_query_traits<Query>>, detail::from_query<Query, Coordination>>>::type {
+    return  observable<rxu::value_type_t<detail::from_query_traits<Query>>, detail::from_query<Query, Coordination>>(
+                                                                            detail::from_query<Query, Coordination>(std::move(q), std::move(cn), chunk));
+}
+
+}
+
+}
+
+#endif
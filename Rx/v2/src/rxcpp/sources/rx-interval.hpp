@@ -13,11 +13,21 @@
 
     \tparam Coordination  the type of the scheduler (optional)
 
-    \param  period   period between emitted values
-    \param  cn       the scheduler to use for scheduling the items (optional)
+    \param  period    period between emitted values
+    \param  catch_up  what to do when a value is sent late enough that one or more periods have passed (optional, periodic_catch_up::burst by default)
+    \param  cn        the scheduler to use for scheduling the items (optional)
+    \param  timer     a periodic_timer shared with other intervals of the same period (optional, instead of period and cn)
 
     \return  Observable that sends a sequential integer each time interval
 
+    The values are due at initial + (N * period), so a slow subscriber does not delay the values after it.
+    When a value is late by more than a period, periodic_catch_up::burst sends each of the missed values back to back,
+    periodic_catch_up::skip drops them and periodic_catch_up::coalesce sends only the latest. With skip and coalesce the
+    integer sent is the number of the period, so it is incremented by more than one after missed values.
+
+    An interval on a periodic_timer adds an action to the timer instead of scheduling its own, so any number of
+    intervals with the same period share one timer. The values are sent on the timer worker, starting from 1 for each subscription.
+
     \sample
     \snippet interval.cpp interval sample
     \snippet output.txt interval sample
@@ -51,20 +61,26 @@ struct interval : public source_base<long>
 
     struct interval_initial_type
     {
-        interval_initial_type(rxsc::scheduler::clock_type::time_point i, rxsc::scheduler::clock_type::duration p, coordination_type cn)
+        interval_initial_type(rxsc::scheduler::clock_type::time_point i, rxsc::scheduler::clock_type::duration p, rxsc::periodic_catch_up::type cu, coordination_type cn)
             : initial(i)
             , period(p)
+            , catch_up(cu)
             , coordination(std::move(cn))
         {
         }
         rxsc::scheduler::clock_type::time_point initial;
         rxsc::scheduler::clock_type::duration period;
+        rxsc::periodic_catch_up::type catch_up;
         coordination_type coordination;
     };
     interval_initial_type initial;
 
     interval(rxsc::scheduler::clock_type::time_point i, rxsc::scheduler::clock_type::duration p, coordination_type cn)
-        : initial(i, p, std::move(cn))
+        : initial(i, p, rxsc::periodic_catch_up::burst, std::move(cn))
+    {
+    }
+    interval(rxsc::scheduler::clock_type::time_point i, rxsc::scheduler::clock_type::duration p, rxsc::periodic_catch_up::type cu, coordination_type cn)
+        : initial(i, p, cu, std::move(cn))
     {
     }
     template<class Subscriber>
@@ -78,9 +94,21 @@ struct interval : public source_base<long>
 
         auto counter = std::make_shared<long>(0);
 
-        auto producer = [o, counter](const rxsc::schedulable&) {
+        auto origin = initial.initial;
+        auto period = initial.period;
+        auto catch_up = initial.catch_up;
+
+        auto producer = [o, counter, origin, period, catch_up](const rxsc::schedulable& self) {
+            ++(*counter);
+            if (catch_up != rxsc::periodic_catch_up::burst && period > rxsc::scheduler::clock_type::duration::zero()) {
+                // skipped and coalesced periods are counted
+                auto number = static_cast<long>((self.now() - origin) / period) + 1;
+                if (number > *counter) {
+                    *counter = number;
+                }
+            }
             // send next value
-            o.on_next(++(*counter));
+            o.on_next(*counter);
         };
 
         auto selectedProducer = on_exception(
@@ -90,7 +118,38 @@ struct interval : public source_base<long>
             return;
         }
 
-        controller.schedule_periodically(initial.initial, initial.period, selectedProducer.get());
+        controller.schedule_periodically(initial.initial, initial.period, initial.catch_up, selectedProducer.get());
+    }
+};
+
+template<class Timer>
+struct interval_timer : public source_base<long>
+{
+    typedef interval_timer<Timer> this_type;
+
+    Timer timer;
+
+    explicit interval_timer(Timer t)
+        : timer(std::move(t))
+    {
+    }
+    template<class Subscriber>
+    void on_subscribe(Subscriber o) const {
+        static_assert(is_subscriber<Subscriber>::value, "subscribe must be passed a subscriber");
+
+        // the number of the period before the first value sent to this subscriber
+        auto before = std::make_shared<long>(-1);
+
+        auto lifetime = timer.add([o, before](long number) {
+            if (*before < 0) {
+                *before = number - 1;
+            }
+            // send next value
+            o.on_next(number - *before);
+        });
+
+        // when the subscriber is unsubscribed the action is removed from the timer
+        o.add(lifetime);
     }
 };
 
@@ -147,6 +206,56 @@ auto interval(rxsc::scheduler::clock_type::time_point when, rxsc::scheduler::clo
     return          detail::defer_interval<rxsc::scheduler::clock_type::duration, Coordination>::make(when, period, std::move(cn));
 }
 
+/*! @copydoc rx-interval.hpp
+ */
+template<class Duration>
+auto interval(Duration period, rxsc::periodic_catch_up::type catch_up)
+    ->  typename std::enable_if<
+                    detail::defer_interval<Duration, identity_one_worker>::value,
+        typename    detail::defer_interval<Duration, identity_one_worker>::observable_type>::type {
+    return          detail::defer_interval<Duration, identity_one_worker>::make(identity_current_thread().now(), period, catch_up, identity_current_thread());
+}
+
+/*! @copydoc rx-interval.hpp
+ */
+template<class Coordination>
+auto interval(rxsc::scheduler::clock_type::duration period, rxsc::periodic_catch_up::type catch_up, Coordination cn)
+    ->  typename std::enable_if<
+                    detail::defer_interval<rxsc::scheduler::clock_type::duration, Coordination>::value,
+        typename    detail::defer_interval<rxsc::scheduler::clock_type::duration, Coordination>::observable_type>::type {
+    return          detail::defer_interval<rxsc::scheduler::clock_type::duration, Coordination>::make(cn.now(), period, catch_up, std::move(cn));
+}
+
+/*! @copydoc rx-interval.hpp
+ */
+template<class Duration>
+auto interval(rxsc::scheduler::clock_type::time_point when, Duration period, rxsc::periodic_catch_up::type catch_up)
+    ->  typename std::enable_if<
+                    detail::defer_interval<Duration, identity_one_worker>::value,
+        typename    detail::defer_interval<Duration, identity_one_worker>::observable_type>::type {
+    return          detail::defer_interval<Duration, identity_one_worker>::make(when, period, catch_up, identity_current_thread());
+}
+
+/*! @copydoc rx-interval.hpp
+ */
+template<class Coordination>
+auto interval(rxsc::scheduler::clock_type::time_point when, rxsc::scheduler::clock_type::duration period, rxsc::periodic_catch_up::type catch_up, Coordination cn)
+    ->  typename std::enable_if<
+                    detail::defer_interval<rxsc::scheduler::clock_type::duration, Coordination>::value,
+        typename    detail::defer_interval<rxsc::scheduler::clock_type::duration, Coordination>::observable_type>::type {
+    return          detail::defer_interval<rxsc::scheduler::clock_type::duration, Coordination>::make(when, period, catch_up, std::move(cn));
+}
+
+/*! @copydoc rx-interval.hpp
+ */
+template<class Timer>
+auto interval(Timer timer)
+    ->  typename std::enable_if<
+                    std::is_same<Timer, rxsc::periodic_timer>::value,
+                    observable<long, detail::interval_timer<Timer>>>::type {
+    return          observable<long, detail::interval_timer<Timer>>(detail::interval_timer<Timer>(std::move(timer)));
+}
+
 }
 
 }
@@ -0,0 +1,286 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_SOURCES_RX_MAPPED_FILE_HPP)
+#define RXCPP_SOURCES_RX_MAPPED_FILE_HPP
+
+#include "../rx-includes.hpp"
+
+#include "rx-file_mapping.hpp"
+
+#include <cstring>
+#include <system_error>
+
+#if (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L
+#include <string_view>
+#define RXCPP_HAS_STRING_VIEW 1
+#endif
+
+/*! \file rx-mapped_file.hpp
+
+    \brief Returns an observable that maps a file into memory and sends its contents as lines or as chunks of lines, on the specified scheduler.
+
+    This header is not included by rx.hpp, since it includes the platform headers.
+
+    \tparam Coordination  the type of the scheduler (optional)
+
+    \param  path        the path of the file
+    \param  chunk_size  the maximum size of each chunk (mapped_file_chunks only)
+    \param  cn          the scheduler to use for scheduling the items (optional)
+
+    \return  Observable that sends a mapped_chunk for each line (mapped_file_lines) or for each chunk (mapped_file_chunks) of the file.
+
+    The file is mapped when the observable is subscribed and an error opening or mapping it is sent to on_error.
+    The values point into the mapping instead of copying the file. Each mapped_chunk holds a reference to the mapping,
+    so the bytes stay valid while any value is buffered by later operators, such as observe_on.
+
+    mapped_file_lines sends each line without its '\n' or "\r\n" terminator.
+    mapped_file_chunks sends chunks of at most chunk_size bytes that end after a '\n', unless a line is longer than
+    chunk_size, in which case the line is split.
+
+    \sample
+    \code{.cpp}
+    #include <rxcpp/sources/rx-mapped_file.hpp>
+
+    rxcpp::sources::mapped_file_lines("server.log").
+        filter([](const rxcpp::sources::mapped_chunk& line){ return line.size() > 5 && line.data()[0] == 'E'; }).
+        count().
+        subscribe([](int n){ printf("errors: %d\n", n); });
+    \endcode
+*/
+
+namespace rxcpp {
+
+namespace sources {
+
+namespace detail {
+
+// a read only mapping of a whole file, which throws when the file cannot be mapped
+class mapped_file : public file_mapping
+{
+public:
+    explicit mapped_file(const std::string& path) {
+        std::error_code error;
+        const char* failed = nullptr;
+        if (!map(path, error, failed)) {
+            rxu::throw_exception(std::system_error(error, std::string("mapped_file: ") + failed + path));
+        }
+    }
+};
+
+}
+
+/*! \brief A range of bytes in a mapped file. Copies share the mapping, which is released when the last copy is destroyed.
+*/
+class mapped_chunk
+{
+    std::shared_ptr<const detail::mapped_file> file;
+    const char* first;
+    std::size_t length;
+
+public:
+    mapped_chunk()
+        : first(nullptr)
+        , length(0)
+    {
+    }
+    mapped_chunk(std::shared_ptr<const detail::mapped_file> f, const char* first, std::size_t length)
+        : file(std::move(f))
+        , first(first)
+        , length(length)
+    {
+    }
+
+    const char* data() const { return first; }
+    std::size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    const char* begin() const { return first; }
+    const char* end() const { return first + length; }
+
+    std::string str() const { return std::string(first, length); }
+#if defined(RXCPP_HAS_STRING_VIEW)
+    operator std::string_view() const { return std::string_view(first, length); }
+#endif
+};
+
+inline bool operator==(const mapped_chunk& lhs, const mapped_chunk& rhs) {
+    return lhs.size() == rhs.size() && (lhs.size() == 0 || std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0);
+}
+inline bool operator!=(const mapped_chunk& lhs, const mapped_chunk& rhs) {
+    return !(lhs == rhs);
+}
+
+namespace detail {
+
+template<class Coordination>
+struct mapped_file_source : public source_base<mapped_chunk>
+{
+    typedef mapped_file_source<Coordination> this_type;
+
+    typedef rxu::decay_t<Coordination> coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+
+    struct mapped_file_initial_type
+    {
+        mapped_file_initial_type(std::string p, std::size_t cs, coordination_type cn)
+            : path(std::move(p))
+            , chunk_size(cs)
+            , coordination(std::move(cn))
+        {
+        }
+        std::string path;
+        // 0 sends lines
+        std::size_t chunk_size;
+        coordination_type coordination;
+    };
+    mapped_file_initial_type initial;
+
+    mapped_file_source(std::string path, std::size_t chunk_size, coordination_type cn)
+        : initial(std::move(path), chunk_size, std::move(cn))
+    {
+    }
+    template<class Subscriber>
+    void on_subscribe(Subscriber o) const {
+        static_assert(is_subscriber<Subscriber>::value, "subscribe must be passed a subscriber");
+
+        typedef typename coordinator_type::template get<Subscriber>::type output_type;
+
+        struct mapped_file_state_type
+        {
+            mapped_file_state_type(const mapped_file_initial_type& i, output_type o)
+                : file(std::make_shared<mapped_file>(i.path))
+                , current(file->data())
+                , fin(file->data() + file->size())
+                , chunk_size(i.chunk_size)
+                , out(std::move(o))
+            {
+            }
+            std::shared_ptr<const mapped_file> file;
+            const char* current;
+            const char* fin;
+            std::size_t chunk_size;
+            output_type out;
+
+            mapped_chunk next_line() {
+                auto line_end = static_cast<const char*>(std::memchr(current, '\n', fin - current));
+                if (!line_end) {
+                    line_end = fin;
+                }
+                auto last = line_end;
+                if (last != current && last[-1] == '\r') {
+                    --last;
+                }
+                mapped_chunk line(file, current, last - current);
+                current = line_end == fin ? fin : line_end + 1;
+                return line;
+            }
+            mapped_chunk next_chunk() {
+                std::size_t length = static_cast<std::size_t>(fin - current);
+                if (length > chunk_size) {
+                    length = chunk_size;
+                    // end the chunk after the last complete line, when there is one
+                    for (auto last = current + chunk_size; last != current; --last) {
+                        if (last[-1] == '\n') {
+                            length = last - current;
+                            break;
+                        }
+                    }
+                }
+                mapped_chunk chunk(file, current, length);
+                current += length;
+                return chunk;
+            }
+        };
+
+        // creates a worker whose lifetime is the same as this subscription
+        auto coordinator = initial.coordination.create_coordinator(o.get_subscription());
+
+        auto controller = coordinator.get_worker();
+
+        // the file is mapped once per subscription
+        auto state = on_exception(
+            [&](){return std::make_shared<mapped_file_state_type>(initial, o);},
+            o);
+        if (state.empty()) {
+            return;
+        }
+
+        auto producer = [state](const rxsc::schedulable& self){
+            auto& st = *state.get();
+            for (int sent = 0; sent != 64; ++sent) {
+                if (!st.out.is_subscribed()) {
+                    // terminate loop
+                    return;
+                }
+
+                if (st.current == st.fin) {
+                    st.out.on_completed();
+                    // o is unsubscribed
+                    return;
+                }
+
+                // send next value
+                st.out.on_next(st.chunk_size == 0 ? st.next_line() : st.next_chunk());
+            }
+
+            // tail recurse this same action to send the next batch
+            self();
+        };
+        auto selectedProducer = on_exception(
+            [&](){return coordinator.act(producer);},
+            o);
+        if (selectedProducer.empty()) {
+            return;
+        }
+        controller.schedule(selectedProducer.get());
+    }
+};
+
+}
+
+/*! @copydoc rx-mapped_file.hpp
+ */
+inline auto mapped_file_lines(std::string path)
+    ->      observable<mapped_chunk, detail::mapped_file_source<identity_one_worker>> {
+    return  observable<mapped_chunk, detail::mapped_file_source<identity_one_worker>>(
+                                     detail::mapped_file_source<identity_one_worker>(std::move(path), 0, identity_current_thread()));
+}
+/*! @copydoc rx-mapped_file.hpp
+ */
+template<class Coordination>
+auto mapped_file_lines(std::string path, Coordination cn)
+    -> typename std::enable_if<is_coordination<Coordination>::value,
+            observable<mapped_chunk, detail::mapped_file_source<Coordination>>>::type {
+    return  observable<mapped_chunk, detail::mapped_file_source<Coordination>>(
+                                     detail::mapped_file_source<Coordination>(std::move(path), 0, std::move(cn)));
+}
+
+/*! @copydoc rx-mapped_file.hpp
+ */
+inline auto mapped_file_chunks(std::string path, std::size_t chunk_size)
+    ->      observable<mapped_chunk, detail::mapped_file_source<identity_one_worker>> {
+    if (chunk_size == 0) {
+        rxu::throw_exception(std::logic_error("mapped_file_chunks: chunk_size must not be 0"));
+    }
+    return  observable<mapped_chunk, detail::mapped_file_source<identity_one_worker>>(
+                                     detail::mapped_file_source<identity_one_worker>(std::move(path), chunk_size, identity_current_thread()));
+}
+/*! @copydoc rx-mapped_file.hpp
+ */
+template<class Coordination>
+auto mapped_file_chunks(std::string path, std::size_t chunk_size, Coordination cn)
+    -> typename std::enable_if<is_coordination<Coordination>::value,
+            observable<mapped_chunk, detail::mapped_file_source<Coordination>>>::type {
+    if (chunk_size == 0) {
+        rxu::throw_exception(std::logic_error("mapped_file_chunks: chunk_size must not be 0"));
+    }
+    return  observable<mapped_chunk, detail::mapped_file_source<Coordination>>(
+                                     detail::mapped_file_source<Coordination>(std::move(path), chunk_size, std::move(cn)));
+}
+
+}
+
+}
+
+#endif
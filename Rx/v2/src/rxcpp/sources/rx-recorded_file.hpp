@@ -0,0 +1,602 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_SOURCES_RX_RECORDED_FILE_HPP)
+#define RXCPP_SOURCES_RX_RECORDED_FILE_HPP
+
+#include "../rx-includes.hpp"
+
+#include <fstream>
+
+/*! \file rx-recorded_file.hpp
+
+    \brief record_to writes each notification of the source and the time it arrived to a binary file.
+    replay_from returns an observable that sends the notifications in a file written by record_to, either as fast as
+    possible or with the recorded times scaled by speed, on the specified scheduler.
+
+    This header is not included by rx.hpp, since it includes <fstream>.
+
+    \tparam T             the type of the values in the file (replay_from only)
+    \tparam Coordination  the type of the scheduler (optional)
+
+    \param  path   the path of the file
+    \param  speed  0 sends the notifications as fast as possible, 1 sends them at the recorded times, 2 twice as fast (replay_from only)
+    \param  cn     the scheduler whose clock is recorded (record_to) or that sends the notifications (replay_from) (optional)
+
+    \return  record_to returns an operator that passes the notifications through unchanged.
+    replay_from returns an observable that sends the recorded notifications.
+
+    The file is written once for each subscription to the recorded observable and each subscription to replay_from reads
+    the file again. A file that cannot be opened or written and a file that is not complete are sent to on_error.
+    The times are recorded in microseconds since the subscription. An error is recorded as its message and replayed as
+    a std::runtime_error. A file that ends before on_error or on_completed, because the subscriber unsubscribed,
+    is replayed with on_completed at the end.
+
+    Values are written by recorded_file_codec<T>, which is defined for types that are trivial and standard layout,
+    such as arithmetic types and plain structs, for std::string and for rxcpp::byte_slice, and may be specialized for
+    other types. Trivial values are written in the byte order of the machine.
+
+    read_recorded_file returns the contents of a file as a vector of rxn::recorded, for comparing and analyzing
+    recordings offline. The times are in microseconds since the subscription, unless a resolution and an origin are
+    passed, then each time is origin plus the number of whole resolutions since the subscription. To compare a file
+    with the messages of rxsc::test, pass the millisecond ticks of the test clock and the subscription time of start():
+    read_recorded_file<T>(path, std::chrono::milliseconds(1), rxsc::test::subscribed_time).
+
+    \sample
+    \code{.cpp}
+    #include <rxcpp/sources/rx-recorded_file.hpp>
+
+    // capture
+    prices.
+        op(rxcpp::operators::record_to("prices.rxrec")).
+        subscribe(...);
+
+    // replay offline, twice as fast as it was recorded
+    rxcpp::sources::replay_from<double>("prices.rxrec", 2.0, rxcpp::observe_on_event_loop()).
+        as_blocking().
+        subscribe(...);
+    \endcode
+*/
+
+namespace rxcpp {
+
+namespace sources {
+
+/*! \brief writes and reads the values of type T in a recorded file. read returns false when the stream ends.
+*/
+template<class T, class Enabled = void>
+struct recorded_file_codec;
+
+template<class T>
+struct recorded_file_codec<T, typename std::enable_if<std::is_trivial<T>::value && std::is_standard_layout<T>::value>::type>
+{
+    static void write(std::ostream& out, const T& v) {
+        out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+    static bool read(std::istream& in, T& v) {
+        return !!in.read(reinterpret_cast<char*>(&v), sizeof(T));
+    }
+};
+
+namespace detail {
+
+inline void write_recorded_varint(std::ostream& out, unsigned long long v) {
+    char bytes[10];
+    int count = 0;
+    do {
+        bytes[count++] = static_cast<char>((v & 0x7f) | (v > 0x7f ? 0x80 : 0));
+        v >>= 7;
+    } while (v != 0);
+    out.write(bytes, count);
+}
+
+inline bool read_recorded_varint(std::istream& in, unsigned long long& v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        auto byte = in.get();
+        if (byte == std::char_traits<char>::eof()) {
+            return false;
+        }
+        v |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void write_recorded_bytes(std::ostream& out, const void* data, std::size_t size) {
+    write_recorded_varint(out, size);
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+template<class Container>
+bool read_recorded_bytes(std::istream& in, Container& c) {
+    unsigned long long size = 0;
+    if (!read_recorded_varint(in, size)) {
+        return false;
+    }
+    c.resize(static_cast<std::size_t>(size));
+    return size == 0 || !!in.read(reinterpret_cast<char*>(&c[0]), static_cast<std::streamsize>(size));
+}
+
+}
+
+template<>
+struct recorded_file_codec<std::string>
+{
+    static void write(std::ostream& out, const std::string& v) {
+        detail::write_recorded_bytes(out, v.data(), v.size());
+    }
+    static bool read(std::istream& in, std::string& v) {
+        return detail::read_recorded_bytes(in, v);
+    }
+};
+
+template<>
+struct recorded_file_codec<byte_slice>
+{
+    static void write(std::ostream& out, const byte_slice& v) {
+        detail::write_recorded_bytes(out, v.data(), v.size());
+    }
+    static bool read(std::istream& in, byte_slice& v) {
+        std::vector<uint8_t> bytes;
+        if (!detail::read_recorded_bytes(in, bytes)) {
+            return false;
+        }
+        v = byte_slice(std::move(bytes));
+        return true;
+    }
+};
+
+namespace detail {
+
+// the file starts with this header, followed by a record for each notification:
+//  kind (1 byte), microseconds since the previous record (varint), then the value or the error message
+static const char recorded_file_header[8] = {'r', 'x', 'r', 'e', 'c', '\0', '\0', '\1'};
+
+struct recorded_file_kind
+{
+    enum type {
+        on_next = 0,
+        on_error = 1,
+        on_completed = 2
+    };
+};
+
+template<class T>
+class recorded_file_writer
+{
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    std::ofstream out;
+    std::string path;
+    clock_type::time_point started;
+    long long last;
+
+    recorded_file_writer(const recorded_file_writer&);
+    recorded_file_writer& operator=(const recorded_file_writer&);
+
+    void write_time(clock_type::time_point now) {
+        auto time = static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(now - started).count());
+        // the clock of a scheduler may not be steady
+        if (time < last) {
+            time = last;
+        }
+        write_recorded_varint(out, static_cast<unsigned long long>(time - last));
+        last = time;
+    }
+
+public:
+    recorded_file_writer(std::string p, clock_type::time_point now)
+        : out(p.c_str(), std::ios::binary | std::ios::trunc)
+        , path(std::move(p))
+        , started(now)
+        , last(0)
+    {
+        out.write(recorded_file_header, sizeof(recorded_file_header));
+    }
+
+    // returns the error to send when the file cannot be written
+    rxu::error_ptr check() const {
+        if (!out) {
+            return rxu::make_error_ptr(std::runtime_error("record_to: cannot write " + path));
+        }
+        return rxu::error_ptr();
+    }
+
+    void on_next(clock_type::time_point now, const T& v) {
+        out.put(static_cast<char>(recorded_file_kind::on_next));
+        write_time(now);
+        recorded_file_codec<T>::write(out, v);
+    }
+    void on_error(clock_type::time_point now, rxu::error_ptr e) {
+        out.put(static_cast<char>(recorded_file_kind::on_error));
+        write_time(now);
+        auto message = rxu::what(e);
+        write_recorded_bytes(out, message.data(), message.size());
+        out.flush();
+    }
+    void on_completed(clock_type::time_point now) {
+        out.put(static_cast<char>(recorded_file_kind::on_completed));
+        write_time(now);
+        out.flush();
+    }
+};
+
+template<class T>
+class recorded_file_reader
+{
+    std::ifstream in;
+    std::string path;
+
+    recorded_file_reader(const recorded_file_reader&);
+    recorded_file_reader& operator=(const recorded_file_reader&);
+
+    void fail(const std::string& what) const {
+        rxu::throw_exception(std::runtime_error("replay_from: " + path + " " + what));
+    }
+
+public:
+    enum kind_type {
+        end_of_file,
+        on_next,
+        on_error,
+        on_completed
+    };
+
+    /// the microseconds since the subscription of the last record that was read
+    long long time;
+    T value;
+    std::string message;
+
+    explicit recorded_file_reader(std::string p)
+        : in(p.c_str(), std::ios::binary)
+        , path(std::move(p))
+        , time(0)
+        , value()
+    {
+        if (!in) {
+            fail("cannot be opened");
+        }
+        char header[sizeof(recorded_file_header)];
+        if (!in.read(header, sizeof(header)) || !std::equal(header, header + sizeof(header), recorded_file_header)) {
+            fail("is not a recorded file");
+        }
+    }
+
+    kind_type read() {
+        auto kind = in.get();
+        if (kind == std::char_traits<char>::eof()) {
+            return end_of_file;
+        }
+        unsigned long long delta = 0;
+        if (!read_recorded_varint(in, delta)) {
+            fail("ends in the middle of a record");
+        }
+        time += static_cast<long long>(delta);
+        switch (kind) {
+        case recorded_file_kind::on_next:
+            if (!recorded_file_codec<T>::read(in, value)) {
+                fail("ends in the middle of a record");
+            }
+            return on_next;
+        case recorded_file_kind::on_error:
+            if (!read_recorded_bytes(in, message)) {
+                fail("ends in the middle of a record");
+            }
+            return on_error;
+        case recorded_file_kind::on_completed:
+            return on_completed;
+        default:
+            fail("has a record of an unknown kind");
+        }
+        return end_of_file;
+    }
+};
+
+template<class T, class Coordination>
+struct replay_from : public source_base<T>
+{
+    typedef replay_from<T, Coordination> this_type;
+
+    typedef rxu::decay_t<Coordination> coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+    typedef rxsc::scheduler::clock_type clock_type;
+
+    struct replay_from_initial_type
+    {
+        replay_from_initial_type(std::string p, double s, coordination_type cn)
+            : path(std::move(p))
+            , speed(s)
+            , coordination(std::move(cn))
+        {
+        }
+        std::string path;
+        // 0 is as fast as possible
+        double speed;
+        coordination_type coordination;
+    };
+    replay_from_initial_type initial;
+
+    replay_from(std::string path, double speed, coordination_type cn)
+        : initial(std::move(path), speed, std::move(cn))
+    {
+    }
+    template<class Subscriber>
+    void on_subscribe(Subscriber o) const {
+        static_assert(is_subscriber<Subscriber>::value, "subscribe must be passed a subscriber");
+
+        typedef typename coordinator_type::template get<Subscriber>::type output_type;
+        typedef recorded_file_reader<T> reader_type;
+
+        struct replay_from_state_type
+        {
+            replay_from_state_type(const replay_from_initial_type& i, clock_type::time_point now, output_type o)
+                : reader(i.path)
+                , speed(i.speed)
+                , started(now)
+                , kind(reader_type::end_of_file)
+                , pending(false)
+                , out(std::move(o))
+            {
+            }
+            reader_type reader;
+            double speed;
+            clock_type::time_point started;
+            typename reader_type::kind_type kind;
+            // a record has been read and not sent
+            bool pending;
+            output_type out;
+
+            clock_type::time_point due() const {
+                return started + std::chrono::duration_cast<clock_type::duration>(
+                    std::chrono::duration<double, std::micro>(static_cast<double>(reader.time) / speed));
+            }
+        };
+
+        // creates a worker whose lifetime is the same as this subscription
+        auto coordinator = initial.coordination.create_coordinator(o.get_subscription());
+
+        auto controller = coordinator.get_worker();
+
+        // the file is opened once per subscription
+        auto state = on_exception(
+            [&](){return std::make_shared<replay_from_state_type>(initial, controller.now(), o);},
+            o);
+        if (state.empty()) {
+            return;
+        }
+
+        // the schedulable only holds a weak reference to the worker
+        auto producer = [state, controller](const rxsc::schedulable& self){
+            auto& st = *state.get();
+            for (int sent = 0; st.speed > 0 || sent != 64; ++sent) {
+                if (!st.out.is_subscribed()) {
+                    // terminate loop
+                    return;
+                }
+
+                if (!st.pending) {
+                    auto kind = on_exception(
+                        [&](){return st.reader.read();},
+                        st.out);
+                    if (kind.empty()) {
+                        return;
+                    }
+                    st.kind = kind.get();
+                    st.pending = true;
+                }
+
+                if (st.speed > 0 && st.kind != reader_type::end_of_file) {
+                    auto due = st.due();
+                    if (self.now() < due) {
+                        // send the record at the scaled time
+                        self.schedule(due);
+                        return;
+                    }
+                }
+
+                st.pending = false;
+                switch (st.kind) {
+                case reader_type::on_next:
+                    st.out.on_next(st.reader.value);
+                    break;
+                case reader_type::on_error:
+                    st.out.on_error(rxu::make_error_ptr(std::runtime_error(st.reader.message)));
+                    return;
+                case reader_type::on_completed:
+                case reader_type::end_of_file:
+                    st.out.on_completed();
+                    return;
+                }
+            }
+
+            // tail recurse this same action to send the next batch
+            self();
+        };
+        auto selectedProducer = on_exception(
+            [&](){return coordinator.act(producer);},
+            o);
+        if (selectedProducer.empty()) {
+            return;
+        }
+        controller.schedule(selectedProducer.get());
+    }
+};
+
+}
+
+/*! @copydoc rx-recorded_file.hpp
+ */
+template<class T>
+auto replay_from(std::string path, double speed = 0)
+    ->      observable<T, detail::replay_from<T, identity_one_worker>> {
+    return  observable<T, detail::replay_from<T, identity_one_worker>>(
+                          detail::replay_from<T, identity_one_worker>(std::move(path), speed, identity_current_thread()));
+}
+/*! @copydoc rx-recorded_file.hpp
+ */
+template<class T, class Coordination>
+auto replay_from(std::string path, double speed, Coordination cn)
+    -> typename std::enable_if<is_coordination<Coordination>::value,
+            observable<T, detail::replay_from<T, Coordination>>>::type {
+    return  observable<T, detail::replay_from<T, Coordination>>(
+                          detail::replay_from<T, Coordination>(std::move(path), speed, std::move(cn)));
+}
+
+/*! @copydoc rx-recorded_file.hpp
+ */
+template<class T, class Rep, class Period>
+std::vector<rxn::recorded<typename rxn::notification<T>::type>> read_recorded_file(std::string path, std::chrono::duration<Rep, Period> resolution, long origin = 0) {
+    typedef rxn::notification<T> notification_type;
+    typedef detail::recorded_file_reader<T> reader_type;
+    std::vector<rxn::recorded<typename notification_type::type>> result;
+    reader_type reader(std::move(path));
+    for (;;) {
+        auto kind = reader.read();
+        if (kind == reader_type::end_of_file) {
+            break;
+        }
+        auto time = origin + static_cast<long>(std::chrono::microseconds(reader.time) / resolution);
+        if (kind == reader_type::on_next) {
+            result.push_back(rxn::recorded<typename notification_type::type>(time, notification_type::on_next(reader.value)));
+        } else if (kind == reader_type::on_error) {
+            result.push_back(rxn::recorded<typename notification_type::type>(time, notification_type::on_error(rxu::make_error_ptr(std::runtime_error(reader.message)))));
+        } else {
+            result.push_back(rxn::recorded<typename notification_type::type>(time, notification_type::on_completed()));
+        }
+    }
+    return result;
+}
+/*! @copydoc rx-recorded_file.hpp
+ */
+template<class T>
+std::vector<rxn::recorded<typename rxn::notification<T>::type>> read_recorded_file(std::string path) {
+    return read_recorded_file<T>(std::move(path), std::chrono::microseconds(1));
+}
+
+}
+
+namespace operators {
+
+namespace detail {
+
+template<class T, class Coordination>
+struct record_to
+{
+    typedef rxu::decay_t<T> source_value_type;
+    typedef rxu::decay_t<Coordination> coordination_type;
+    typedef rxs::detail::recorded_file_writer<source_value_type> writer_type;
+
+    std::string path;
+    coordination_type coordination;
+
+    record_to(std::string p, coordination_type cn)
+        : path(std::move(p))
+        , coordination(std::move(cn))
+    {
+    }
+
+    template<class Subscriber>
+    struct record_to_observer
+    {
+        typedef record_to_observer<Subscriber> this_type;
+        typedef observer<source_value_type, this_type> observer_type;
+        typedef rxu::decay_t<Subscriber> dest_type;
+        dest_type dest;
+        coordination_type coordination;
+        std::shared_ptr<writer_type> writer;
+
+        record_to_observer(dest_type d, coordination_type cn, std::shared_ptr<writer_type> w)
+            : dest(std::move(d))
+            , coordination(std::move(cn))
+            , writer(std::move(w))
+        {
+        }
+        void on_next(const source_value_type& v) const {
+            writer->on_next(coordination.now(), v);
+            auto e = writer->check();
+            if (e) {
+                dest.on_error(e);
+                return;
+            }
+            dest.on_next(v);
+        }
+        void on_error(rxu::error_ptr e) const {
+            writer->on_error(coordination.now(), e);
+            dest.on_error(e);
+        }
+        void on_completed() const {
+            writer->on_completed(coordination.now());
+            auto e = writer->check();
+            if (e) {
+                dest.on_error(e);
+                return;
+            }
+            dest.on_completed();
+        }
+
+        static subscriber<source_value_type, observer_type> make(dest_type d, coordination_type cn, std::string path) {
+            auto cs = d.get_subscription();
+            // the file is written once per subscription
+            auto w = std::make_shared<writer_type>(std::move(path), cn.now());
+            auto e = w->check();
+            if (e) {
+                d.on_error(e);
+            }
+            return make_subscriber<source_value_type>(std::move(cs), observer_type(this_type(std::move(d), std::move(cn), std::move(w))));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(record_to_observer<Subscriber>::make(std::move(dest), coordination, path)) {
+        return      record_to_observer<Subscriber>::make(std::move(dest), coordination, path);
+    }
+};
+
+template<class Coordination>
+struct record_to_factory
+{
+    typedef rxu::decay_t<Coordination> coordination_type;
+
+    std::string path;
+    coordination_type coordination;
+
+    record_to_factory(std::string p, coordination_type cn)
+        : path(std::move(p))
+        , coordination(std::move(cn))
+    {
+    }
+
+    template<class Observable>
+    auto operator()(const Observable& source) const
+        -> decltype(source.template lift<rxu::value_type_t<Observable>>(record_to<rxu::value_type_t<Observable>, coordination_type>(path, coordination))) {
+        return      source.template lift<rxu::value_type_t<Observable>>(record_to<rxu::value_type_t<Observable>, coordination_type>(path, coordination));
+    }
+};
+
+}
+
+/*! @copydoc rx-recorded_file.hpp
+ */
+inline auto record_to(std::string path)
+    ->      detail::record_to_factory<identity_one_worker> {
+    return  detail::record_to_factory<identity_one_worker>(std::move(path), identity_current_thread());
+}
+/*! @copydoc rx-recorded_file.hpp
+ */
+template<class Coordination>
+auto record_to(std::string path, Coordination cn)
+    -> typename std::enable_if<is_coordination<Coordination>::value,
+            detail::record_to_factory<Coordination>>::type {
+    return  detail::record_to_factory<Coordination>(std::move(path), std::move(cn));
+}
+
+}
+
+}
+
+#endif
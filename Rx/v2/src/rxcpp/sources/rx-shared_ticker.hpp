@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_SOURCES_RX_SHARED_TICKER_HPP)
+#define RXCPP_SOURCES_RX_SHARED_TICKER_HPP
+
+#include "../rx-includes.hpp"
+
+/*! \file rx-shared_ticker.hpp
+
+    \brief Returns an observable that emits the number of each tick of a timer that is shared by all the tickers with the same period on the same scheduler.
+
+    \tparam Coordination  the type of the scheduler
+
+    \param  period  period between the ticks
+    \param  cn      the scheduler that runs the timer and delivers the ticks
+
+    \return  Observable that sends the number of each tick.
+
+    There is one rxsc::periodic_timer for each period and scheduler. It runs one periodic action that sends each tick to all the subscribers,
+    so subscribing adds the subscriber to a list instead of scheduling a timer, and unsubscribing removes it.
+    The timer is created when the first subscriber subscribes and released when the last one unsubscribes.
+
+    The ticks are numbered from 1, one period after the timer was created, so every subscriber receives the same number for the same tick
+    and a later subscriber continues the numbering. Once all the subscribers are gone, the next subscriber starts a new timer.
+    The timer runs on a worker of the coordination's scheduler that it owns. Each subscription gets its own coordinator, and the ticks
+    are sent through coordinator.out, so that a coordination such as observe_on_event_loop delivers them as it does for interval.
+
+    \sample
+    \code{.cpp}
+    auto heartbeat = rxcpp::observable<>::shared_ticker(std::chrono::seconds(1), rxcpp::observe_on_event_loop());
+    // both subscriptions are sent from the same timer
+    heartbeat.subscribe([](long tick){ printf("a: %ld\n", tick); });
+    heartbeat.subscribe([](long tick){ printf("b: %ld\n", tick); });
+    \endcode
+*/
+
+namespace rxcpp {
+
+namespace sources {
+
+namespace detail {
+
+struct shared_ticker_timer
+{
+    explicit shared_ticker_timer(rxsc::periodic_timer t)
+        : timer(std::move(t))
+    {
+    }
+    ~shared_ticker_timer()
+    {
+        // the worker is only used by this timer
+        timer.get_worker().unsubscribe();
+    }
+    rxsc::periodic_timer timer;
+};
+
+// the timers that are in use, by scheduler and period.
+class shared_ticker_registry
+{
+    struct entry_type
+    {
+        rxsc::scheduler factory;
+        rxsc::scheduler::clock_type::duration period;
+        std::weak_ptr<shared_ticker_timer> timer;
+    };
+
+    std::mutex lock;
+    std::vector<entry_type> entries;
+
+public:
+    static shared_ticker_registry& instance() {
+        static shared_ticker_registry r;
+        return r;
+    }
+
+    std::shared_ptr<shared_ticker_timer> get(rxsc::scheduler factory, rxsc::scheduler::clock_type::duration period) {
+        std::unique_lock<std::mutex> guard(lock);
+        for (auto& e : entries) {
+            if (e.period == period && e.factory == factory) {
+                auto timer = e.timer.lock();
+                if (timer) {
+                    return timer;
+                }
+            }
+        }
+        // forget the timers that are no longer used
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [](const entry_type& e){
+                return e.timer.expired();
+            }), entries.end());
+
+        auto w = factory.create_worker();
+        auto timer = std::make_shared<shared_ticker_timer>(rxsc::periodic_timer(w, w.now() + period, period));
+        entry_type e = {factory, period, timer};
+        entries.push_back(std::move(e));
+        return timer;
+    }
+};
+
+template<class Coordination>
+struct shared_ticker : public source_base<long>
+{
+    typedef shared_ticker<Coordination> this_type;
+
+    typedef rxu::decay_t<Coordination> coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+
+    coordination_type coordination;
+    rxsc::scheduler::clock_type::duration period;
+
+    shared_ticker(coordination_type cn, rxsc::scheduler::clock_type::duration p)
+        : coordination(std::move(cn))
+        , period(p)
+    {
+    }
+    template<class Subscriber>
+    void on_subscribe(Subscriber o) const {
+        static_assert(is_subscriber<Subscriber>::value, "subscribe must be passed a subscriber");
+
+        // creates a worker whose lifetime is the same as this subscription
+        auto coordinator = coordination.create_coordinator(o.get_subscription());
+
+        auto selectedDest = on_exception(
+            [&](){return coordinator.out(o);},
+            o);
+        if (selectedDest.empty()) {
+            return;
+        }
+        auto dest = selectedDest.get();
+
+        // the timer is found or created for each subscription, so that it is only running while subscribed
+        auto ticker = shared_ticker_registry::instance().get(coordination.get_scheduler(), period);
+
+        auto lifetime = ticker->timer.add([dest](long number) {
+            // send next value
+            dest.on_next(number);
+        });
+
+        // when the subscriber is unsubscribed it is removed from the timer
+        o.add(lifetime);
+
+        // the timer is kept while there are subscribers
+        o.add([ticker](){});
+    }
+};
+
+}
+
+/*! @copydoc rx-shared_ticker.hpp
+ */
+template<class Coordination>
+auto shared_ticker(rxsc::scheduler::clock_type::duration period, Coordination cn)
+    ->  typename std::enable_if<
+                    is_coordination<Coordination>::value,
+                    observable<long, detail::shared_ticker<Coordination>>>::type {
+    return          observable<long, detail::shared_ticker<Coordination>>(
+                                     detail::shared_ticker<Coordination>(std::move(cn), period));
+}
+
+}
+
+}
+
+#endif
@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_DISPATCH_HPP)
+#define RXCPP_RX_DISPATCH_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace subjects {
+
+/// what a dispatch queue does with a value that arrives when the queue is full
+struct overflow_policy
+{
+    enum type {
+        /// the new value is dropped
+        drop_newest,
+        /// the oldest queued value is dropped
+        drop_oldest,
+        /// the newest queued value is replaced by the new value
+        conflate
+    };
+};
+
+namespace detail {
+
+// the bounded queue of one subscriber of a dispatch subject.
+// values are queued by the producer and sent to the subscriber on a worker of the coordination.
+template<class T, class Coordination>
+class dispatch_queue
+{
+    typedef dispatch_queue<T, Coordination> this_type;
+
+    typedef rxu::decay_t<Coordination> coordination_type;
+    typedef typename coordination_type::coordinator_type coordinator_type;
+
+    struct dispatch_queue_state : public std::enable_shared_from_this<dispatch_queue_state>
+    {
+        dispatch_queue_state(subscriber<T> d, coordinator_type coor, std::size_t c, overflow_policy::type p, drain_budget b)
+            : destination(std::move(d))
+            , coordinator(std::move(coor))
+            , capacity(c == 0 ? 1 : c)
+            , policy(p)
+            , budget(b)
+            , completed(false)
+            , draining(false)
+        {
+        }
+
+        subscriber<T> destination;
+        coordinator_type coordinator;
+        std::size_t capacity;
+        overflow_policy::type policy;
+        drain_budget budget;
+
+        mutable std::mutex lock;
+        std::deque<T> queue;
+        rxu::error_ptr error;
+        bool completed;
+        bool draining;
+
+        void push(T v) {
+            std::unique_lock<std::mutex> guard(lock);
+            if (completed || error) {
+                return;
+            }
+            if (queue.size() >= capacity) {
+                switch (policy) {
+                case overflow_policy::drop_newest:
+                    return;
+                case overflow_policy::drop_oldest:
+                    queue.pop_front();
+                    break;
+                case overflow_policy::conflate:
+                    queue.back() = std::move(v);
+                    return;
+                }
+            }
+            queue.push_back(std::move(v));
+            ensure_draining(guard);
+        }
+
+        void finish(rxu::error_ptr e) {
+            std::unique_lock<std::mutex> guard(lock);
+            if (completed || error) {
+                return;
+            }
+            if (e) {
+                error = e;
+            } else {
+                completed = true;
+            }
+            ensure_draining(guard);
+        }
+
+        void ensure_draining(std::unique_lock<std::mutex>& guard) {
+            if (draining) {
+                return;
+            }
+            draining = true;
+
+            auto keepAlive = this->shared_from_this();
+            auto drain = [keepAlive, this](const rxsc::schedulable& self){
+                RXCPP_TRY {
+                    auto meter = budget.start(self);
+                    for (;;) {
+                        std::unique_lock<std::mutex> guard(lock);
+                        if (!destination.is_subscribed()) {
+                            queue.clear();
+                            draining = false;
+                            return;
+                        }
+                        if (queue.empty()) {
+                            draining = false;
+                            if (error) {
+                                auto e = error;
+                                guard.unlock();
+                                destination.on_error(e);
+                            } else if (completed) {
+                                guard.unlock();
+                                destination.on_completed();
+                            }
+                            return;
+                        }
+                        auto value = std::move(queue.front());
+                        queue.pop_front();
+                        guard.unlock();
+                        destination.on_next(std::move(value));
+                        if (meter.spend(self)) {
+                            break;
+                        }
+                    }
+                    self();
+                }
+                RXCPP_CATCH(...) {
+                    auto e = rxu::current_exception();
+                    {
+                        std::unique_lock<std::mutex> guard(lock);
+                        queue.clear();
+                        error = e;
+                        draining = false;
+                    }
+                    destination.on_error(e);
+                }
+            };
+
+            auto selectedDrain = on_exception(
+                [&](){return coordinator.act(drain);},
+                destination);
+            if (selectedDrain.empty()) {
+                queue.clear();
+                draining = false;
+                return;
+            }
+
+            auto processor = coordinator.get_worker();
+
+            RXCPP_UNWIND_AUTO([&](){guard.lock();});
+            guard.unlock();
+
+            processor.schedule(selectedDrain.get());
+        }
+    };
+
+    std::shared_ptr<dispatch_queue_state> state;
+
+public:
+    dispatch_queue(subscriber<T> d, coordinator_type coor, std::size_t capacity, overflow_policy::type policy, drain_budget budget)
+        : state(std::make_shared<dispatch_queue_state>(std::move(d), std::move(coor), capacity, policy, budget))
+    {
+    }
+
+    void on_next(T v) const {
+        state->push(std::move(v));
+    }
+    void on_error(rxu::error_ptr e) const {
+        state->finish(e);
+    }
+    void on_completed() const {
+        state->finish(rxu::error_ptr());
+    }
+
+    // the subscription to the subject is nested in the destination, so that the
+    // end of the subject does not end the destination before the queue is sent.
+    static subscriber<T> make(subscriber<T> d, const coordination_type& cn, std::size_t capacity, overflow_policy::type policy) {
+        auto coordinator = cn.create_coordinator(d.get_subscription());
+        composite_subscription inner;
+        d.add(inner);
+        return make_subscriber<T>(inner, make_observer<T>(this_type(std::move(d), std::move(coordinator), capacity, policy, get_drain_budget(cn)))).as_dynamic();
+    }
+};
+
+}
+
+/// a dispatch subject gives each subscriber a queue of at most capacity values that is sent on its own worker
+/// of the coordination. the producer only queues each value for each subscriber, so a slow subscriber does not
+/// delay the other subscribers or the producer. when a queue is full the overflow_policy decides which value is
+/// lost. on_completed and on_error are never dropped, they are sent after the queued values.
+template<class T, class Coordination>
+class dispatch
+{
+    typedef rxu::decay_t<Coordination> coordination_type;
+
+    subject<T> s;
+    coordination_type coordination;
+    std::size_t capacity;
+    overflow_policy::type policy;
+
+public:
+    dispatch(Coordination cn, std::size_t c, overflow_policy::type p, composite_subscription cs = composite_subscription())
+        : s(std::move(cs))
+        , coordination(std::move(cn))
+        , capacity(c)
+        , policy(p)
+    {
+    }
+
+    bool has_observers() const {
+        return s.has_observers();
+    }
+
+    subscriber<T> get_subscriber() const {
+        return s.get_subscriber();
+    }
+
+    observable<T> get_observable() const {
+        auto keepAlive = s;
+        auto cn = coordination;
+        auto c = capacity;
+        auto p = policy;
+        return make_observable_dynamic<T>([keepAlive, cn, c, p](subscriber<T> o){
+            keepAlive.get_observable().subscribe(detail::dispatch_queue<T, coordination_type>::make(std::move(o), cn, c, p));
+        });
+    }
+};
+
+}
+
+}
+
+#endif
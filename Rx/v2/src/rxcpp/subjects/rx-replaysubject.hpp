@@ -170,8 +170,9 @@ public:
     observable<T> get_observable() const {
         auto keepAlive = s;
         auto observable = make_observable_dynamic<T>([keepAlive, this](subscriber<T> o){
+            // the values are a copy, so they can be moved to the subscriber
             for (auto&& value: get_values()) {
-                o.on_next(value);
+                o.on_next(std::move(value));
             }
             keepAlive.add(keepAlive.get_subscriber(), std::move(o));
         });
@@ -46,6 +46,7 @@ class synchronize_observer : public detail::multicast_observer<T>
         mutable typename mode::type current;
         coordinator_type coordinator;
         output_type destination;
+        drain_budget budget;
 
         void ensure_processing(std::unique_lock<std::mutex>& guard) const {
             if (!guard.owns_lock()) {
@@ -57,22 +58,26 @@ class synchronize_observer : public detail::multicast_observer<T>
 
                 auto drain_queue = [keepAlive, this](const rxsc::schedulable& self){
                     RXCPP_TRY {
-                        std::unique_lock<std::mutex> guard(lock);
-                        if (!destination.is_subscribed()) {
-                            current = mode::Disposed;
-                            fill_queue.clear();
+                        auto meter = budget.start(self);
+                        for (;;) {
+                            std::unique_lock<std::mutex> guard(lock);
+                            if (!destination.is_subscribed()) {
+                                current = mode::Disposed;
+                                fill_queue.clear();
+                                guard.unlock();
+                                lifetime.unsubscribe();
+                                return;
+                            }
+                            if (fill_queue.empty()) {
+                                current = mode::Empty;
+                                return;
+                            }
+                            auto notification = std::move(fill_queue.front());
+                            fill_queue.pop_front();
                             guard.unlock();
-                            lifetime.unsubscribe();
-                            return;
-                        }
-                        if (fill_queue.empty()) {
-                            current = mode::Empty;
-                            return;
+                            notification->accept(destination);
+                            if (meter.spend(self)) break;
                         }
-                        auto notification = std::move(fill_queue.front());
-                        fill_queue.pop_front();
-                        guard.unlock();
-                        notification->accept(destination);
                         self();
                     } RXCPP_CATCH(...) {
                         destination.on_error(rxu::current_exception());
@@ -94,11 +99,12 @@ class synchronize_observer : public detail::multicast_observer<T>
             }
         }
 
-        synchronize_observer_state(coordinator_type coor, composite_subscription cs, output_type scbr)
+        synchronize_observer_state(coordinator_type coor, composite_subscription cs, output_type scbr, drain_budget b)
             : lifetime(std::move(cs))
             , current(mode::Empty)
             , coordinator(std::move(coor))
             , destination(std::move(scbr))
+            , budget(b)
         {
         }
 
@@ -140,7 +146,7 @@ public:
         // creates a worker whose lifetime is the same as the destination subscription
         auto coordinator = cn.create_coordinator(dl);
 
-        state = std::make_shared<synchronize_observer_state>(std::move(coordinator), std::move(il), std::move(o));
+        state = std::make_shared<synchronize_observer_state>(std::move(coordinator), std::move(il), std::move(o), get_drain_budget(cn));
     }
 
     subscriber<T> get_subscriber() const {
@@ -193,6 +199,7 @@ public:
 class synchronize_in_one_worker : public coordination_base
 {
     rxsc::scheduler factory;
+    drain_budget budget;
 
     class input_type
     {
@@ -235,6 +242,7 @@ class synchronize_in_one_worker : public coordination_base
 public:
 
     explicit synchronize_in_one_worker(rxsc::scheduler sc) : factory(sc) {}
+    synchronize_in_one_worker(rxsc::scheduler sc, drain_budget b) : factory(sc), budget(b) {}
 
     typedef coordinator<input_type> coordinator_type;
 
@@ -242,6 +250,14 @@ public:
         return factory.now();
     }
 
+    inline rxsc::scheduler get_scheduler() const {
+        return factory;
+    }
+
+    inline drain_budget get_drain_budget() const {
+        return budget;
+    }
+
     inline coordinator_type create_coordinator(composite_subscription cs = composite_subscription()) const {
         auto w = factory.create_worker(std::move(cs));
         return coordinator_type(input_type(std::move(w)));
@@ -0,0 +1,366 @@
+#include "../test.h"
+#include <rxcpp/operators/rx-concat_eager.hpp>
+#include <rxcpp/operators/rx-map.hpp>
+
+SCENARIO("concat_eager subscribes ahead and emits in order", "[concat_eager][join][operators]"){
+    GIVEN("1 hot observable with 3 cold observables of ints."){
+        auto sc = rxsc::make_test();
+        auto w = sc.create_worker();
+        const rxsc::test::messages<int> on;
+        const rxsc::test::messages<rx::observable<int>> o_on;
+
+        auto ys1 = sc.make_cold_observable({
+            on.next(10, 101),
+            on.next(20, 102),
+            on.next(110, 103),
+            on.next(120, 104),
+            on.next(210, 105),
+            on.next(220, 106),
+            on.completed(230)
+        });
+
+        auto ys2 = sc.make_cold_observable({
+            on.next(10, 201),
+            on.next(20, 202),
+            on.next(30, 203),
+            on.next(40, 204),
+            on.completed(50)
+        });
+
+        auto ys3 = sc.make_cold_observable({
+            on.next(10, 301),
+            on.next(20, 302),
+            on.next(30, 303),
+            on.next(40, 304),
+            on.next(120, 305),
+            on.completed(150)
+        });
+
+        auto xs = sc.make_hot_observable({
+            o_on.next(300, ys1),
+            o_on.next(400, ys2),
+            o_on.next(500, ys3),
+            o_on.completed(600)
+        });
+
+        WHEN("up to 3 are subscribed at once"){
+
+            auto res = w.start(
+                [&]() {
+                    return xs
+                        | rxo::concat_eager(3)
+                        // forget type to workaround lambda deduction bug on msvc 2013
+                        | rxo::as_dynamic();
+                }
+            );
+
+            THEN("the buffered ints are emitted when the previous observable completes"){
+                auto required = rxu::to_vector({
+                    on.next(310, 101),
+                    on.next(320, 102),
+                    on.next(410, 103),
+                    on.next(420, 104),
+                    on.next(510, 105),
+                    on.next(520, 106),
+                    on.next(530, 201),
+                    on.next(530, 202),
+                    on.next(530, 203),
+                    on.next(530, 204),
+                    on.next(530, 301),
+                    on.next(530, 302),
+                    on.next(530, 303),
+                    on.next(540, 304),
+                    on.next(620, 305),
+                    on.completed(650)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+
+            THEN("the xs subscriptions are as expected"){
+                auto required = rxu::to_vector({
+                    on.subscribe(200, 600)
+                });
+                auto actual = xs.subscriptions();
+                REQUIRE(required == actual);
+            }
+
+            THEN("the ys1 subscriptions are as expected"){
+                auto required = rxu::to_vector({
+                    on.subscribe(300, 530)
+                });
+                auto actual = ys1.subscriptions();
+                REQUIRE(required == actual);
+            }
+
+            THEN("the ys2 subscriptions are as expected"){
+                auto required = rxu::to_vector({
+                    on.subscribe(400, 450)
+                });
+                auto actual = ys2.subscriptions();
+                REQUIRE(required == actual);
+            }
+
+            THEN("the ys3 subscriptions are as expected"){
+                auto required = rxu::to_vector({
+                    on.subscribe(500, 650)
+                });
+                auto actual = ys3.subscriptions();
+                REQUIRE(required == actual);
+            }
+        }
+
+        WHEN("up to 2 are subscribed at once"){
+
+            auto res = w.start(
+                [&]() {
+                    return xs
+                        | rxo::concat_eager(2)
+                        // forget type to workaround lambda deduction bug on msvc 2013
+                        | rxo::as_dynamic();
+                }
+            );
+
+            THEN("the third observable is subscribed when the first completes"){
+                auto required = rxu::to_vector({
+                    on.next(310, 101),
+                    on.next(320, 102),
+                    on.next(410, 103),
+                    on.next(420, 104),
+                    on.next(510, 105),
+                    on.next(520, 106),
+                    on.next(530, 201),
+                    on.next(530, 202),
+                    on.next(530, 203),
+                    on.next(530, 204),
+                    on.next(540, 301),
+                    on.next(550, 302),
+                    on.next(560, 303),
+                    on.next(570, 304),
+                    on.next(650, 305),
+                    on.completed(680)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+
+            THEN("the ys2 subscriptions are as expected"){
+                auto required = rxu::to_vector({
+                    on.subscribe(400, 450)
+                });
+                auto actual = ys2.subscriptions();
+                REQUIRE(required == actual);
+            }
+
+            THEN("the ys3 subscriptions are as expected"){
+                auto required = rxu::to_vector({
+                    on.subscribe(530, 680)
+                });
+                auto actual = ys3.subscriptions();
+                REQUIRE(required == actual);
+            }
+        }
+    }
+}
+
+SCENARIO("concat_eager bounds the buffers of the observables that are subscribed ahead", "[concat_eager][join][operators]"){
+    GIVEN("1 hot observable with 3 cold observables of ints."){
+        auto sc = rxsc::make_test();
+        auto w = sc.create_worker();
+        const rxsc::test::messages<int> on;
+        const rxsc::test::messages<rx::observable<int>> o_on;
+
+        auto ys1 = sc.make_cold_observable({
+            on.next(10, 101),
+            on.next(20, 102),
+            on.next(110, 103),
+            on.next(120, 104),
+            on.next(210, 105),
+            on.next(220, 106),
+            on.completed(230)
+        });
+
+        auto ys2 = sc.make_cold_observable({
+            on.next(10, 201),
+            on.next(20, 202),
+            on.next(30, 203),
+            on.next(40, 204),
+            on.completed(50)
+        });
+
+        auto ys3 = sc.make_cold_observable({
+            on.next(10, 301),
+            on.next(20, 302),
+            on.completed(30)
+        });
+
+        auto xs = sc.make_hot_observable({
+            o_on.next(300, ys1),
+            o_on.next(400, ys2),
+            o_on.next(500, ys3),
+            o_on.completed(600)
+        });
+
+        WHEN("3 are subscribed at once and 2 ints fill a buffer"){
+
+            auto res = w.start(
+                [&]() {
+                    return xs
+                        | rxo::concat_eager(3, 2)
+                        // forget type to workaround lambda deduction bug on msvc 2013
+                        | rxo::as_dynamic();
+                }
+            );
+
+            THEN("every int is delivered in order"){
+                auto required = rxu::to_vector({
+                    on.next(310, 101),
+                    on.next(320, 102),
+                    on.next(410, 103),
+                    on.next(420, 104),
+                    on.next(510, 105),
+                    on.next(520, 106),
+                    on.next(540, 201),
+                    on.next(550, 202),
+                    on.next(560, 203),
+                    on.next(570, 204),
+                    on.next(580, 301),
+                    on.next(580, 302),
+                    on.completed(600)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+
+            THEN("ys2 is stopped when it overflows and subscribed again when it is reached"){
+                auto required = rxu::to_vector({
+                    on.subscribe(400, 430),
+                    on.subscribe(530, 580)
+                });
+                auto actual = ys2.subscriptions();
+                REQUIRE(required == actual);
+            }
+
+            THEN("ys3 is not subscribed ahead while ys2 is stopped"){
+                auto required = rxu::to_vector({
+                    on.subscribe(530, 560)
+                });
+                auto actual = ys3.subscriptions();
+                REQUIRE(required == actual);
+            }
+        }
+
+        WHEN("3 are subscribed at once and 4 ints fill a buffer"){
+
+            auto res = w.start(
+                [&]() {
+                    return xs
+                        | rxo::concat_eager(3, 4)
+                        // forget type to workaround lambda deduction bug on msvc 2013
+                        | rxo::as_dynamic();
+                }
+            );
+
+            THEN("the output is the same as concat"){
+                auto required = rxu::to_vector({
+                    on.next(310, 101),
+                    on.next(320, 102),
+                    on.next(410, 103),
+                    on.next(420, 104),
+                    on.next(510, 105),
+                    on.next(520, 106),
+                    on.next(530, 201),
+                    on.next(530, 202),
+                    on.next(530, 203),
+                    on.next(530, 204),
+                    on.next(540, 301),
+                    on.next(550, 302),
+                    on.completed(600)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+
+            THEN("ys3 is not subscribed ahead while the buffer of ys2 is full"){
+                auto required = rxu::to_vector({
+                    on.subscribe(530, 560)
+                });
+                auto actual = ys3.subscriptions();
+                REQUIRE(required == actual);
+            }
+        }
+    }
+}
+
+SCENARIO("concat_eager holds an error until it is reached", "[concat_eager][join][operators]"){
+    GIVEN("1 hot observable with 2 cold observables of ints."){
+        auto sc = rxsc::make_test();
+        auto w = sc.create_worker();
+        const rxsc::test::messages<int> on;
+        const rxsc::test::messages<rx::observable<int>> o_on;
+
+        std::runtime_error ex("concat_eager on_error from inner source");
+
+        auto ys1 = sc.make_cold_observable({
+            on.next(10, 101),
+            on.next(100, 102),
+            on.completed(200)
+        });
+
+        auto ys2 = sc.make_cold_observable({
+            on.next(10, 201),
+            on.error(20, ex)
+        });
+
+        auto xs = sc.make_hot_observable({
+            o_on.next(300, ys1),
+            o_on.next(310, ys2),
+            o_on.completed(320)
+        });
+
+        WHEN("both are subscribed at once"){
+
+            auto res = w.start(
+                [&]() {
+                    return xs
+                        | rxo::concat_eager(2)
+                        // forget type to workaround lambda deduction bug on msvc 2013
+                        | rxo::as_dynamic();
+                }
+            );
+
+            THEN("the error is sent after the ints of the first observable"){
+                auto required = rxu::to_vector({
+                    on.next(310, 101),
+                    on.next(400, 102),
+                    on.next(500, 201),
+                    on.error(500, ex)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+    }
+}
+
+SCENARIO("concat_eager delivers large synchronous observables by default", "[concat_eager][join][operators]"){
+    GIVEN("3 ranges of 5000 ints."){
+        WHEN("they are concatenated with the default max_buffered"){
+
+            std::vector<int> actual;
+            rxs::range(1, 3)
+                .map([](int){ return rxs::range(1, 5000); })
+                .concat_eager(2)
+                .as_blocking()
+                .subscribe([&](int v){ actual.push_back(v); });
+
+            THEN("all the ints are delivered in order"){
+                REQUIRE(15000u == actual.size());
+                REQUIRE(1 == actual[0]);
+                REQUIRE(5000 == actual[4999]);
+                REQUIRE(1 == actual[5000]);
+                REQUIRE(5000 == actual[14999]);
+            }
+        }
+    }
+}
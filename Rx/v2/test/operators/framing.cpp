@@ -0,0 +1,246 @@
+#include "../test.h"
+#include "rxcpp/operators/rx-framing.hpp"
+
+SCENARIO("split_on_delimiter - frames cut across chunks", "[split_on_delimiter][framing][operators]") {
+    GIVEN("a source of chunks") {
+        auto sc = rxsc::make_test();
+        auto w = sc.create_worker();
+        const rxsc::test::messages<std::string> on;
+
+        auto xs = sc.make_hot_observable({
+            on.next(150, std::string("ignored\r")),
+            on.next(210, std::string("ab\rc")),
+            on.next(220, std::string("de")),
+            on.next(230, std::string("f\r\rg\rh")),
+            on.next(240, std::string("ij")),
+            on.completed(250)
+        });
+
+        WHEN("split on \\r") {
+
+            auto res = w.start(
+                [xs]() {
+                    return xs
+                        | rxo::split_on_delimiter('\r')
+                        // forget type to workaround lambda deduction bug on msvc 2013
+                        | rxo::as_dynamic();
+                }
+            );
+
+            THEN("the output contains each frame and the trailing bytes when the source completes"){
+                auto required = rxu::to_vector({
+                    on.next(210, std::string("ab")),
+                    on.next(230, std::string("cdef")),
+                    on.next(230, std::string("")),
+                    on.next(230, std::string("g")),
+                    on.next(250, std::string("hij")),
+                    on.completed(250)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+
+            THEN("there was 1 subscription/unsubscription to the source"){
+                auto required = rxu::to_vector({
+                    on.subscribe(200, 250)
+                });
+                auto actual = xs.subscriptions();
+                REQUIRE(required == actual);
+            }
+        }
+    }
+}
+
+SCENARIO("split_lines - bytes", "[split_lines][framing][operators]") {
+    GIVEN("a source of byte vectors") {
+        auto sc = rxsc::make_test();
+        auto w = sc.create_worker();
+        typedef std::vector<uint8_t> bytes;
+        const rxsc::test::messages<bytes> in;
+        const rxsc::test::messages<std::string> out;
+
+        auto to_bytes = [](const char* s){
+            return bytes(s, s + std::strlen(s));
+        };
+
+        auto xs = sc.make_hot_observable({
+            in.next(210, to_bytes("one\r")),
+            in.next(220, to_bytes("\ntwo\nthree\r\n")),
+            in.next(230, to_bytes("four")),
+            in.completed(240)
+        });
+
+        WHEN("split into lines") {
+
+            auto res = w.start(
+                [xs]() {
+                    return xs
+                        .split_lines()
+                        // forget type to workaround lambda deduction bug on msvc 2013
+                        .as_dynamic();
+                }
+            );
+
+            THEN("the output contains each line without the line ending"){
+                auto required = rxu::to_vector({
+                    out.next(220, std::string("one")),
+                    out.next(220, std::string("two")),
+                    out.next(220, std::string("three")),
+                    out.next(240, std::string("four")),
+                    out.completed(240)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+    }
+}
+
+SCENARIO("length_prefixed_frames - frames cut across chunks", "[length_prefixed_frames][framing][operators]") {
+    GIVEN("a source of chunks") {
+        auto sc = rxsc::make_test();
+        auto w = sc.create_worker();
+        const rxsc::test::messages<std::string> on;
+
+        auto xs = sc.make_hot_observable({
+            on.next(210, std::string("\x00\x02" "ab" "\x00", 5)),
+            on.next(220, std::string("\x03" "c", 2)),
+            on.next(230, std::string("de" "\x00\x00" "\x00\x01" "f", 7)),
+            on.completed(240)
+        });
+
+        WHEN("split with a 2 byte prefix") {
+
+            auto res = w.start(
+                [xs]() {
+                    return xs
+                        | rxo::length_prefixed_frames(2)
+                        // forget type to workaround lambda deduction bug on msvc 2013
+                        | rxo::as_dynamic();
+                }
+            );
+
+            THEN("the output contains the payload of each frame"){
+                auto required = rxu::to_vector({
+                    on.next(210, std::string("ab")),
+                    on.next(230, std::string("cde")),
+                    on.next(230, std::string("")),
+                    on.next(230, std::string("f")),
+                    on.completed(240)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+    }
+}
+
+SCENARIO("length_prefixed_frames - source completes inside a frame", "[length_prefixed_frames][framing][operators]") {
+    GIVEN("a source that stops in the middle of a frame") {
+        auto sc = rxsc::make_test();
+        auto w = sc.create_worker();
+        const rxsc::test::messages<std::string> on;
+
+        std::runtime_error ex("length_prefixed_frames: the source completed in the middle of a frame");
+
+        auto xs = sc.make_hot_observable({
+            on.next(210, std::string("\x00\x00\x00\x01" "a" "\x00\x00\x00\x05" "bc", 11)),
+            on.completed(220)
+        });
+
+        WHEN("split with the default prefix") {
+
+            auto res = w.start(
+                [xs]() {
+                    return xs
+                        .length_prefixed_frames()
+                        // forget type to workaround lambda deduction bug on msvc 2013
+                        .as_dynamic();
+                }
+            );
+
+            THEN("the output contains the complete frames followed by an error"){
+                auto required = rxu::to_vector({
+                    on.next(210, std::string("a")),
+                    on.error(220, ex)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+    }
+}
+
+SCENARIO("length_prefixed_frames - a length longer than max_frame_length", "[length_prefixed_frames][framing][operators]") {
+    GIVEN("a source with a frame of 6 bytes followed by a corrupt prefix") {
+        auto sc = rxsc::make_test();
+        auto w = sc.create_worker();
+        const rxsc::test::messages<std::string> on;
+
+        std::length_error ex("length_prefixed_frames: the length of a frame is longer than max_frame_length");
+
+        auto xs = sc.make_hot_observable({
+            on.next(210, std::string("\x00\x02" "ab" "\x00\x06" "abc", 9)),
+            on.next(220, std::string("def" "\x00\x07" "abcdefg", 12)),
+            on.next(230, std::string("\x00\x01" "a", 3)),
+            on.completed(240)
+        });
+
+        WHEN("split with a max_frame_length of 6") {
+
+            auto res = w.start(
+                [xs]() {
+                    return xs
+                        | rxo::length_prefixed_frames(2, 6)
+                        // forget type to workaround lambda deduction bug on msvc 2013
+                        | rxo::as_dynamic();
+                }
+            );
+
+            THEN("the output contains the frames before the long one followed by an error"){
+                auto required = rxu::to_vector({
+                    on.next(210, std::string("ab")),
+                    on.next(220, std::string("abcdef")),
+                    on.error(220, ex)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+    }
+}
+
+SCENARIO("length_prefixed_frames - the largest length of a size_t prefix", "[length_prefixed_frames][framing][operators]") {
+    GIVEN("a source with a prefix that has every bit set") {
+        auto sc = rxsc::make_test();
+        auto w = sc.create_worker();
+        const rxsc::test::messages<std::string> on;
+
+        std::length_error ex("length_prefixed_frames: the length of a frame is longer than max_frame_length");
+
+        auto xs = sc.make_hot_observable({
+            on.next(210, std::string(sizeof(std::size_t), '\xff') + "abc"),
+            on.completed(220)
+        });
+
+        WHEN("split with a prefix of sizeof(std::size_t) and no limit") {
+
+            auto res = w.start(
+                [xs]() {
+                    return xs
+                        | rxo::length_prefixed_frames(sizeof(std::size_t), std::numeric_limits<std::size_t>::max())
+                        // forget type to workaround lambda deduction bug on msvc 2013
+                        | rxo::as_dynamic();
+                }
+            );
+
+            THEN("the length does not wrap and an error is sent"){
+                auto required = rxu::to_vector({
+                    on.error(210, ex)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+    }
+}
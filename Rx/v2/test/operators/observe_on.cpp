@@ -2,6 +2,8 @@
 #include <rxcpp/operators/rx-take.hpp>
 #include <rxcpp/operators/rx-map.hpp>
 #include <rxcpp/operators/rx-observe_on.hpp>
+#include <rxcpp/operators/rx-reduce.hpp>
+#include <rxcpp/operators/rx-tap.hpp>
 
 const int static_onnextcalls = 100000;
 
@@ -191,3 +193,401 @@ SCENARIO("observe_on no-comparison", "[observe][observe_on]"){
         }
     }
 }
+
+SCENARIO("priority_loop runs the most urgent due item", "[observe][observe_on][priority]"){
+    GIVEN("a priority_loop that is busy"){
+        rxsc::priority_loop loop(4);
+
+        std::mutex lock;
+        std::condition_variable wake;
+        bool started = false;
+        bool released = false;
+        std::vector<std::string> order;
+
+        auto high = loop.get_scheduler(rxsc::priority_level::high).create_worker();
+        auto background = loop.get_scheduler(rxsc::priority_level::background).create_worker();
+
+        high.schedule([&](const rxsc::schedulable&){
+            std::unique_lock<std::mutex> guard(lock);
+            started = true;
+            wake.notify_all();
+            wake.wait(guard, [&](){return released;});
+        });
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [&](){return started;});
+        }
+
+        WHEN("items from each level are waiting"){
+            auto record = [&](std::string name){
+                return [&, name](const rxsc::schedulable&){
+                    std::unique_lock<std::mutex> guard(lock);
+                    order.push_back(name);
+                    wake.notify_all();
+                };
+            };
+            for (int i = 0; i != 2; ++i) {
+                background.schedule(record("b"));
+            }
+            for (int i = 0; i != 10; ++i) {
+                high.schedule(record("h"));
+            }
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                released = true;
+                wake.notify_all();
+                wake.wait(guard, [&](){return order.size() == 12;});
+            }
+
+            THEN("the background level is run after it has been passed over four times"){
+                std::vector<std::string> required = {
+                    "h", "h", "h", "h", "b",
+                    "h", "h", "h", "h", "b",
+                    "h", "h"
+                };
+                REQUIRE(required == order);
+            }
+        }
+        high.unsubscribe();
+        background.unsubscribe();
+    }
+}
+
+SCENARIO("observe_on_priority", "[observe][observe_on][priority]"){
+    GIVEN("a range"){
+        WHEN("it is observed on the background level"){
+            std::thread::id caller = std::this_thread::get_id();
+            std::thread::id observer;
+            auto sum = rxs::range(1, 10)
+                | rxo::observe_on(rx::observe_on_priority(rxsc::priority_level::background))
+                | rxo::tap([&](int){ observer = std::this_thread::get_id(); })
+                | rxo::sum()
+                | rxo::as_blocking();
+
+            THEN("the values are observed on the loop"){
+                REQUIRE(55 == sum.last());
+                REQUIRE(caller != observer);
+            }
+        }
+    }
+}
+
+SCENARIO("deadline_loop runs the earliest deadline first", "[observe][observe_on][deadline]"){
+    GIVEN("a deadline_loop that is busy"){
+        std::mutex lock;
+        std::condition_variable wake;
+        bool started = false;
+        bool released = false;
+        std::vector<std::string> order;
+        std::vector<rxsc::deadline_miss> misses;
+
+        rxsc::deadline_loop loop([&](const rxsc::deadline_miss& m){
+            std::unique_lock<std::mutex> guard(lock);
+            misses.push_back(m);
+        });
+
+        auto relaxed = loop.get_scheduler(std::chrono::hours(1)).create_worker();
+        auto normal = loop.get_scheduler(std::chrono::minutes(1)).create_worker();
+        auto urgent = loop.get_scheduler(std::chrono::milliseconds(1)).create_worker();
+
+        relaxed.schedule([&](const rxsc::schedulable&){
+            std::unique_lock<std::mutex> guard(lock);
+            started = true;
+            wake.notify_all();
+            wake.wait(guard, [&](){return released;});
+        });
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [&](){return started;});
+        }
+
+        WHEN("items with different budgets are waiting"){
+            auto record = [&](std::string name){
+                return [&, name](const rxsc::schedulable&){
+                    std::unique_lock<std::mutex> guard(lock);
+                    order.push_back(name);
+                    wake.notify_all();
+                };
+            };
+            relaxed.schedule(record("relaxed"));
+            normal.schedule(record("normal"));
+            urgent.schedule(record("urgent"));
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                released = true;
+                wake.notify_all();
+                wake.wait(guard, [&](){return order.size() == 3;});
+            }
+
+            THEN("the items are run in order of deadline"){
+                std::vector<std::string> required = {"urgent", "normal", "relaxed"};
+                REQUIRE(required == order);
+            }
+
+            THEN("the urgent item missed its deadline"){
+                std::unique_lock<std::mutex> guard(lock);
+                REQUIRE(1 == loop.missed());
+                REQUIRE(1 == misses.size());
+                REQUIRE(misses.front().lateness() >= std::chrono::milliseconds(19));
+            }
+        }
+        relaxed.unsubscribe();
+        normal.unsubscribe();
+        urgent.unsubscribe();
+    }
+}
+
+SCENARIO("deadline_loop releases cancelled timers", "[observe][observe_on][deadline]"){
+    GIVEN("a deadline_loop with many timers that are cancelled"){
+        rxsc::deadline_loop loop;
+        auto w = loop.get_scheduler(std::chrono::milliseconds(1)).create_worker();
+        auto token = std::make_shared<int>(0);
+        auto later = w.now() + std::chrono::hours(1);
+
+        std::vector<rx::composite_subscription> timers;
+        for (int i = 0; i != 1000; ++i) {
+            rx::composite_subscription cs;
+            timers.push_back(cs);
+            w.schedule(later, rxsc::make_schedulable(w, cs, [token](const rxsc::schedulable&){}));
+        }
+        for (auto& cs : timers) {
+            cs.unsubscribe();
+        }
+
+        WHEN("more timers are scheduled"){
+            for (int i = 0; i != 100; ++i) {
+                w.schedule(later, [](const rxsc::schedulable&){});
+            }
+
+            THEN("the cancelled timers are released"){
+                REQUIRE(1 == token.use_count());
+            }
+        }
+        w.unsubscribe();
+    }
+}
+
+SCENARIO("observe_on_deadline", "[observe][observe_on][deadline]"){
+    GIVEN("a range"){
+        WHEN("it is observed on a deadline_loop"){
+            rxsc::deadline_loop loop;
+            auto sum = rxs::range(1, 10)
+                | rxo::observe_on(rx::observe_on_deadline(loop, std::chrono::milliseconds(100)))
+                | rxo::sum()
+                | rxo::as_blocking();
+
+            THEN("the values are observed"){
+                REQUIRE(55 == sum.last());
+            }
+        }
+    }
+}
+
+SCENARIO("observe_on with a drain budget", "[observe][observe_on][drain_budget]"){
+    GIVEN("a source that sends a burst"){
+        auto sc = rxsc::make_test();
+        auto w = sc.create_worker();
+        const rxsc::test::messages<int> on;
+
+        auto xs = sc.make_hot_observable({
+            on.next(210, 1),
+            on.next(210, 2),
+            on.next(210, 3),
+            on.next(210, 4),
+            on.next(210, 5),
+            on.completed(300)
+        });
+
+        WHEN("each drain action may deliver 3 items"){
+            auto so = rx::observe_on_one_worker(sc, rx::drain_budget(3));
+
+            auto res = w.start(
+                [so, xs]() {
+                    return xs
+                         | rxo::observe_on(so);
+                }
+            );
+
+            THEN("the drain yields the worker after every 3 items"){
+                auto required = rxu::to_vector({
+                    on.next(211, 1),
+                    on.next(211, 2),
+                    on.next(211, 3),
+                    on.next(212, 4),
+                    on.next(212, 5),
+                    on.completed(301)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+
+        WHEN("the default budget is used"){
+            auto so = rx::observe_on_one_worker(sc);
+
+            auto res = w.start(
+                [so, xs]() {
+                    return xs
+                         | rxo::observe_on(so);
+                }
+            );
+
+            THEN("the drain yields the worker after every item"){
+                auto required = rxu::to_vector({
+                    on.next(211, 1),
+                    on.next(212, 2),
+                    on.next(213, 3),
+                    on.next(214, 4),
+                    on.next(215, 5),
+                    on.completed(301)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+
+        WHEN("published on a synchronize coordination that may deliver 2 items"){
+            auto so = rx::synchronize_in_one_worker(sc, rx::drain_budget(2));
+
+            auto res = w.start(
+                [so, xs]() {
+                    return xs
+                         .publish_synchronized(so)
+                         .ref_count();
+                }
+            );
+
+            THEN("the drain yields the worker after every 2 items"){
+                auto required = rxu::to_vector({
+                    on.next(211, 1),
+                    on.next(211, 2),
+                    on.next(212, 3),
+                    on.next(212, 4),
+                    on.next(213, 5),
+                    on.completed(301)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+    }
+}
+
+SCENARIO("wait_policy", "[observe][observe_on][wait_policy]"){
+    GIVEN("a condition"){
+        std::mutex lock;
+        std::condition_variable wake;
+        rxsc::wait_signal signal;
+        bool ready = false;
+        int checks = 0;
+        auto pred = [&](){++checks; return ready;};
+
+        // sets ready after a delay. the condition_variable is only notified when notify is true
+        auto make_ready = [&](int delay, bool notify){
+            return std::thread([&, delay, notify](){
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+                std::unique_lock<std::mutex> guard(lock);
+                ready = true;
+                signal.notify();
+                if (notify) {
+                    wake.notify_one();
+                }
+            });
+        };
+
+        WHEN("the condition is met while spinning"){
+            // enough spins to outlast the delay
+            rxsc::wait_policy policy(std::size_t(1) << 40, 0);
+            auto t = make_ready(10, false);
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                policy.wait(guard, wake, signal, pred);
+            }
+            t.join();
+
+            THEN("the wait is counted as spun and the condition is only tested when signaled"){
+                auto counters = policy.counters();
+                REQUIRE(1 == counters.spun);
+                REQUIRE(0 == counters.yielded);
+                REQUIRE(0 == counters.parked);
+                REQUIRE(2 == checks);
+            }
+        }
+
+        WHEN("the condition is met while yielding"){
+            rxsc::wait_policy policy(0, std::size_t(1) << 40);
+            auto t = make_ready(10, false);
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                policy.wait(guard, wake, signal, pred);
+            }
+            t.join();
+
+            THEN("the wait is counted as yielded"){
+                auto counters = policy.counters();
+                REQUIRE(0 == counters.spun);
+                REQUIRE(1 == counters.yielded);
+                REQUIRE(0 == counters.parked);
+                REQUIRE(2 == checks);
+            }
+        }
+
+        WHEN("the condition is met after blocking"){
+            rxsc::wait_policy policy(32, 2);
+            auto t = make_ready(50, true);
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                policy.wait(guard, wake, signal, pred);
+            }
+            t.join();
+
+            THEN("the wait is counted as parked and the spins are halved"){
+                auto counters = policy.counters();
+                REQUIRE(0 == counters.spun);
+                REQUIRE(0 == counters.yielded);
+                REQUIRE(1 == counters.parked);
+                REQUIRE(16 == policy.spin_limit());
+            }
+        }
+
+        WHEN("a worker policy waits"){
+            rxsc::wait_policy policy(32, 2);
+            auto t = make_ready(50, true);
+            {
+                auto worker_policy = policy.for_worker();
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    worker_policy.wait(guard, wake, signal, pred);
+                }
+                t.join();
+
+                THEN("only the spin limit of the worker policy is changed"){
+                    REQUIRE(16 == worker_policy.spin_limit());
+                    REQUIRE(32 == policy.spin_limit());
+                }
+            }
+
+            THEN("the wait is included in the counters of the policy after the worker policy is released"){
+                auto counters = policy.counters();
+                REQUIRE(0 == counters.spun);
+                REQUIRE(0 == counters.yielded);
+                REQUIRE(1 == counters.parked);
+            }
+        }
+    }
+    GIVEN("a range observed on a new_thread with an adaptive wait policy"){
+        auto policy = rxsc::wait_policy::adaptive();
+        auto sc = rxsc::make_new_thread(policy);
+
+        WHEN("the sum is waited for with the policy"){
+            auto sum = rxs::range(1, 100)
+                | rxo::observe_on(rx::observe_on_one_worker(sc))
+                | rxo::as_blocking(policy);
+
+            THEN("the values are delivered"){
+                REQUIRE(5050 == sum.sum());
+            }
+        }
+    }
+}
@@ -4,6 +4,7 @@
 #include <rxcpp/operators/rx-ref_count.hpp>
 #include <rxcpp/operators/rx-map.hpp>
 #include <rxcpp/operators/rx-merge.hpp>
+#include <rxcpp/operators/rx-observe_on.hpp>
 
 
 SCENARIO("publish range", "[!hide][range][subject][publish][subject][operators]"){
@@ -528,3 +529,123 @@ SCENARIO("publish basic with initial value", "[publish][multicast][behavior][ope
         }
     }
 }
+
+SCENARIO("publish_on overflow policies", "[publish][publish_on][multicast][operators]"){
+    GIVEN("a source that sends a burst"){
+        auto sc = rxsc::make_test();
+        auto so = rx::observe_on_one_worker(sc);
+        auto w = sc.create_worker();
+        const rxsc::test::messages<int> on;
+
+        auto xs = sc.make_hot_observable({
+            on.next(210, 1),
+            on.next(210, 2),
+            on.next(210, 3),
+            on.next(210, 4),
+            on.next(210, 5),
+            on.completed(300)
+        });
+
+        WHEN("each subscriber queue holds 2 values and drops the newest"){
+            auto res = w.start(
+                [&]() {
+                    return xs
+                        .publish_on(so, 2, rxsub::overflow_policy::drop_newest)
+                        .ref_count();
+                }
+            );
+
+            THEN("the first values are sent"){
+                auto required = rxu::to_vector({
+                    on.next(211, 1),
+                    on.next(212, 2),
+                    on.completed(301)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+
+        WHEN("each subscriber queue holds 2 values and drops the oldest"){
+            auto res = w.start(
+                [&]() {
+                    return xs
+                        .publish_on(so, 2, rxsub::overflow_policy::drop_oldest)
+                        .ref_count();
+                }
+            );
+
+            THEN("the last values are sent"){
+                auto required = rxu::to_vector({
+                    on.next(211, 4),
+                    on.next(212, 5),
+                    on.completed(301)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+
+        WHEN("each subscriber queue holds 2 values and conflates"){
+            auto res = w.start(
+                [&]() {
+                    return xs
+                        .publish_on(so, 2, rxsub::overflow_policy::conflate)
+                        .ref_count();
+                }
+            );
+
+            THEN("the first value and the latest value are sent"){
+                auto required = rxu::to_vector({
+                    on.next(211, 1),
+                    on.next(212, 5),
+                    on.completed(301)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+    }
+}
+
+SCENARIO("publish_on isolates a slow subscriber", "[publish][publish_on][multicast][operators]"){
+    GIVEN("a published range"){
+        WHEN("one subscriber blocks until the other has received every value"){
+            std::mutex lock;
+            std::condition_variable wake;
+            bool released = false;
+            bool finished = false;
+            int fast = 0;
+
+            auto published = rxs::range(1, 100)
+                .publish_on(rx::observe_on_new_thread(), 100, rxsub::overflow_policy::drop_newest);
+
+            published.subscribe(
+                [&](int){
+                    std::unique_lock<std::mutex> guard(lock);
+                    wake.wait(guard, [&](){return released;});
+                });
+            published.subscribe(
+                [&](int){
+                    std::unique_lock<std::mutex> guard(lock);
+                    ++fast;
+                },
+                [&](){
+                    std::unique_lock<std::mutex> guard(lock);
+                    finished = true;
+                    wake.notify_all();
+                });
+
+            published.connect();
+
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [&](){return finished;});
+            released = true;
+            wake.notify_all();
+
+            THEN("the fast subscriber received every value"){
+                REQUIRE(100 == fast);
+            }
+        }
+    }
+}
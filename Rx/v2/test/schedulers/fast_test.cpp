@@ -0,0 +1,97 @@
+#include "../test.h"
+#include <rxcpp/operators/rx-delay.hpp>
+#include <rxcpp/operators/rx-filter.hpp>
+#include <rxcpp/operators/rx-map.hpp>
+
+SCENARIO("fast_test sends timed values through time based operators", "[schedulers][fast_test]"){
+    GIVEN("a timed source"){
+        auto sc = rxsc::make_fast_test();
+        auto so = rx::identity_one_worker(sc);
+        std::vector<std::pair<long, int>> timeline;
+        timeline.push_back(std::make_pair(10L, 1));
+        timeline.push_back(std::make_pair(20L, 2));
+        timeline.push_back(std::make_pair(20L, 3));
+        timeline.push_back(std::make_pair(40L, 4));
+
+        auto summary = std::make_shared<rxsc::notification_summary>();
+        sc.make_timed_source<int>(timeline.begin(), timeline.end())
+            .delay(std::chrono::milliseconds(5), so)
+            .subscribe(sc.make_summary_subscriber<int>(summary));
+
+        WHEN("advanced to the middle"){
+            sc.advance_to(25);
+
+            THEN("the values that are due were received"){
+                REQUIRE(3 == summary->next_count);
+                REQUIRE(15 == summary->first_next);
+                REQUIRE(25 == summary->last_next);
+                REQUIRE(0 == summary->completed_count);
+                REQUIRE(25 == sc.clock());
+            }
+
+            // the rest are sent when the schedule is drained
+            sc.start();
+            REQUIRE(4 == summary->next_count);
+            REQUIRE(45 == summary->terminated);
+        }
+
+        WHEN("run to the end"){
+            sc.start();
+
+            THEN("the summary matches the values and times"){
+                rxsc::notification_summary required;
+                required.next_count = 4;
+                required.completed_count = 1;
+                required.first_next = 15;
+                required.last_next = 45;
+                required.terminated = 45;
+                for (auto& m : timeline) {
+                    required.combine(std::hash<long>()(m.first + 5));
+                    required.combine(std::hash<int>()(m.second));
+                }
+                REQUIRE(required == *summary);
+            }
+            THEN("the queue is empty"){
+                REQUIRE(0 == sc.pending());
+            }
+        }
+    }
+}
+
+SCENARIO("fast_test replays a large schedule", "[schedulers][fast_test]"){
+    GIVEN("a million timed values"){
+        const long count = 1000000;
+        std::vector<std::pair<long, long>> timeline;
+        timeline.reserve(count);
+        for (long i = 0; i != count; ++i) {
+            // ten values each millisecond
+            timeline.push_back(std::make_pair(i / 10, i));
+        }
+
+        auto run = [&](){
+            auto sc = rxsc::make_fast_test();
+            auto summary = std::make_shared<rxsc::notification_summary>();
+            sc.make_timed_source<long>(timeline.begin(), timeline.end())
+                .filter([](long v){ return v % 3 != 0; })
+                .map([](long v){ return v * 2; })
+                .subscribe(sc.make_summary_subscriber<long>(summary));
+            sc.start();
+            REQUIRE(sc.executed() <= std::size_t(count / 10 + 1));
+            return *summary;
+        };
+
+        WHEN("replayed twice"){
+            auto first = run();
+            auto second = run();
+
+            THEN("every value was sent"){
+                REQUIRE(std::size_t(count - (count + 2) / 3) == first.next_count);
+                REQUIRE(1 == first.completed_count);
+                REQUIRE((count - 1) / 10 == first.terminated);
+            }
+            THEN("the summaries are equal"){
+                REQUIRE(first == second);
+            }
+        }
+    }
+}
@@ -0,0 +1,133 @@
+#include "../test.h"
+
+SCENARIO("schedulable_queue removes cancelled items", "[schedulers][schedulable_queue]"){
+    GIVEN("a queue of timed items"){
+        typedef rxsc::detail::schedulable_queue<rxsc::scheduler::clock_type::time_point> queue_type;
+        queue_type q;
+        auto w = rxsc::make_current_thread().create_worker();
+        auto now = w.now();
+        int runs = 0;
+
+        WHEN("most of the items are unsubscribed before they are due"){
+            std::vector<rx::composite_subscription> kept;
+            for (int i = 0; i != 10000; ++i) {
+                rx::composite_subscription cs;
+                q.push(queue_type::item_type(now + std::chrono::hours(1 + i), rxsc::make_schedulable(w, cs, [&](const rxsc::schedulable&){++runs;})));
+                if (i % 100 == 0) {
+                    kept.push_back(cs);
+                } else {
+                    cs.unsubscribe();
+                }
+            }
+
+            THEN("the queue size tracks the items that are still subscribed"){
+                REQUIRE(q.size() < 2 * kept.size() + queue_type::compact_minimum);
+            }
+
+            THEN("the remaining items are in order"){
+                q.compact();
+                REQUIRE(kept.size() == q.size());
+                auto last = now;
+                while (!q.empty()) {
+                    REQUIRE(last < q.top().when);
+                    REQUIRE(q.top().what.is_subscribed());
+                    last = q.top().when;
+                    q.pop();
+                }
+            }
+        }
+
+        WHEN("a burst of timers is cancelled and no more items are pushed"){
+            int notified = 0;
+            q.set_notify_cancelled([&](){++notified;});
+            std::vector<rx::composite_subscription> all;
+            for (int i = 0; i != 10000; ++i) {
+                rx::composite_subscription cs;
+                q.push_timer(queue_type::item_type(now + std::chrono::hours(1 + i), rxsc::make_schedulable(w, cs, [&](const rxsc::schedulable&){++runs;})));
+                all.push_back(cs);
+            }
+            auto full = q.capacity();
+            for (std::size_t i = 1; i < all.size(); ++i) {
+                all[i].unsubscribe();
+            }
+
+            THEN("the owner is notified once and compact_cancelled releases the storage"){
+                REQUIRE(1 == notified);
+                q.compact_cancelled();
+                REQUIRE(1 == q.size());
+                REQUIRE(q.capacity() < full);
+                REQUIRE(q.capacity() <= 2 * queue_type::compact_minimum);
+            }
+        }
+
+        WHEN("most of the items are popped"){
+            for (int i = 0; i != 10000; ++i) {
+                q.push(queue_type::item_type(now + std::chrono::hours(1 + i), rxsc::make_schedulable(w, [&](const rxsc::schedulable&){++runs;})));
+            }
+            auto full = q.capacity();
+            while (q.size() > 10) {
+                q.pop();
+            }
+
+            THEN("the storage is released"){
+                REQUIRE(q.capacity() < full / 4);
+                REQUIRE(q.capacity() <= 4 * queue_type::compact_minimum);
+            }
+        }
+
+        WHEN("items with the same time are compacted"){
+            std::vector<int> order;
+            for (int i = 0; i != 200; ++i) {
+                rx::composite_subscription cs;
+                q.push(queue_type::item_type(now, rxsc::make_schedulable(w, cs, [&order, i](const rxsc::schedulable&){order.push_back(i);})));
+                if (i % 2) {
+                    cs.unsubscribe();
+                }
+            }
+            q.compact();
+
+            THEN("the remaining items keep the order they were pushed in"){
+                while (!q.empty()) {
+                    auto what = q.top().what;
+                    q.pop();
+                    what(rxsc::recursion(false).get_recurse());
+                }
+                REQUIRE(100 == order.size());
+                for (std::size_t i = 0; i != order.size(); ++i) {
+                    REQUIRE(static_cast<int>(i * 2) == order[i]);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("new_thread removes a burst of cancelled timers", "[schedulers][schedulable_queue]"){
+    GIVEN("a new_thread worker with many timers"){
+        typedef rxsc::detail::schedulable_queue<rxsc::scheduler::clock_type::time_point> queue_type;
+        auto w = rxsc::make_new_thread().create_worker();
+        auto token = std::make_shared<int>(0);
+        std::vector<rx::composite_subscription> all;
+        for (int i = 0; i != 1000; ++i) {
+            rx::composite_subscription cs;
+            w.schedule(w.now() + std::chrono::hours(1 + i), rxsc::make_schedulable(w, cs, [token](const rxsc::schedulable&){}));
+            all.push_back(cs);
+        }
+
+        WHEN("all but one of the timers are cancelled and nothing else is scheduled"){
+            for (std::size_t i = 1; i < all.size(); ++i) {
+                all[i].unsubscribe();
+            }
+
+            THEN("the thread releases all but a few of the cancelled timers"){
+                // fewer cancelled timers than the smallest compaction may stay queued
+                long most = 2 + queue_type::compact_minimum;
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+                while (token.use_count() > most && std::chrono::steady_clock::now() < deadline) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                REQUIRE(token.use_count() <= most);
+            }
+            w.unsubscribe();
+        }
+    }
+}
@@ -0,0 +1,120 @@
+#include "../test.h"
+#include <rxcpp/operators/rx-delay.hpp>
+#include <rxcpp/operators/rx-merge.hpp>
+#include <rxcpp/operators/rx-observe_on.hpp>
+
+SCENARIO("simulation interleaves virtual threads by seed", "[schedulers][simulation]"){
+    GIVEN("two workers on different virtual threads"){
+        // each worker records its items in order
+        auto run = [](unsigned long seed){
+            auto sc = rxsc::make_simulation(2, seed);
+            std::vector<int> order;
+            auto a = sc.create_worker();
+            auto b = sc.create_worker();
+            for (int i = 0; i < 4; ++i) {
+                a.schedule([&order, i](const rxsc::schedulable&){ order.push_back(i); });
+                b.schedule([&order, i](const rxsc::schedulable&){ order.push_back(10 + i); });
+            }
+            sc.start();
+            return order;
+        };
+
+        WHEN("run with many seeds"){
+            std::set<std::vector<int>> interleavings;
+            bool in_order = true;
+            for (unsigned long seed = 0; seed != 64; ++seed) {
+                auto order = run(seed);
+                interleavings.insert(order);
+                std::vector<int> first, second;
+                for (auto v : order) {
+                    (v < 10 ? first : second).push_back(v);
+                }
+                in_order = in_order && first == std::vector<int>({0, 1, 2, 3}) && second == std::vector<int>({10, 11, 12, 13});
+            }
+
+            THEN("the items of each worker ran in order"){
+                REQUIRE(in_order);
+            }
+            THEN("the seeds chose different interleavings"){
+                REQUIRE(interleavings.size() > 1);
+            }
+            THEN("a seed always chooses the same interleaving"){
+                REQUIRE(run(7) == run(7));
+            }
+        }
+    }
+}
+
+SCENARIO("simulation explores observe_on and merge", "[schedulers][simulation]"){
+    GIVEN("two sources observed on virtual threads and merged"){
+        auto run = [](unsigned long seed, long& clock){
+            auto sc = rxsc::make_simulation(4, seed);
+            auto so = rx::observe_on_one_worker(sc);
+            std::vector<int> received;
+            int completed = 0;
+            rx::observable<>::range(1, 5, so)
+                .merge(so, rx::observable<>::range(11, 15, so))
+                .delay(std::chrono::milliseconds(100), so)
+                .subscribe(
+                    [&](int v){ received.push_back(v); },
+                    [&](){ ++completed; });
+            sc.start();
+            clock = sc.clock();
+            REQUIRE(1 == completed);
+            REQUIRE(0 == sc.pending());
+            return received;
+        };
+
+        WHEN("run with many seeds"){
+            std::set<std::vector<int>> interleavings;
+            bool complete = true;
+            long last = 0;
+            for (unsigned long seed = 0; seed != 32; ++seed) {
+                auto received = run(seed, last);
+                interleavings.insert(received);
+                std::vector<int> first, second;
+                for (auto v : received) {
+                    (v < 10 ? first : second).push_back(v);
+                }
+                complete = complete && first == std::vector<int>({1, 2, 3, 4, 5}) && second == std::vector<int>({11, 12, 13, 14, 15});
+            }
+
+            THEN("every value was received once and in order for each source"){
+                REQUIRE(complete);
+            }
+            THEN("more than one interleaving was explored"){
+                REQUIRE(interleavings.size() > 1);
+            }
+            THEN("the delay took virtual time"){
+                REQUIRE(100 == last);
+            }
+        }
+    }
+}
+
+SCENARIO("simulation drops cancelled items", "[schedulers][simulation]"){
+    GIVEN("a worker with many cancelled timers and one live item"){
+        auto sc = rxsc::make_simulation(2, 0);
+        auto w = sc.create_worker();
+        int ran = 0;
+        for (int i = 0; i < 200; ++i) {
+            rx::composite_subscription cs;
+            w.schedule(sc.now() + std::chrono::seconds(1), rxsc::make_schedulable(w, cs, [&](const rxsc::schedulable&){ ++ran; }));
+            cs.unsubscribe();
+        }
+        w.schedule([&](const rxsc::schedulable&){ ++ran; });
+
+        WHEN("the simulation runs"){
+            auto queued = sc.pending();
+            sc.start();
+
+            THEN("the cancelled timers were compacted out of the queue"){
+                REQUIRE(queued < 64u);
+            }
+            THEN("only the live item ran and was counted"){
+                REQUIRE(1 == ran);
+                REQUIRE(1u == sc.executed());
+            }
+        }
+    }
+}
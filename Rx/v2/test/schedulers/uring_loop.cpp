@@ -0,0 +1,120 @@
+#include "../test.h"
+#include <rxcpp/operators/rx-reduce.hpp>
+#include <rxcpp/operators/rx-take.hpp>
+#include <rxcpp/operators/rx-observe_on.hpp>
+#include <rxcpp/operators/rx-merge.hpp>
+
+#if defined(__linux__)
+
+#include <rxcpp/schedulers/rx-uringloop.hpp>
+
+#include <fcntl.h>
+#include <cstdio>
+
+SCENARIO("uring_loop", "[observe][observe_on][uring]"){
+    GIVEN("a uring_loop"){
+        std::unique_ptr<rxsc::uring_loop> loop;
+        RXCPP_TRY {
+            loop.reset(new rxsc::uring_loop());
+        } RXCPP_CATCH(const std::system_error& e) {
+            WARN("io_uring is not available: " << e.what());
+            return;
+        }
+        auto so = rx::observe_on_one_worker(loop->get_scheduler());
+
+        WHEN("an interval is observed on the loop"){
+            auto start = std::chrono::steady_clock::now();
+            auto sum = rxs::interval(std::chrono::milliseconds(2), so)
+                | rxo::take(5)
+                | rxo::sum()
+                | rxo::as_blocking();
+
+            THEN("the values are sent after the timeouts"){
+                REQUIRE(15 == sum.last());
+                REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(8));
+            }
+        }
+
+        WHEN("a file is read on the loop"){
+            char path[] = "/tmp/rxcpp_uring_XXXXXX";
+            int fd = ::mkstemp(path);
+            REQUIRE(fd >= 0);
+            std::string text = "hello uring";
+            REQUIRE(static_cast<ssize_t>(text.size()) == ::write(fd, text.data(), text.size()));
+
+            auto bytes = loop->read(fd, 6, 100).as_blocking().first();
+            ::close(fd);
+            ::unlink(path);
+
+            THEN("the bytes at the offset are sent"){
+                REQUIRE(std::string("uring") == bytes);
+            }
+        }
+
+        WHEN("the subscriber of a read on a pipe unsubscribes before the data arrives"){
+            int fds[2];
+            REQUIRE(0 == ::pipe(fds));
+            bool sent = false;
+            auto first = loop->read(fds[0], 0, 100).subscribe([&](const std::string&){ sent = true; });
+            // the read must be in flight before it is cancelled
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            first.unsubscribe();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            REQUIRE(5 == ::write(fds[1], "hello", 5));
+
+            auto bytes = loop->read(fds[0], 0, 100).as_blocking().first();
+            ::close(fds[0]);
+            ::close(fds[1]);
+
+            THEN("the read is cancelled and the data is left for the next read"){
+                REQUIRE(!sent);
+                REQUIRE(std::string("hello") == bytes);
+            }
+        }
+
+        WHEN("a read fails"){
+            THEN("the error is sent to on_error"){
+                REQUIRE_THROWS(loop->read(-1, 0, 100).as_blocking().first());
+            }
+        }
+    }
+}
+
+SCENARIO("uring_loop with a small ring", "[observe][observe_on][uring]"){
+    GIVEN("a uring_loop with 2 entries"){
+        std::unique_ptr<rxsc::uring_loop> loop;
+        RXCPP_TRY {
+            loop.reset(new rxsc::uring_loop(2));
+        } RXCPP_CATCH(const std::system_error& e) {
+            WARN("io_uring is not available: " << e.what());
+            return;
+        }
+
+        WHEN("more reads than entries are submitted together"){
+            char path[] = "/tmp/rxcpp_uring_XXXXXX";
+            int fd = ::mkstemp(path);
+            REQUIRE(fd >= 0);
+            std::string text = "0123456789";
+            REQUIRE(static_cast<ssize_t>(text.size()) == ::write(fd, text.data(), text.size()));
+
+            std::vector<rx::observable<std::string>> reads;
+            for (std::uint64_t i = 0; i != text.size(); ++i) {
+                reads.push_back(loop->read(fd, i, 1));
+            }
+            auto bytes = rx::observable<>::iterate(reads)
+                | rxo::merge()
+                | rxo::reduce(std::string(), [](std::string all, const std::string& b){ return all + b; })
+                | rxo::as_blocking();
+            auto all = bytes.last();
+            std::sort(all.begin(), all.end());
+            ::close(fd);
+            ::unlink(path);
+
+            THEN("every read completes"){
+                REQUIRE(text == all);
+            }
+        }
+    }
+}
+
+#endif
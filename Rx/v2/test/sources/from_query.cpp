@@ -0,0 +1,219 @@
+#include "../test.h"
+#include <rxcpp/operators/rx-take.hpp>
+#include <rxcpp/operators/rx-concat.hpp>
+#include <rxcpp/operators/rx-reduce.hpp>
+#include <rxcpp/operators/rx-observe_on.hpp>
+#include <rxcpp/operators/rx-subscribe_on.hpp>
+
+namespace {
+
+// the minimal query shape used by from_query: get_cursor() returns a cursor with empty/inc/get
+struct counted_query
+{
+    struct cursor
+    {
+        const std::vector<int>* values;
+        std::size_t at;
+        int* reads;
+
+        bool empty() const { return at == values->size(); }
+        void inc() { ++at; }
+        int get() const { ++*reads; return (*values)[at]; }
+    };
+
+    std::vector<int> values;
+    std::shared_ptr<int> reads;
+
+    explicit counted_query(int n) : reads(std::make_shared<int>(0)) {
+        for (int i = 0; i < n; ++i) {
+            values.push_back(i);
+        }
+    }
+
+    cursor get_cursor() const {
+        cursor c = {&values, 0, reads.get()};
+        return c;
+    }
+};
+
+struct throwing_query
+{
+    struct cursor
+    {
+        int at;
+        bool empty() const { return false; }
+        void inc() { ++at; }
+        int get() const {
+            if (at == 2) {
+                rxu::throw_exception(std::runtime_error("query failed"));
+            }
+            return at;
+        }
+    };
+
+    cursor get_cursor() const {
+        cursor c = {0};
+        return c;
+    }
+};
+
+}
+
+SCENARIO("from_query sends each value of the query", "[from_query][sources]"){
+    GIVEN("a query of 200 ints"){
+        counted_query q(200);
+
+        WHEN("the values are collected"){
+            std::vector<int> actual;
+            bool completed = false;
+            rx::observable<>::from_query(q, 16).subscribe(
+                [&](int v){ actual.push_back(v); },
+                [&](){ completed = true; });
+
+            THEN("every value is sent in order"){
+                REQUIRE(q.values == actual);
+            }
+            THEN("the observable completes"){
+                REQUIRE(completed);
+            }
+            THEN("each value is read once"){
+                REQUIRE(200 == *q.reads);
+            }
+        }
+
+        WHEN("the subscriber unsubscribes after 5 values"){
+            std::vector<int> actual;
+            rx::observable<>::from_query(q, 16).take(5).subscribe(
+                [&](int v){ actual.push_back(v); });
+
+            THEN("5 values are sent"){
+                REQUIRE(rxu::to_vector({0, 1, 2, 3, 4}) == actual);
+            }
+            THEN("the rest of the query is not evaluated"){
+                REQUIRE(5 == *q.reads);
+            }
+        }
+
+        WHEN("the values are sent on a new thread"){
+            auto actual = rx::observable<>::from_query(q, rx::observe_on_new_thread(), 7).
+                reduce(0, [](int s, int v){ return s + v; }).
+                as_blocking().
+                last();
+
+            THEN("every value is sent"){
+                REQUIRE(199 * 200 / 2 == actual);
+            }
+        }
+
+        WHEN("the observable is dropped right after subscribe on a new thread"){
+            std::mutex lock;
+            std::condition_variable wake;
+            int sum = 0;
+            bool completed = false;
+            {
+                auto values = rx::observable<>::from_query(counted_query(200), rx::observe_on_new_thread(), 1);
+                values.subscribe(
+                    [&](int v){ sum += v; },
+                    [&](){
+                        std::unique_lock<std::mutex> guard(lock);
+                        completed = true;
+                        wake.notify_one();
+                    });
+            }
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [&](){ return completed; });
+
+            THEN("every value is read from the copy of the query held by the subscription"){
+                REQUIRE(199 * 200 / 2 == sum);
+            }
+        }
+    }
+}
+
+SCENARIO("from_query sends errors thrown by the query", "[from_query][sources]"){
+    GIVEN("a query that throws on the third value"){
+        throwing_query q;
+
+        WHEN("the values are collected"){
+            std::vector<int> actual;
+            std::string error;
+            rxs::from_query(q).subscribe(
+                [&](int v){ actual.push_back(v); },
+                [&](rxu::error_ptr e){ error = rxu::what(e); });
+
+            THEN("the values before the error are sent"){
+                REQUIRE(rxu::to_vector({0, 1}) == actual);
+            }
+            THEN("the error is sent"){
+                REQUIRE(std::string("query failed") == error);
+            }
+        }
+    }
+}
+
+SCENARIO("to_query iterates the values of an observable", "[to_query][sources]"){
+    GIVEN("a range on a new thread"){
+        auto values = rx::observable<>::range(1, 100).subscribe_on(rx::observe_on_new_thread());
+
+        WHEN("the values are read through iterators"){
+            auto q = values.to_query();
+            std::vector<int> actual(q.begin(), q.end());
+
+            THEN("every value is read in order"){
+                REQUIRE(100u == actual.size());
+                REQUIRE(1 == actual.front());
+                REQUIRE(100 == actual.back());
+            }
+        }
+
+        WHEN("the traversal stops early"){
+            auto q = values.to_query();
+            int first = 0;
+            for (auto v : q) {
+                first = v;
+                break;
+            }
+
+            THEN("the first value was read"){
+                REQUIRE(1 == first);
+            }
+        }
+
+        WHEN("the values are read with postfix increment"){
+            auto q = values.to_query();
+            auto it = q.begin();
+            int first = *it++;
+            int second = *it++;
+
+            THEN("each dereference yields the value before the increment"){
+                REQUIRE(1 == first);
+                REQUIRE(2 == second);
+                REQUIRE(3 == *it);
+            }
+        }
+    }
+
+    GIVEN("an observable that fails after two values"){
+        auto values = rx::observable<>::from(1, 2).concat(rx::observable<>::error<int>(std::runtime_error("source failed")));
+
+        WHEN("the values are read through iterators"){
+            auto q = values.to_query();
+            std::vector<int> actual;
+            std::string error;
+            try {
+                for (auto v : q) {
+                    actual.push_back(v);
+                }
+            } catch (const std::exception& e) {
+                error = e.what();
+            }
+
+            THEN("the values before the error are read"){
+                REQUIRE(rxu::to_vector({1, 2}) == actual);
+            }
+            THEN("the error is rethrown"){
+                REQUIRE(std::string("source failed") == error);
+            }
+        }
+    }
+}
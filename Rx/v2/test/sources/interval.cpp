@@ -1,4 +1,6 @@
 #include "../test.h"
+#include <rxcpp/operators/rx-take.hpp>
+#include <rxcpp/operators/rx-tap.hpp>
 
 SCENARIO("schedule_periodically", "[!hide][periodically][scheduler][long][perf][sources]"){
     GIVEN("schedule_periodically"){
@@ -88,3 +90,168 @@ SCENARIO("intervals", "[!hide][periodically][interval][scheduler][long][perf][so
         }
     }
 }
+
+SCENARIO("interval catch up", "[interval][periodically][sources]"){
+    GIVEN("an interval of 100ms with a slow subscriber"){
+        using namespace std::chrono;
+
+        auto sc = rxsc::make_test();
+        auto so = rx::synchronize_in_one_worker(sc);
+        auto w = sc.create_worker();
+        const rxsc::test::messages<long> on;
+
+        WHEN("missed values are sent back to back"){
+
+            auto res = w.start(
+                [&]() {
+                    return rx::observable<>::interval(sc.now() + milliseconds(100), milliseconds(100), rxsc::periodic_catch_up::burst, so)
+                        // the second value takes 2.5 periods
+                        | rxo::tap([&](long v){ if (v == 2) { w.sleep(250); } })
+                        | rxo::take(6);
+                }
+            );
+
+            THEN("the output is on the original schedule after the slow value"){
+                auto required = rxu::to_vector({
+                    on.next(201, 1),
+                    on.next(550, 2),
+                    on.next(551, 3),
+                    on.next(552, 4),
+                    on.next(600, 5),
+                    on.next(700, 6),
+                    on.completed(700)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+
+        WHEN("missed values are skipped"){
+
+            auto res = w.start(
+                [&]() {
+                    return rx::observable<>::interval(sc.now() + milliseconds(100), milliseconds(100), rxsc::periodic_catch_up::skip, so)
+                        // the second value takes 2.5 periods
+                        | rxo::tap([&](long v){ if (v == 2) { w.sleep(250); } })
+                        | rxo::take(6);
+                }
+            );
+
+            THEN("the output is on the original schedule after the slow value"){
+                auto required = rxu::to_vector({
+                    on.next(201, 1),
+                    on.next(550, 2),
+                    on.next(600, 5),
+                    on.next(700, 6),
+                    on.next(800, 7),
+                    on.next(900, 8),
+                    on.completed(900)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+
+        WHEN("missed values are coalesced"){
+
+            auto res = w.start(
+                [&]() {
+                    return rx::observable<>::interval(sc.now() + milliseconds(100), milliseconds(100), rxsc::periodic_catch_up::coalesce, so)
+                        // the second value takes 2.5 periods
+                        | rxo::tap([&](long v){ if (v == 2) { w.sleep(250); } })
+                        | rxo::take(6);
+                }
+            );
+
+            THEN("the output is on the original schedule after the slow value"){
+                auto required = rxu::to_vector({
+                    on.next(201, 1),
+                    on.next(550, 2),
+                    on.next(551, 4),
+                    on.next(600, 5),
+                    on.next(700, 6),
+                    on.next(800, 7),
+                    on.completed(800)
+                });
+                auto actual = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+    }
+}
+
+SCENARIO("intervals sharing a periodic_timer", "[interval][periodically][sources]"){
+    GIVEN("a periodic_timer of 100ms"){
+        using namespace std::chrono;
+
+        auto sc = rxsc::make_test();
+        auto w = sc.create_worker();
+        rxsc::periodic_timer timer(sc.create_worker(), sc.to_time_point(100), milliseconds(100));
+
+        WHEN("two intervals are subscribed at different times"){
+            std::vector<std::string> actual;
+            std::vector<std::size_t> sizes;
+            rx::composite_subscription a, b;
+            auto record = [&](std::string name){
+                return [&, name](long v){
+                    actual.push_back(name + std::to_string(v) + "@" + std::to_string(sc.clock()));
+                };
+            };
+
+            w.schedule_absolute(150, [&](const rxsc::schedulable&){
+                rx::observable<>::interval(timer).subscribe(a, record("a"));
+            });
+            w.schedule_absolute(350, [&](const rxsc::schedulable&){
+                rx::observable<>::interval(timer).subscribe(b, record("b"));
+                sizes.push_back(timer.size());
+            });
+            w.schedule_absolute(560, [&](const rxsc::schedulable&){
+                a.unsubscribe();
+                sizes.push_back(timer.size());
+            });
+            w.schedule_absolute(760, [&](const rxsc::schedulable&){
+                b.unsubscribe();
+                sizes.push_back(timer.size());
+            });
+            w.schedule_absolute(1000, [&](const rxsc::schedulable&){
+                rx::observable<>::interval(timer).take(2).subscribe(record("c"));
+            });
+            w.start();
+
+            THEN("both share the occurances of the timer and count from 1"){
+                std::vector<std::string> required = {
+                    "a1@200", "a2@300", "a3@400", "b1@400", "a4@500", "b2@500", "b3@600", "b4@700", "c1@1001", "c2@1100"
+                };
+                REQUIRE(required == actual);
+            }
+            THEN("the timer is idle when the intervals are unsubscribed"){
+                std::vector<std::size_t> required = {2, 1, 0};
+                REQUIRE(required == sizes);
+                REQUIRE(0u == timer.size());
+            }
+        }
+
+        WHEN("the last actions are removed between occurances"){
+            auto token = std::make_shared<int>(0);
+            long runs = 0;
+            long uses = 0;
+            rx::composite_subscription ran, added;
+
+            w.schedule_absolute(150, [&](const rxsc::schedulable&){
+                ran = timer.add([token, &runs](long){ ++runs; });
+            });
+            w.schedule_absolute(250, [&](const rxsc::schedulable&){
+                added = timer.add([token](long){});
+                ran.unsubscribe();
+                added.unsubscribe();
+                uses = token.use_count();
+            });
+            w.start();
+
+            THEN("the actions are released without waiting for an occurance"){
+                REQUIRE(1 == runs);
+                REQUIRE(1 == uses);
+            }
+        }
+    }
+}
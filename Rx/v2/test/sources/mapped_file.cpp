@@ -0,0 +1,104 @@
+#include "../test.h"
+#include <rxcpp/sources/rx-mapped_file.hpp>
+#include <rxcpp/operators/rx-take.hpp>
+#include <rxcpp/operators/rx-map.hpp>
+#include <rxcpp/operators/rx-observe_on.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+struct temp_file
+{
+    std::string path;
+    temp_file(std::string p, const std::string& contents) : path(std::move(p)) {
+        std::ofstream out(path.c_str(), std::ios::binary);
+        out << contents;
+    }
+    ~temp_file() {
+        std::remove(path.c_str());
+    }
+};
+
+}
+
+SCENARIO("mapped_file_lines sends each line of the file", "[mapped_file][sources]"){
+    GIVEN("a file with mixed line endings and no trailing newline"){
+        temp_file f("rxcpp_mapped_file_lines.txt", "alpha\r\nbeta\n\ngamma");
+
+        WHEN("the lines are collected"){
+            std::vector<std::string> actual;
+            bool completed = false;
+            rxs::mapped_file_lines(f.path).subscribe(
+                [&](const rxs::mapped_chunk& line){ actual.push_back(line.str()); },
+                [&](){ completed = true; });
+
+            THEN("each line is sent without its terminator"){
+                std::vector<std::string> expected = {"alpha", "beta", "", "gamma"};
+                REQUIRE(expected == actual);
+            }
+            THEN("the observable completes"){
+                REQUIRE(completed);
+            }
+        }
+
+        WHEN("the subscriber unsubscribes after 2 lines"){
+            std::vector<std::string> actual;
+            rxs::mapped_file_lines(f.path).take(2).subscribe(
+                [&](const rxs::mapped_chunk& line){ actual.push_back(line.str()); });
+
+            THEN("2 lines are sent"){
+                std::vector<std::string> expected = {"alpha", "beta"};
+                REQUIRE(expected == actual);
+            }
+        }
+
+        WHEN("the lines are buffered by observe_on"){
+            std::vector<rxs::mapped_chunk> lines;
+            rxs::mapped_file_lines(f.path).
+                observe_on(rx::observe_on_new_thread()).
+                as_blocking().
+                subscribe([&](const rxs::mapped_chunk& line){ lines.push_back(line); });
+
+            THEN("the lines stay valid after the subscription has ended"){
+                REQUIRE(4u == lines.size());
+                REQUIRE(std::string("gamma") == lines.back().str());
+            }
+        }
+    }
+}
+
+SCENARIO("mapped_file_chunks sends chunks that end on a line", "[mapped_file][sources]"){
+    GIVEN("a file of short lines and a long line"){
+        temp_file f("rxcpp_mapped_file_chunks.txt", "ab\ncd\nef\n0123456789\ngh");
+
+        WHEN("the file is sent in chunks of 7 bytes"){
+            std::vector<std::string> actual;
+            rxs::mapped_file_chunks(f.path, 7).subscribe(
+                [&](const rxs::mapped_chunk& c){ actual.push_back(c.str()); });
+
+            THEN("chunks end after the last complete line and long lines are split"){
+                std::vector<std::string> expected = {"ab\ncd\n", "ef\n", "0123456", "789\ngh"};
+                REQUIRE(expected == actual);
+            }
+        }
+    }
+}
+
+SCENARIO("mapped_file_lines sends an error for a missing file", "[mapped_file][sources]"){
+    GIVEN("a path that does not exist"){
+        WHEN("the lines are collected"){
+            int count = 0;
+            bool failed = false;
+            rxs::mapped_file_lines("rxcpp_mapped_file_missing.txt").subscribe(
+                [&](const rxs::mapped_chunk&){ ++count; },
+                [&](rxu::error_ptr){ failed = true; });
+
+            THEN("no line is sent and the error is sent"){
+                REQUIRE(0 == count);
+                REQUIRE(failed);
+            }
+        }
+    }
+}
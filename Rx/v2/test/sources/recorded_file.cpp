@@ -0,0 +1,187 @@
+#include "../test.h"
+#include <rxcpp/sources/rx-recorded_file.hpp>
+#include <rxcpp/operators/rx-take.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+struct temp_path
+{
+    std::string path;
+    explicit temp_path(std::string p) : path(std::move(p)) {
+        std::remove(path.c_str());
+    }
+    ~temp_path() {
+        std::remove(path.c_str());
+    }
+};
+
+}
+
+SCENARIO("record_to writes the values and times of a stream", "[record_to][replay_from][sources]"){
+    GIVEN("a recorded hot observable"){
+        temp_path f("rxcpp_record_to.rxrec");
+        auto sc = rxsc::make_test();
+        auto so = rx::identity_one_worker(sc);
+        auto w = sc.create_worker();
+        const rxsc::test::messages<int> on;
+
+        auto xs = sc.make_hot_observable({
+            on.next(150, 1),
+            on.next(210, 2),
+            on.next(250, 3),
+            on.next(250, 4),
+            on.completed(300)
+        });
+
+        auto res = w.start(
+            [&]() {
+                return xs | rxo::record_to(f.path, so);
+            }
+        );
+
+        THEN("the values are passed through"){
+            auto required = rxu::to_vector({
+                on.next(210, 2),
+                on.next(250, 3),
+                on.next(250, 4),
+                on.completed(300)
+            });
+            auto actual = res.get_observer().messages();
+            REQUIRE(required == actual);
+        }
+
+        WHEN("the file is read"){
+            auto actual = rxs::read_recorded_file<int>(f.path);
+
+            THEN("the file has the microseconds since the subscription"){
+                auto required = rxu::to_vector({
+                    on.next(10000, 2),
+                    on.next(50000, 3),
+                    on.next(50000, 4),
+                    on.completed(100000)
+                });
+                REQUIRE(required == actual);
+            }
+        }
+
+        WHEN("the file is read in the ticks of the test scheduler"){
+            auto actual = rxs::read_recorded_file<int>(f.path, std::chrono::milliseconds(1), rxsc::test::subscribed_time);
+
+            THEN("the times match the messages of the subscription"){
+                auto required = res.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+
+        WHEN("replayed as fast as possible"){
+            std::vector<int> values;
+            bool completed = false;
+            rxs::replay_from<int>(f.path).subscribe(
+                [&](int v){ values.push_back(v); },
+                [&](){ completed = true; });
+
+            THEN("the values are sent and the observable completes"){
+                REQUIRE(std::vector<int>({2, 3, 4}) == values);
+                REQUIRE(completed);
+            }
+        }
+
+        WHEN("replayed twice as fast on a test scheduler"){
+            auto replay_sc = rxsc::make_test();
+            auto replay_so = rx::identity_one_worker(replay_sc);
+            auto replay = replay_sc.create_worker().start(
+                [&]() {
+                    return rxs::replay_from<int>(f.path, 2.0, replay_so);
+                }
+            );
+
+            THEN("the times are scaled"){
+                auto required = rxu::to_vector({
+                    on.next(205, 2),
+                    on.next(225, 3),
+                    on.next(225, 4),
+                    on.completed(250)
+                });
+                auto actual = replay.get_observer().messages();
+                REQUIRE(required == actual);
+            }
+        }
+
+        WHEN("the subscriber unsubscribes after 2 values"){
+            std::vector<int> values;
+            rxs::replay_from<int>(f.path).take(2).subscribe(
+                [&](int v){ values.push_back(v); });
+
+            THEN("2 values are sent"){
+                REQUIRE(std::vector<int>({2, 3}) == values);
+            }
+        }
+    }
+}
+
+SCENARIO("record_to writes strings and errors", "[record_to][replay_from][sources]"){
+    GIVEN("a subject of strings that fails"){
+        temp_path f("rxcpp_record_to_error.rxrec");
+        rxsub::subject<std::string> sub;
+        sub.get_observable().op(rxo::record_to(f.path)).subscribe([](const std::string&){}, [](rxu::error_ptr){});
+        sub.get_subscriber().on_next(std::string("alpha"));
+        sub.get_subscriber().on_next(std::string());
+        sub.get_subscriber().on_error(rxu::make_error_ptr(std::runtime_error("boom")));
+
+        WHEN("replayed"){
+            std::vector<std::string> values;
+            std::string error;
+            rxs::replay_from<std::string>(f.path).subscribe(
+                [&](const std::string& v){ values.push_back(v); },
+                [&](rxu::error_ptr e){ error = rxu::what(e); });
+
+            THEN("the strings and the message of the error are sent"){
+                REQUIRE(std::vector<std::string>({"alpha", ""}) == values);
+                REQUIRE(std::string("boom") == error);
+            }
+        }
+    }
+}
+
+SCENARIO("replay_from sends an error for a bad file", "[replay_from][sources]"){
+    GIVEN("a missing file and a truncated file"){
+        temp_path missing("rxcpp_replay_from_missing.rxrec");
+        temp_path truncated("rxcpp_replay_from_truncated.rxrec");
+        rx::observable<>::range(1, 3).op(rxo::record_to(truncated.path)).subscribe();
+        {
+            std::ifstream in(truncated.path.c_str(), std::ios::binary);
+            std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            in.close();
+            std::ofstream out(truncated.path.c_str(), std::ios::binary | std::ios::trunc);
+            // remove the completed record and the last byte of the last value
+            out << contents.substr(0, contents.size() - 3);
+        }
+
+        WHEN("the missing file is replayed"){
+            bool failed = false;
+            rxs::replay_from<int>(missing.path).subscribe(
+                [](int){},
+                [&](rxu::error_ptr){ failed = true; });
+
+            THEN("the error is sent"){
+                REQUIRE(failed);
+            }
+        }
+
+        WHEN("the truncated file is replayed"){
+            std::vector<int> values;
+            bool failed = false;
+            rxs::replay_from<int>(truncated.path).subscribe(
+                [&](int v){ values.push_back(v); },
+                [&](rxu::error_ptr){ failed = true; });
+
+            THEN("the complete values and the error are sent"){
+                REQUIRE(std::vector<int>({1, 2}) == values);
+                REQUIRE(failed);
+            }
+        }
+    }
+}
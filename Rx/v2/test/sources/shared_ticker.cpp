@@ -0,0 +1,91 @@
+#include "../test.h"
+#include <rxcpp/operators/rx-take.hpp>
+#include <rxcpp/operators/rx-observe_on.hpp>
+
+SCENARIO("shared_ticker shares one timer", "[shared_ticker][periodically][sources]"){
+    GIVEN("tickers of 100ms on a test scheduler"){
+        using namespace std::chrono;
+
+        auto sc = rxsc::make_test();
+        auto so = rx::synchronize_in_one_worker(sc);
+        auto w = sc.create_worker();
+
+        std::vector<std::string> actual;
+        auto record = [&](std::string name){
+            return [&, name](long v){
+                actual.push_back(name + std::to_string(v) + "@" + std::to_string(sc.clock()));
+            };
+        };
+
+        WHEN("two tickers with the same period are subscribed at different times"){
+            auto a = rx::observable<>::shared_ticker(milliseconds(100), so);
+            auto b = rx::observable<>::shared_ticker(milliseconds(100), so);
+            auto c = rx::observable<>::shared_ticker(milliseconds(150), so);
+
+            w.schedule_absolute(150, [&](const rxsc::schedulable&){
+                a.take(3).subscribe(record("a"));
+            });
+            w.schedule_absolute(300, [&](const rxsc::schedulable&){
+                b.take(2).subscribe(record("b"));
+            });
+            w.schedule_absolute(320, [&](const rxsc::schedulable&){
+                c.take(1).subscribe(record("c"));
+            });
+            w.start();
+
+            THEN("the timer starts with the first subscriber and a later subscriber joins its numbering"){
+                std::vector<std::string> required = {
+                    "a1@250", "a2@350", "b2@350", "a3@450", "b3@450", "c1@470"
+                };
+                REQUIRE(required == actual);
+            }
+        }
+
+        WHEN("the ticks are observed on a worker of each subscription"){
+            auto oo = rx::observe_on_one_worker(sc);
+            auto a = rx::observable<>::shared_ticker(milliseconds(100), oo);
+            auto b = rx::observable<>::shared_ticker(milliseconds(100), oo);
+
+            w.schedule_absolute(150, [&](const rxsc::schedulable&){
+                a.take(2).subscribe(record("a"));
+            });
+            w.schedule_absolute(300, [&](const rxsc::schedulable&){
+                b.take(1).subscribe(record("b"));
+            });
+            w.start();
+
+            THEN("each subscriber receives the shared ticks through its coordinator"){
+                std::vector<std::string> required = {
+                    "a1@250", "a2@350", "b2@350"
+                };
+                REQUIRE(required == actual);
+            }
+        }
+
+        WHEN("every subscriber unsubscribes"){
+            auto a = rx::observable<>::shared_ticker(milliseconds(100), so);
+
+            rx::composite_subscription first, second;
+            w.schedule_absolute(150, [&](const rxsc::schedulable&){
+                a.subscribe(first, record("a"));
+                a.subscribe(second, record("b"));
+            });
+            w.schedule_absolute(300, [&](const rxsc::schedulable&){
+                first.unsubscribe();
+                second.unsubscribe();
+            });
+            w.schedule_absolute(1000, [&](const rxsc::schedulable&){
+                a.take(1).subscribe(record("c"));
+            });
+            // returns only once the timer has stopped
+            w.start();
+
+            THEN("the timer stops and the next subscriber starts a new one"){
+                std::vector<std::string> required = {
+                    "a1@250", "b1@250", "c1@1100"
+                };
+                REQUIRE(required == actual);
+            }
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include "../test.h"
+#include "rxcpp/operators/rx-buffer_count.hpp"
+#include "rxcpp/operators/rx-framing.hpp"
+#include "rxcpp/operators/rx-replay.hpp"
+#include "rxcpp/operators/rx-ref_count.hpp"
+
+SCENARIO("byte_slice slices share storage", "[byte_slice][subjects]"){
+    GIVEN("a byte_slice that owns a string"){
+        rx::byte_slice bytes(std::string("hello world"));
+
+        WHEN("sliced"){
+            auto world = bytes.slice(6);
+            auto ell = bytes.slice(1, 3);
+            auto past = bytes.slice(8, 100);
+
+            THEN("the contents are the string"){
+                REQUIRE(bytes.to_string() == "hello world");
+            }
+            THEN("the slices refer to the bytes of the original"){
+                REQUIRE(world.to_string() == "world");
+                REQUIRE(world.data() == bytes.data() + 6);
+                REQUIRE(ell.to_string() == "ell");
+                REQUIRE(ell.data() == bytes.data() + 1);
+            }
+            THEN("the count is clamped to the end"){
+                REQUIRE(past.to_string() == "rld");
+            }
+            THEN("a copy shares the bytes"){
+                auto copy = world;
+                REQUIRE(copy.shares(world));
+                REQUIRE(copy == rx::byte_slice(std::string("world")));
+                REQUIRE_FALSE(copy.shares(rx::byte_slice(std::string("world"))));
+            }
+            THEN("an offset past the end throws"){
+                REQUIRE_THROWS_AS(bytes.slice(12), std::out_of_range);
+            }
+        }
+    }
+}
+
+SCENARIO("byte_slice adopts storage", "[byte_slice][subjects]"){
+    GIVEN("a vector of bytes"){
+        std::vector<uint8_t> v(64, 1);
+        auto original = v.data();
+
+        WHEN("moved into a byte_slice"){
+            rx::byte_slice bytes(std::move(v));
+
+            THEN("the bytes were not copied"){
+                REQUIRE(bytes.data() == original);
+                REQUIRE(bytes.size() == 64);
+            }
+        }
+    }
+}
+
+SCENARIO("byte_slice fan out", "[byte_slice][subjects]"){
+    GIVEN("a large payload"){
+        rx::byte_slice payload(std::vector<uint8_t>(1 << 20, 7));
+
+        WHEN("sent through a subject to many subscribers"){
+            rxsub::subject<rx::byte_slice> sub;
+            std::vector<rx::byte_slice> received;
+            for (int i = 0; i < 8; ++i) {
+                sub.get_observable().subscribe([&](rx::byte_slice b){
+                    received.push_back(b);
+                });
+            }
+            sub.get_subscriber().on_next(payload);
+
+            THEN("every subscriber received the same storage"){
+                REQUIRE(8 == received.size());
+                for (auto& b : received) {
+                    REQUIRE(b.shares(payload));
+                }
+            }
+        }
+
+        WHEN("replayed and buffered"){
+            std::vector<rx::byte_slice> received;
+            auto replayed = rx::observable<>::just(payload).replay();
+            replayed.connect();
+            replayed
+                .buffer(1)
+                .subscribe([&](std::vector<rx::byte_slice> v){
+                    received.insert(received.end(), v.begin(), v.end());
+                });
+
+            THEN("the subscriber received the same storage"){
+                REQUIRE(1 == received.size());
+                REQUIRE(received.front().shares(payload));
+            }
+        }
+    }
+}
+
+SCENARIO("byte_slice frames", "[byte_slice][split_lines][framing][operators]"){
+    GIVEN("chunks of byte_slice"){
+        std::vector<rx::byte_slice> chunks;
+        chunks.push_back(rx::byte_slice(std::string("first\nsec")));
+        chunks.push_back(rx::byte_slice(std::string("ond\nthird\n")));
+
+        WHEN("split into lines"){
+            std::vector<rx::byte_slice> lines;
+            rx::observable<>::iterate(chunks)
+                .split_lines()
+                .subscribe([&](rx::byte_slice line){
+                    lines.push_back(line);
+                });
+
+            THEN("the lines are correct"){
+                REQUIRE(3 == lines.size());
+                REQUIRE(lines[0].to_string() == "first");
+                REQUIRE(lines[1].to_string() == "second");
+                REQUIRE(lines[2].to_string() == "third");
+            }
+            THEN("lines inside one chunk share the storage of the chunk"){
+                REQUIRE(lines[0].data() == chunks[0].data());
+                REQUIRE(lines[2].data() == chunks[1].data() + 4);
+            }
+        }
+    }
+}